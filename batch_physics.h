@@ -0,0 +1,1082 @@
+#ifndef BATCH_PHYSICS_H
+#define BATCH_PHYSICS_H
+
+// Motor de física por lotes: el estado de N partidas en estructura de arrays (SoA).
+// Cada tick reproduce exactamente Match::step() con COLLISION_DISCRETE (paletas manuales o IA, movimiento de
+// la pelota, rebote en paredes, intersección con las paletas, efecto según el punto de
+// impacto y puntuación), pero para 4 u 8 partidas a la vez con SSE2/AVX2.
+//
+// El kernel escalar y los vectoriales hacen las mismas operaciones IEEE en el mismo orden
+// (sin FMA ni recíprocos aproximados), así que los tres dan resultados idénticos bit a bit
+// a los de Match::step().
+//
+// El kernel escalar es una plantilla sobre el tipo numérico: con Fixed16 (FixedBatchPhysics)
+// la misma física va en coma fija y da los mismos bits con cualquier compilador y opciones,
+// lo que comprueba --check-determinism junto con partidas completas de BasicMatch<Fixed16>
+// (todos los modos de colisión e IA) y una repetición grabada y reproducida desde archivo.
+
+#include "pong_core.h"
+#include "fixed_point.h"
+#include "headless.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCH_PHYSICS_X86 1
+#endif
+
+// Bits de entrada por paleta
+enum BatchInputBits {
+    BATCH_INPUT_UP = 1,
+    BATCH_INPUT_DOWN = 2
+};
+
+enum BatchKernel {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+};
+
+inline const char* batchKernelName(BatchKernel kernel) {
+    switch (kernel) {
+        case KERNEL_SCALAR: return "escalar";
+        case KERNEL_SSE2: return "SSE2";
+        case KERNEL_AVX2: return "AVX2";
+    }
+    return "?";
+}
+
+// Estado de N partidas y kernel escalar, con el tipo numérico como parámetro de plantilla:
+// float reproduce Match::step() bit a bit (y es la base de los kernels SIMD de BatchPhysics);
+// Fixed16 hace la misma física en coma fija 16.16, con los mismos bits en cualquier
+// compilación y CPU. Las constantes pasan por Real(...), que para float no cambia nada.
+template <typename Real>
+class BasicBatchPhysics {
+public:
+    // Estado por partida (los carriles de relleno simulan partidas que nadie lee)
+    std::vector<Real> ballX, ballY, ballVX, ballVY;
+    std::vector<Real> paddle1Y, paddle2Y;
+    std::vector<int32_t> input1, input2;        // BatchInputBits
+    std::vector<int32_t> ai1, ai2;              // 1 = paleta controlada por la IA
+    std::vector<Real> ai1Speed, ai1DeadZone;    // Velocidad de la IA: velocidad de la paleta * dificultad
+    std::vector<Real> ai2Speed, ai2DeadZone;
+    std::vector<int32_t> score1, score2;
+
+    // El tamaño se redondea a un múltiplo de lanes
+    explicit BasicBatchPhysics(size_t matches, size_t lanes = 1)
+        : count(matches), padded((matches + lanes - 1) / lanes * lanes) {
+        ballX.resize(padded); ballY.resize(padded); ballVX.resize(padded); ballVY.resize(padded);
+        paddle1Y.resize(padded); paddle2Y.resize(padded);
+        input1.assign(padded, 0); input2.assign(padded, 0);
+        ai1.assign(padded, 0); ai2.assign(padded, 1);
+        AIParams defaults;
+        ai1Speed.assign(padded, Real(PADDLE_SPEED * defaults.difficulty)); ai1DeadZone.assign(padded, Real(defaults.deadZone));
+        ai2Speed.assign(padded, Real(PADDLE_SPEED * defaults.difficulty)); ai2DeadZone.assign(padded, Real(defaults.deadZone));
+        score1.assign(padded, 0); score2.assign(padded, 0);
+        FloatMatch initial;
+        for (size_t i = 0; i < padded; i++) {
+            loadMatch(i, initial);
+        }
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Copia una partida al lote (la x de las paletas es fija y no se guarda)
+    void loadMatch(size_t i, const FloatMatch& match) {
+        ballX[i] = Real(match.ball.x);
+        ballY[i] = Real(match.ball.y);
+        ballVX[i] = Real(match.ball.velocityX);
+        ballVY[i] = Real(match.ball.velocityY);
+        paddle1Y[i] = Real(match.player1.y);
+        paddle2Y[i] = Real(match.player2.y);
+        ai1[i] = match.player1.isAI ? 1 : 0;
+        ai2[i] = match.player2.isAI ? 1 : 0;
+        ai1Speed[i] = Real(match.player1.speed * match.player1.ai.difficulty);
+        ai1DeadZone[i] = Real(match.player1.ai.deadZone);
+        ai2Speed[i] = Real(match.player2.speed * match.player2.ai.difficulty);
+        ai2DeadZone[i] = Real(match.player2.ai.deadZone);
+        score1[i] = match.score1;
+        score2[i] = match.score2;
+    }
+
+    // Un tick con el kernel escalar
+    void stepScalar(Real deltaTime) {
+        runScalar(deltaTime, 1);
+    }
+
+    // ticks pasos seguidos con el mismo deltaTime. El paso de la IA de cada partida
+    // (velocidad * deltaTime) se calcula una vez para todos, y da los mismos bits que
+    // calcularlo en cada tick
+    void runScalar(Real deltaTime, long ticks) {
+        prepareAISteps(deltaTime);
+        for (long t = 0; t < ticks; t++) {
+            stepScalarPrepared(deltaTime);
+        }
+    }
+
+    // Huella del estado de las partidas reales (FNV-1a sobre los bits de cada valor)
+    uint64_t fingerprint() const {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t values[] = {
+                realBits(ballX[i]), realBits(ballY[i]), realBits(ballVX[i]), realBits(ballVY[i]),
+                realBits(paddle1Y[i]), realBits(paddle2Y[i]), (uint32_t)score1[i], (uint32_t)score2[i]
+            };
+            for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+                for (int byte = 0; byte < 4; byte++) {
+                    hash ^= (values[v] >> (byte * 8)) & 0xFF;
+                    hash *= 1099511628211ull;
+                }
+            }
+        }
+        return hash;
+    }
+
+protected:
+    static constexpr float PADDLE1_X = GAME_MARGIN_SIDES + 20;
+    static constexpr float PADDLE2_X = WINDOW_WIDTH - GAME_MARGIN_SIDES - 20 - PADDLE_WIDTH;
+    static constexpr float RESET_X = WINDOW_WIDTH / 2;
+    static constexpr float RESET_Y = GAME_MARGIN_TOP + GAME_HEIGHT / 2;
+
+    size_t count;
+    size_t padded;
+    std::vector<Real> ai1Step, ai2Step;  // aiSpeed * deltaTime, de prepareAISteps()
+
+    void prepareAISteps(Real deltaTime) {
+        ai1Step.resize(padded);
+        ai2Step.resize(padded);
+        for (size_t i = 0; i < padded; i++) {
+            ai1Step[i] = ai1Speed[i] * deltaTime;
+            ai2Step[i] = ai2Speed[i] * deltaTime;
+        }
+    }
+
+    // Un tick con los pasos de la IA ya preparados para este deltaTime
+    void stepScalarPrepared(Real deltaTime) {
+        for (size_t i = 0; i < padded; i++) {
+            Real bx = ballX[i], by = ballY[i], vx = ballVX[i], vy = ballVY[i];
+            Real ballCenterY = by + Real(BALL_SIZE / 2);
+            paddle1Y[i] = stepPaddle(paddle1Y[i], deltaTime, input1[i], ai1[i] != 0, vx < Real(0),
+                                     ai1Step[i], ai1DeadZone[i], ballCenterY);
+            paddle2Y[i] = stepPaddle(paddle2Y[i], deltaTime, input2[i], ai2[i] != 0, vx > Real(0),
+                                     ai2Step[i], ai2DeadZone[i], ballCenterY);
+
+            // Movimiento y rebote en paredes
+            bx += vx * deltaTime;
+            by += vy * deltaTime;
+            if (by <= Real(GAME_MARGIN_TOP) || by >= Real(GAME_MARGIN_TOP + GAME_HEIGHT - BALL_SIZE)) {
+                vy = -vy;
+            }
+
+            // Intersección de rectángulos enteros como SDL_HasIntersection, y efecto
+            collidePaddle(bx, by, vx, vy, Real(PADDLE1_X), paddle1Y[i]);
+            collidePaddle(bx, by, vx, vy, Real(PADDLE2_X), paddle2Y[i]);
+
+            if (bx < Real(GAME_MARGIN_SIDES)) {
+                score2[i]++;
+                resetBall(bx, by, vx, vy);
+            } else if (bx > Real(WINDOW_WIDTH - GAME_MARGIN_SIDES)) {
+                score1[i]++;
+                resetBall(bx, by, vx, vy);
+            }
+            ballX[i] = bx; ballY[i] = by; ballVX[i] = vx; ballVY[i] = vy;
+        }
+    }
+
+private:
+    static Real stepPaddle(Real y, Real deltaTime, int32_t input, bool isAI, bool approaching,
+                           Real aiStep, Real deadZone, Real ballCenterY) {
+        const Real top = Real(GAME_MARGIN_TOP);
+        const Real maxY = Real(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT);
+        if (!isAI) {
+            Real step = Real(PADDLE_SPEED) * deltaTime;
+            if ((input & BATCH_INPUT_UP) && y > top) y -= step;
+            if ((input & BATCH_INPUT_DOWN) && y < maxY) y += step;
+            return y;
+        }
+        if (!approaching) return y;
+        Real center = y + Real(PADDLE_HEIGHT / 2);
+        if (center < ballCenterY - deadZone) {
+            if (y < maxY) y += aiStep;
+        } else if (center > ballCenterY + deadZone) {
+            if (y > top) y -= aiStep;
+        }
+        return y;
+    }
+
+    static void collidePaddle(Real bx, Real by, Real& vx, Real& vy, Real px, Real py) {
+        int ix = (int)bx, iy = (int)by, ipx = (int)px, ipy = (int)py;
+        if (ix < ipx + PADDLE_WIDTH && ipx < ix + BALL_SIZE && iy < ipy + PADDLE_HEIGHT && ipy < iy + BALL_SIZE) {
+            vx = -vx;
+            Real hitPos = ((by + Real(BALL_SIZE / 2)) - (py + Real(PADDLE_HEIGHT / 2))) / Real(PADDLE_HEIGHT / 2);
+            vy = hitPos * Real(BALL_SPEED);
+        }
+    }
+
+    static void resetBall(Real& bx, Real& by, Real& vx, Real& vy) {
+        bx = Real(RESET_X);
+        by = Real(RESET_Y);
+        vx = (vx > Real(0)) ? -Real(BALL_SPEED) : Real(BALL_SPEED);
+        vy = Real(BALL_SPEED);
+    }
+};
+
+template <typename Real> constexpr float BasicBatchPhysics<Real>::PADDLE1_X;
+template <typename Real> constexpr float BasicBatchPhysics<Real>::PADDLE2_X;
+template <typename Real> constexpr float BasicBatchPhysics<Real>::RESET_X;
+template <typename Real> constexpr float BasicBatchPhysics<Real>::RESET_Y;
+
+
+// Lote en float con kernels SSE2/AVX2 además del escalar
+class BatchPhysics : public BasicBatchPhysics<float> {
+public:
+    static const size_t LANES = 8; // El tamaño se redondea al ancho del kernel más ancho
+
+    explicit BatchPhysics(size_t matches) : BasicBatchPhysics<float>(matches, LANES) {}
+
+    void storeMatch(size_t i, FloatMatch& match) const {
+        match.ball.x = ballX[i];
+        match.ball.y = ballY[i];
+        match.ball.velocityX = ballVX[i];
+        match.ball.velocityY = ballVY[i];
+        match.player1.y = paddle1Y[i];
+        match.player2.y = paddle2Y[i];
+        match.score1 = score1[i];
+        match.score2 = score2[i];
+    }
+
+    static BatchKernel bestKernel() {
+#ifdef BATCH_PHYSICS_X86
+        if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+        return KERNEL_SSE2;
+#else
+        return KERNEL_SCALAR;
+#endif
+    }
+
+    void step(float deltaTime, BatchKernel kernel) {
+        switch (kernel) {
+#ifdef BATCH_PHYSICS_X86
+            case KERNEL_AVX2: stepAVX2(deltaTime); return;
+            case KERNEL_SSE2: stepSSE2(deltaTime); return;
+#endif
+            default: stepScalar(deltaTime); return;
+        }
+    }
+
+    // ticks pasos seguidos con el mismo kernel
+    void run(float deltaTime, BatchKernel kernel, long ticks) {
+        if (kernel == KERNEL_SCALAR) {
+            runScalar(deltaTime, ticks);
+            return;
+        }
+        for (long t = 0; t < ticks; t++) {
+            step(deltaTime, kernel);
+        }
+    }
+
+#ifdef BATCH_PHYSICS_X86
+    void stepSSE2(float deltaTime) {
+        const __m128 dt = _mm_set1_ps(deltaTime);
+        const __m128 top = _mm_set1_ps((float)GAME_MARGIN_TOP);
+        const __m128 paddleMaxY = _mm_set1_ps((float)(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT));
+        const __m128 ballMaxY = _mm_set1_ps((float)(GAME_MARGIN_TOP + GAME_HEIGHT - BALL_SIZE));
+        const __m128 speed = _mm_set1_ps(PADDLE_SPEED);
+        const __m128 moveStep = _mm_mul_ps(speed, dt);
+        const __m128 halfBall = _mm_set1_ps((float)(BALL_SIZE / 2));
+        const __m128 halfPaddle = _mm_set1_ps((float)(PADDLE_HEIGHT / 2));
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i upBit = _mm_set1_epi32(BATCH_INPUT_UP);
+        const __m128i downBit = _mm_set1_epi32(BATCH_INPUT_DOWN);
+
+        for (size_t i = 0; i < padded; i += 4) {
+            __m128 bx = _mm_loadu_ps(&ballX[i]);
+            __m128 by = _mm_loadu_ps(&ballY[i]);
+            __m128 vx = _mm_loadu_ps(&ballVX[i]);
+            __m128 vy = _mm_loadu_ps(&ballVY[i]);
+            __m128 ballCenterY = _mm_add_ps(by, halfBall);
+
+            __m128 p[2];
+            for (int side = 0; side < 2; side++) {
+                __m128 y = _mm_loadu_ps(side == 0 ? &paddle1Y[i] : &paddle2Y[i]);
+                __m128i input = _mm_loadu_si128((const __m128i*)(side == 0 ? &input1[i] : &input2[i]));
+                __m128 isAI = _mm_castsi128_ps(_mm_cmpeq_epi32(
+                    _mm_loadu_si128((const __m128i*)(side == 0 ? &ai1[i] : &ai2[i])), one));
+                __m128 aiSpeed = _mm_loadu_ps(side == 0 ? &ai1Speed[i] : &ai2Speed[i]);
+                __m128 deadZone = _mm_loadu_ps(side == 0 ? &ai1DeadZone[i] : &ai2DeadZone[i]);
+
+                // Control manual: subir y luego bajar, cada uno con su límite
+                __m128 up = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(input, upBit), upBit));
+                __m128 down = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(input, downBit), downBit));
+                __m128 manual = select(_mm_and_ps(up, _mm_cmpgt_ps(y, top)), _mm_sub_ps(y, moveStep), y);
+                manual = select(_mm_and_ps(down, _mm_cmplt_ps(manual, paddleMaxY)), _mm_add_ps(manual, moveStep), manual);
+
+                // IA
+                __m128 approaching = side == 0 ? _mm_cmplt_ps(vx, zero) : _mm_cmpgt_ps(vx, zero);
+                __m128 aiStep = _mm_mul_ps(aiSpeed, dt);
+                __m128 center = _mm_add_ps(y, halfPaddle);
+                __m128 wantDown = _mm_cmplt_ps(center, _mm_sub_ps(ballCenterY, deadZone));
+                __m128 wantUp = _mm_andnot_ps(wantDown, _mm_cmpgt_ps(center, _mm_add_ps(ballCenterY, deadZone)));
+                __m128 aiY = select(_mm_and_ps(wantDown, _mm_cmplt_ps(y, paddleMaxY)), _mm_add_ps(y, aiStep), y);
+                aiY = select(_mm_and_ps(wantUp, _mm_cmpgt_ps(y, top)), _mm_sub_ps(y, aiStep), aiY);
+                aiY = select(approaching, aiY, y);
+
+                p[side] = select(isAI, aiY, manual);
+            }
+            _mm_storeu_ps(&paddle1Y[i], p[0]);
+            _mm_storeu_ps(&paddle2Y[i], p[1]);
+
+            // Movimiento y rebote en paredes
+            bx = _mm_add_ps(bx, _mm_mul_ps(vx, dt));
+            by = _mm_add_ps(by, _mm_mul_ps(vy, dt));
+            __m128 wall = _mm_or_ps(_mm_cmple_ps(by, top), _mm_cmpge_ps(by, ballMaxY));
+            vy = _mm_xor_ps(vy, _mm_and_ps(wall, signBit));
+
+            // Colisiones con las paletas (rectángulos enteros truncados como en getRect())
+            for (int side = 0; side < 2; side++) {
+                __m128i ix = _mm_cvttps_epi32(bx);
+                __m128i iy = _mm_cvttps_epi32(by);
+                __m128i px = _mm_set1_epi32(side == 0 ? (int)PADDLE1_X : (int)PADDLE2_X);
+                __m128i py = _mm_cvttps_epi32(p[side]);
+                __m128i overlap = _mm_and_si128(
+                    _mm_and_si128(_mm_cmplt_epi32(ix, _mm_add_epi32(px, _mm_set1_epi32(PADDLE_WIDTH))),
+                                  _mm_cmplt_epi32(px, _mm_add_epi32(ix, _mm_set1_epi32(BALL_SIZE)))),
+                    _mm_and_si128(_mm_cmplt_epi32(iy, _mm_add_epi32(py, _mm_set1_epi32(PADDLE_HEIGHT))),
+                                  _mm_cmplt_epi32(py, _mm_add_epi32(iy, _mm_set1_epi32(BALL_SIZE)))));
+                __m128 hit = _mm_castsi128_ps(overlap);
+                __m128 hitPos = _mm_div_ps(_mm_sub_ps(_mm_add_ps(by, halfBall), _mm_add_ps(p[side], halfPaddle)), halfPaddle);
+                vx = _mm_xor_ps(vx, _mm_and_ps(hit, signBit));
+                vy = select(hit, _mm_mul_ps(hitPos, _mm_set1_ps(BALL_SPEED)), vy);
+            }
+
+            // Puntuación y saque
+            __m128 left = _mm_cmplt_ps(bx, _mm_set1_ps((float)GAME_MARGIN_SIDES));
+            __m128 right = _mm_andnot_ps(left, _mm_cmpgt_ps(bx, _mm_set1_ps((float)(WINDOW_WIDTH - GAME_MARGIN_SIDES))));
+            __m128 scored = _mm_or_ps(left, right);
+            __m128i s1 = _mm_loadu_si128((const __m128i*)&score1[i]);
+            __m128i s2 = _mm_loadu_si128((const __m128i*)&score2[i]);
+            _mm_storeu_si128((__m128i*)&score1[i], _mm_sub_epi32(s1, _mm_castps_si128(right)));
+            _mm_storeu_si128((__m128i*)&score2[i], _mm_sub_epi32(s2, _mm_castps_si128(left)));
+            __m128 serveVX = select(_mm_cmpgt_ps(vx, zero), _mm_set1_ps(-BALL_SPEED), _mm_set1_ps(BALL_SPEED));
+            bx = select(scored, _mm_set1_ps(RESET_X), bx);
+            by = select(scored, _mm_set1_ps(RESET_Y), by);
+            vx = select(scored, serveVX, vx);
+            vy = select(scored, _mm_set1_ps(BALL_SPEED), vy);
+
+            _mm_storeu_ps(&ballX[i], bx);
+            _mm_storeu_ps(&ballY[i], by);
+            _mm_storeu_ps(&ballVX[i], vx);
+            _mm_storeu_ps(&ballVY[i], vy);
+        }
+    }
+
+    // Mismo kernel con registros de 8 carriles; se compila para AVX2 aunque el resto del
+    // programa no, y solo se llama si la CPU lo soporta
+    __attribute__((target("avx2")))
+    void stepAVX2(float deltaTime) {
+        const __m256 dt = _mm256_set1_ps(deltaTime);
+        const __m256 top = _mm256_set1_ps((float)GAME_MARGIN_TOP);
+        const __m256 paddleMaxY = _mm256_set1_ps((float)(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT));
+        const __m256 ballMaxY = _mm256_set1_ps((float)(GAME_MARGIN_TOP + GAME_HEIGHT - BALL_SIZE));
+        const __m256 speed = _mm256_set1_ps(PADDLE_SPEED);
+        const __m256 moveStep = _mm256_mul_ps(speed, dt);
+        const __m256 halfBall = _mm256_set1_ps((float)(BALL_SIZE / 2));
+        const __m256 halfPaddle = _mm256_set1_ps((float)(PADDLE_HEIGHT / 2));
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i upBit = _mm256_set1_epi32(BATCH_INPUT_UP);
+        const __m256i downBit = _mm256_set1_epi32(BATCH_INPUT_DOWN);
+
+        for (size_t i = 0; i < padded; i += 8) {
+            __m256 bx = _mm256_loadu_ps(&ballX[i]);
+            __m256 by = _mm256_loadu_ps(&ballY[i]);
+            __m256 vx = _mm256_loadu_ps(&ballVX[i]);
+            __m256 vy = _mm256_loadu_ps(&ballVY[i]);
+            __m256 ballCenterY = _mm256_add_ps(by, halfBall);
+
+            __m256 p[2];
+            for (int side = 0; side < 2; side++) {
+                __m256 y = _mm256_loadu_ps(side == 0 ? &paddle1Y[i] : &paddle2Y[i]);
+                __m256i input = _mm256_loadu_si256((const __m256i*)(side == 0 ? &input1[i] : &input2[i]));
+                __m256 isAI = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+                    _mm256_loadu_si256((const __m256i*)(side == 0 ? &ai1[i] : &ai2[i])), one));
+                __m256 aiSpeed = _mm256_loadu_ps(side == 0 ? &ai1Speed[i] : &ai2Speed[i]);
+                __m256 deadZone = _mm256_loadu_ps(side == 0 ? &ai1DeadZone[i] : &ai2DeadZone[i]);
+
+                __m256 up = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(input, upBit), upBit));
+                __m256 down = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(input, downBit), downBit));
+                __m256 manual = _mm256_blendv_ps(y, _mm256_sub_ps(y, moveStep),
+                                                 _mm256_and_ps(up, _mm256_cmp_ps(y, top, _CMP_GT_OQ)));
+                manual = _mm256_blendv_ps(manual, _mm256_add_ps(manual, moveStep),
+                                          _mm256_and_ps(down, _mm256_cmp_ps(manual, paddleMaxY, _CMP_LT_OQ)));
+
+                __m256 approaching = side == 0 ? _mm256_cmp_ps(vx, zero, _CMP_LT_OQ) : _mm256_cmp_ps(vx, zero, _CMP_GT_OQ);
+                __m256 aiStep = _mm256_mul_ps(aiSpeed, dt);
+                __m256 center = _mm256_add_ps(y, halfPaddle);
+                __m256 wantDown = _mm256_cmp_ps(center, _mm256_sub_ps(ballCenterY, deadZone), _CMP_LT_OQ);
+                __m256 wantUp = _mm256_andnot_ps(wantDown, _mm256_cmp_ps(center, _mm256_add_ps(ballCenterY, deadZone), _CMP_GT_OQ));
+                __m256 aiY = _mm256_blendv_ps(y, _mm256_add_ps(y, aiStep),
+                                              _mm256_and_ps(wantDown, _mm256_cmp_ps(y, paddleMaxY, _CMP_LT_OQ)));
+                aiY = _mm256_blendv_ps(aiY, _mm256_sub_ps(y, aiStep),
+                                       _mm256_and_ps(wantUp, _mm256_cmp_ps(y, top, _CMP_GT_OQ)));
+                aiY = _mm256_blendv_ps(y, aiY, approaching);
+
+                p[side] = _mm256_blendv_ps(manual, aiY, isAI);
+            }
+            _mm256_storeu_ps(&paddle1Y[i], p[0]);
+            _mm256_storeu_ps(&paddle2Y[i], p[1]);
+
+            bx = _mm256_add_ps(bx, _mm256_mul_ps(vx, dt));
+            by = _mm256_add_ps(by, _mm256_mul_ps(vy, dt));
+            __m256 wall = _mm256_or_ps(_mm256_cmp_ps(by, top, _CMP_LE_OQ), _mm256_cmp_ps(by, ballMaxY, _CMP_GE_OQ));
+            vy = _mm256_xor_ps(vy, _mm256_and_ps(wall, signBit));
+
+            for (int side = 0; side < 2; side++) {
+                __m256i ix = _mm256_cvttps_epi32(bx);
+                __m256i iy = _mm256_cvttps_epi32(by);
+                __m256i px = _mm256_set1_epi32(side == 0 ? (int)PADDLE1_X : (int)PADDLE2_X);
+                __m256i py = _mm256_cvttps_epi32(p[side]);
+                // a < b  <=>  b > a
+                __m256i overlap = _mm256_and_si256(
+                    _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(px, _mm256_set1_epi32(PADDLE_WIDTH)), ix),
+                                     _mm256_cmpgt_epi32(_mm256_add_epi32(ix, _mm256_set1_epi32(BALL_SIZE)), px)),
+                    _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(py, _mm256_set1_epi32(PADDLE_HEIGHT)), iy),
+                                     _mm256_cmpgt_epi32(_mm256_add_epi32(iy, _mm256_set1_epi32(BALL_SIZE)), py)));
+                __m256 hit = _mm256_castsi256_ps(overlap);
+                __m256 hitPos = _mm256_div_ps(_mm256_sub_ps(_mm256_add_ps(by, halfBall), _mm256_add_ps(p[side], halfPaddle)), halfPaddle);
+                vx = _mm256_xor_ps(vx, _mm256_and_ps(hit, signBit));
+                vy = _mm256_blendv_ps(vy, _mm256_mul_ps(hitPos, _mm256_set1_ps(BALL_SPEED)), hit);
+            }
+
+            __m256 left = _mm256_cmp_ps(bx, _mm256_set1_ps((float)GAME_MARGIN_SIDES), _CMP_LT_OQ);
+            __m256 right = _mm256_andnot_ps(left, _mm256_cmp_ps(bx, _mm256_set1_ps((float)(WINDOW_WIDTH - GAME_MARGIN_SIDES)), _CMP_GT_OQ));
+            __m256 scored = _mm256_or_ps(left, right);
+            __m256i s1 = _mm256_loadu_si256((const __m256i*)&score1[i]);
+            __m256i s2 = _mm256_loadu_si256((const __m256i*)&score2[i]);
+            _mm256_storeu_si256((__m256i*)&score1[i], _mm256_sub_epi32(s1, _mm256_castps_si256(right)));
+            _mm256_storeu_si256((__m256i*)&score2[i], _mm256_sub_epi32(s2, _mm256_castps_si256(left)));
+            __m256 serveVX = _mm256_blendv_ps(_mm256_set1_ps(BALL_SPEED), _mm256_set1_ps(-BALL_SPEED),
+                                              _mm256_cmp_ps(vx, zero, _CMP_GT_OQ));
+            bx = _mm256_blendv_ps(bx, _mm256_set1_ps(RESET_X), scored);
+            by = _mm256_blendv_ps(by, _mm256_set1_ps(RESET_Y), scored);
+            vx = _mm256_blendv_ps(vx, serveVX, scored);
+            vy = _mm256_blendv_ps(vy, _mm256_set1_ps(BALL_SPEED), scored);
+
+            _mm256_storeu_ps(&ballX[i], bx);
+            _mm256_storeu_ps(&ballY[i], by);
+            _mm256_storeu_ps(&ballVX[i], vx);
+            _mm256_storeu_ps(&ballVY[i], vy);
+        }
+    }
+#endif
+
+private:
+#ifdef BATCH_PHYSICS_X86
+    static __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+#endif
+};
+
+// Lote en coma fija (mismos bits en cualquier compilación, ver fixed_point.h) con un kernel
+// AVX2 de enteros de 32 bits además del escalar. No hay versión SSE2: el producto con signo
+// de 32x32 bits (_mm_mul_epi32) no llega hasta SSE4.1.
+class FixedBatchPhysics : public BasicBatchPhysics<Fixed16> {
+public:
+    static const size_t LANES = 8;
+
+    explicit FixedBatchPhysics(size_t matches) : BasicBatchPhysics<Fixed16>(matches, LANES) {}
+
+    static BatchKernel bestKernel() {
+#ifdef BATCH_PHYSICS_X86
+        if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+#endif
+        return KERNEL_SCALAR;
+    }
+
+    void step(Fixed16 deltaTime, BatchKernel kernel) {
+        run(deltaTime, kernel, 1);
+    }
+
+    // ticks pasos seguidos con el mismo kernel. Un producto en coma fija cuesta varias
+    // instrucciones en AVX2, así que los desplazamientos de cada tick se calculan de antemano:
+    // el de la IA (velocidad * deltaTime) una vez para todos los ticks y el de la pelota cada
+    // vez que cambia su velocidad (rebote, golpe o punto)
+    void run(Fixed16 deltaTime, BatchKernel kernel, long ticks) {
+        prepareAISteps(deltaTime);
+#ifdef BATCH_PHYSICS_X86
+        if (kernel == KERNEL_AVX2) {
+            ballStepX.resize(padded);
+            ballStepY.resize(padded);
+            for (size_t i = 0; i < padded; i++) {
+                ballStepX[i] = ballVX[i] * deltaTime;
+                ballStepY[i] = ballVY[i] * deltaTime;
+            }
+            for (long t = 0; t < ticks; t++) {
+                stepAVX2Prepared(deltaTime);
+            }
+            return;
+        }
+#endif
+        for (long t = 0; t < ticks; t++) {
+            stepScalarPrepared(deltaTime);
+        }
+    }
+
+#ifdef BATCH_PHYSICS_X86
+    // Las mismas operaciones enteras que Fixed16 en stepScalar(), así que da los mismos bits.
+    // Usa los desplazamientos preparados en run() y mantiene los de la pelota
+    __attribute__((target("avx2")))
+    void stepAVX2Prepared(Fixed16 deltaTime) {
+        const __m256i dt = _mm256_set1_epi32(deltaTime.raw);
+        const __m256i top = splat(Fixed16(GAME_MARGIN_TOP));
+        const __m256i ballMaxY = splat(Fixed16(GAME_MARGIN_TOP + GAME_HEIGHT - BALL_SIZE));
+        const __m256i moveStep = mulSplat(splat(Fixed16(PADDLE_SPEED)), dt);
+        const __m256i ballSpeed = splat(Fixed16(BALL_SPEED));
+        const __m256i halfBall = splat(Fixed16(BALL_SIZE / 2));
+        const __m256i halfPaddle = splat(Fixed16(PADDLE_HEIGHT / 2));
+        const __m256 hitDivisor = _mm256_set1_ps((float)(PADDLE_HEIGHT / 2));
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i allOnes = _mm256_set1_epi32(-1);
+        const __m256i leftGoal = splat(Fixed16(GAME_MARGIN_SIDES));
+        const __m256i rightGoal = splat(Fixed16(WINDOW_WIDTH - GAME_MARGIN_SIDES));
+        const __m256i resetX = splat(Fixed16(RESET_X));
+        const __m256i resetY = splat(Fixed16(RESET_Y));
+        const int paddleX[2] = { (int)Fixed16(PADDLE1_X), (int)Fixed16(PADDLE2_X) };
+
+        // Punteros en variables locales: los stores de AVX2 pueden apuntar a cualquier tipo, así
+        // que con los vectores el compilador volvería a leer cada data() tras cada store
+        Fixed16* ballXData = &ballX[0];
+        Fixed16* ballYData = &ballY[0];
+        Fixed16* ballVXData = &ballVX[0];
+        Fixed16* ballVYData = &ballVY[0];
+        Fixed16* stepXData = &ballStepX[0];
+        Fixed16* stepYData = &ballStepY[0];
+        Fixed16* paddleData[2] = { &paddle1Y[0], &paddle2Y[0] };
+        const int32_t* inputData[2] = { &input1[0], &input2[0] };
+        const int32_t* aiData[2] = { &ai1[0], &ai2[0] };
+        const Fixed16* aiStepData[2] = { &ai1Step[0], &ai2Step[0] };
+        const Fixed16* deadZoneData[2] = { &ai1DeadZone[0], &ai2DeadZone[0] };
+        int32_t* scoreData[2] = { &score1[0], &score2[0] };
+
+        for (size_t i = 0; i < padded; i += 8) {
+            __m256i bx = load(ballXData + i);
+            __m256i by = load(ballYData + i);
+            __m256i vx = load(ballVXData + i);
+            __m256i vy = load(ballVYData + i);
+            __m256i ballCenterY = _mm256_add_epi32(by, halfBall);
+
+            __m256i p1 = stepPaddleAVX2(load(paddleData[0] + i), loadInt(inputData[0] + i), loadInt(aiData[0] + i),
+                                        load(aiStepData[0] + i), load(deadZoneData[0] + i), ballCenterY,
+                                        _mm256_cmpgt_epi32(zero, vx), moveStep);
+            __m256i p2 = stepPaddleAVX2(load(paddleData[1] + i), loadInt(inputData[1] + i), loadInt(aiData[1] + i),
+                                        load(aiStepData[1] + i), load(deadZoneData[1] + i), ballCenterY,
+                                        _mm256_cmpgt_epi32(vx, zero), moveStep);
+            store(paddleData[0] + i, p1);
+            store(paddleData[1] + i, p2);
+
+            bx = _mm256_add_epi32(bx, load(stepXData + i));
+            by = _mm256_add_epi32(by, load(stepYData + i));
+            // by <= top || by >= ballMaxY  <=>  !(by > top && ballMaxY > by)
+            __m256i wall = _mm256_xor_si256(_mm256_and_si256(_mm256_cmpgt_epi32(by, top), _mm256_cmpgt_epi32(ballMaxY, by)), allOnes);
+            vy = negateWhere(vy, wall);
+            __m256i changed = wall;  // Carriles cuya velocidad cambia en este tick
+
+            __m256i ix = truncate(bx);
+            __m256i iy = truncate(by);
+            for (int side = 0; side < 2; side++) {
+                __m256i py = side == 0 ? p1 : p2;
+                __m256i hit = paddleHitAVX2(ix, iy, paddleX[side], truncate(py));
+                // Casi nunca hay golpe en ninguno de los 8 carriles: así se salta la división
+                if (_mm256_testz_si256(hit, hit)) continue;
+                // Fixed16 / Fixed16(40) es raw / 40 truncado. En float es exacto: la diferencia
+                // cabe en 24 bits y el cociente redondeado nunca cruza un entero (dista al menos
+                // 1/40 de él y el error es menor que 1/128)
+                __m256i difference = _mm256_sub_epi32(_mm256_add_epi32(by, halfBall), _mm256_add_epi32(py, halfPaddle));
+                __m256i hitPos = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(difference), hitDivisor));
+                vx = negateWhere(vx, hit);
+                vy = _mm256_blendv_epi8(vy, mulSplat(hitPos, ballSpeed), hit);
+                changed = _mm256_or_si256(changed, hit);
+            }
+
+            __m256i left = _mm256_cmpgt_epi32(leftGoal, bx);
+            __m256i right = _mm256_andnot_si256(left, _mm256_cmpgt_epi32(bx, rightGoal));
+            __m256i scored = _mm256_or_si256(left, right);
+            // Los goles son raros: marcador y saque solo si alguno de los 8 carriles marca
+            if (!_mm256_testz_si256(scored, scored)) {
+                storeInt(scoreData[0] + i, _mm256_sub_epi32(loadInt(scoreData[0] + i), right));
+                storeInt(scoreData[1] + i, _mm256_sub_epi32(loadInt(scoreData[1] + i), left));
+                __m256i serveVX = _mm256_blendv_epi8(ballSpeed, _mm256_sub_epi32(zero, ballSpeed), _mm256_cmpgt_epi32(vx, zero));
+                bx = _mm256_blendv_epi8(bx, resetX, scored);
+                by = _mm256_blendv_epi8(by, resetY, scored);
+                vx = _mm256_blendv_epi8(vx, serveVX, scored);
+                vy = _mm256_blendv_epi8(vy, ballSpeed, scored);
+                changed = _mm256_or_si256(changed, scored);
+            }
+
+            // (-v) * dt no es -(v * dt) al redondear hacia abajo: se recalcula con el producto
+            if (!_mm256_testz_si256(changed, changed)) {
+                store(stepXData + i, mulSplat(vx, dt));
+                store(stepYData + i, mulSplat(vy, dt));
+            }
+
+            store(ballXData + i, bx);
+            store(ballYData + i, by);
+            store(ballVXData + i, vx);
+            store(ballVYData + i, vy);
+        }
+    }
+#endif
+
+private:
+    std::vector<Fixed16> ballStepX, ballStepY;  // ballV * deltaTime del kernel AVX2
+
+#ifdef BATCH_PHYSICS_X86
+    __attribute__((target("avx2")))
+    static __m256i splat(Fixed16 value) {
+        return _mm256_set1_epi32(value.raw);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i load(const Fixed16* values) {
+        return _mm256_loadu_si256((const __m256i*)values);
+    }
+
+    __attribute__((target("avx2")))
+    static void store(Fixed16* values, __m256i v) {
+        _mm256_storeu_si256((__m256i*)values, v);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i loadInt(const int32_t* values) {
+        return _mm256_loadu_si256((const __m256i*)values);
+    }
+
+    __attribute__((target("avx2")))
+    static void storeInt(int32_t* values, __m256i v) {
+        _mm256_storeu_si256((__m256i*)values, v);
+    }
+
+    // Una paleta en 8 partidas: manual o IA según aiFlags; approaching marca los carriles con
+    // la pelota acercándose a ese lado
+    __attribute__((target("avx2"), always_inline))
+    static inline __m256i stepPaddleAVX2(__m256i y, __m256i input, __m256i aiFlags, __m256i aiStep, __m256i deadZone,
+                                         __m256i ballCenterY, __m256i approaching, __m256i moveStep) {
+        const __m256i top = splat(Fixed16(GAME_MARGIN_TOP));
+        const __m256i paddleMaxY = splat(Fixed16(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT));
+        const __m256i upBit = _mm256_set1_epi32(BATCH_INPUT_UP);
+        const __m256i downBit = _mm256_set1_epi32(BATCH_INPUT_DOWN);
+        __m256i isAI = _mm256_cmpeq_epi32(aiFlags, _mm256_set1_epi32(1));
+
+        __m256i up = _mm256_cmpeq_epi32(_mm256_and_si256(input, upBit), upBit);
+        __m256i down = _mm256_cmpeq_epi32(_mm256_and_si256(input, downBit), downBit);
+        __m256i manual = _mm256_blendv_epi8(y, _mm256_sub_epi32(y, moveStep),
+                                            _mm256_and_si256(up, _mm256_cmpgt_epi32(y, top)));
+        manual = _mm256_blendv_epi8(manual, _mm256_add_epi32(manual, moveStep),
+                                    _mm256_and_si256(down, _mm256_cmpgt_epi32(paddleMaxY, manual)));
+
+        __m256i center = _mm256_add_epi32(y, splat(Fixed16(PADDLE_HEIGHT / 2)));
+        __m256i wantDown = _mm256_cmpgt_epi32(_mm256_sub_epi32(ballCenterY, deadZone), center);
+        __m256i wantUp = _mm256_andnot_si256(wantDown, _mm256_cmpgt_epi32(center, _mm256_add_epi32(ballCenterY, deadZone)));
+        __m256i aiY = _mm256_blendv_epi8(y, _mm256_add_epi32(y, aiStep),
+                                         _mm256_and_si256(wantDown, _mm256_cmpgt_epi32(paddleMaxY, y)));
+        aiY = _mm256_blendv_epi8(aiY, _mm256_sub_epi32(y, aiStep),
+                                 _mm256_and_si256(wantUp, _mm256_cmpgt_epi32(y, top)));
+        aiY = _mm256_blendv_epi8(y, aiY, approaching);
+        return _mm256_blendv_epi8(manual, aiY, isAI);
+    }
+
+    // Intersección de la pelota (ix, iy) con la paleta de x fija px y altura py, en píxeles
+    // enteros como SDL_HasIntersection
+    __attribute__((target("avx2"), always_inline))
+    static inline __m256i paddleHitAVX2(__m256i ix, __m256i iy, int px, __m256i py) {
+        return _mm256_and_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(px + PADDLE_WIDTH), ix),
+                             _mm256_cmpgt_epi32(ix, _mm256_set1_epi32(px - BALL_SIZE))),
+            _mm256_and_si256(_mm256_cmpgt_epi32(_mm256_add_epi32(py, _mm256_set1_epi32(PADDLE_HEIGHT)), iy),
+                             _mm256_cmpgt_epi32(_mm256_add_epi32(iy, _mm256_set1_epi32(BALL_SIZE)), py)));
+    }
+
+    // Producto Fixed16 (a * b) >> 16 sobre 64 bits, con b igual en los 8 carriles (todos los
+    // productos del kernel tienen un factor constante). _mm256_mul_epi32 multiplica los
+    // carriles pares; los impares se bajan 32 bits antes. Los bits 16..47 del producto son el
+    // resultado, y ahí el desplazamiento lógico da lo mismo que el aritmético.
+    __attribute__((target("avx2")))
+    static __m256i mulSplat(__m256i a, __m256i b) {
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), Fixed16::FRACTION_BITS);
+        __m256i odd = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), b), 32 - Fixed16::FRACTION_BITS);
+        return _mm256_blend_epi32(even, odd, 0xAA);
+    }
+
+    // (int) de Fixed16: redondeo hacia abajo
+    __attribute__((target("avx2")))
+    static __m256i truncate(__m256i v) {
+        return _mm256_srai_epi32(v, Fixed16::FRACTION_BITS);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i negateWhere(__m256i v, __m256i mask) {
+        return _mm256_sub_epi32(_mm256_xor_si256(v, mask), mask);
+    }
+#endif
+};
+
+// Compara Match::step() (la ruta de Game::update(), en modo discreto) con el motor por lotes escalar y SIMD.
+// Las partidas combinan IA de distintas dificultades y control manual, con saques aleatorios.
+inline bool runPhysicsBenchmark(size_t matches, long ticks, int tickRate, uint32_t seed) {
+    float deltaTime = 1.0f / tickRate;
+    std::vector<FloatMatch> initial(matches);
+    std::vector<PaddleInput> inputs1(matches);
+    XorShift32 rng(seed);
+    for (size_t i = 0; i < matches; i++) {
+        FloatMatch& m = initial[i];
+        m.collisionMode = COLLISION_DISCRETE;
+        m.player1.isAI = (i % 4 != 3);
+        m.player1.ai = AIParams(0.3f + (i % 8) * 0.1f, (float)(i % 3) * 5.0f);
+        m.player2.isAI = true;
+        uint32_t r = rng.next();
+        m.ball.velocityX = (r & 1) ? BALL_SPEED : -BALL_SPEED;
+        m.ball.velocityY = ((int)((r >> 1) % 2001) - 1000) / 1000.0f * BALL_SPEED;
+        inputs1[i] = PaddleInput((r >> 12) % 3 == 1, (r >> 12) % 3 == 2);
+    }
+
+    // Referencia: un Match por partida, como Game::update()
+    std::vector<FloatMatch> reference(initial);
+    PaddleInput none;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long t = 0; t < ticks; t++) {
+        for (size_t i = 0; i < matches; i++) {
+            reference[i].step(deltaTime, inputs1[i], none);
+        }
+    }
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "=== BENCHMARK DE FÍSICA ===" << '\n';
+    std::cout << "Partidas: " << matches << " x " << ticks << " ticks" << '\n';
+    double matchTicks = (double)matches * ticks;
+    std::cout << "Match::step          " << (long long)(matchTicks / referenceSeconds) << " partida-ticks/s  "
+              << (long long)(matches / referenceSeconds) << " partidas/s" << '\n';
+
+    bool allEqual = true;
+    double kernelSeconds[3] = { 0.0, 0.0, 0.0 };
+    BatchKernel kernels[] = { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2 };
+    for (int k = 0; k < 3; k++) {
+        BatchKernel kernel = kernels[k];
+        if (kernel > BatchPhysics::bestKernel()) continue;
+
+        BatchPhysics batch(matches);
+        for (size_t i = 0; i < matches; i++) {
+            batch.loadMatch(i, initial[i]);
+            batch.input1[i] = (inputs1[i].up ? BATCH_INPUT_UP : 0) | (inputs1[i].down ? BATCH_INPUT_DOWN : 0);
+        }
+        start = std::chrono::steady_clock::now();
+        batch.run(deltaTime, kernel, ticks);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        kernelSeconds[kernel] = seconds;
+
+        // Verificación bit a bit contra la referencia
+        bool equal = true;
+        for (size_t i = 0; i < matches && equal; i++) {
+            FloatMatch result(reference[i]);
+            batch.storeMatch(i, result);
+            const FloatMatch& r = reference[i];
+            equal = memcmp(&result.ball.x, &r.ball.x, sizeof(float)) == 0 &&
+                    memcmp(&result.ball.y, &r.ball.y, sizeof(float)) == 0 &&
+                    memcmp(&result.ball.velocityX, &r.ball.velocityX, sizeof(float)) == 0 &&
+                    memcmp(&result.ball.velocityY, &r.ball.velocityY, sizeof(float)) == 0 &&
+                    memcmp(&result.player1.y, &r.player1.y, sizeof(float)) == 0 &&
+                    memcmp(&result.player2.y, &r.player2.y, sizeof(float)) == 0 &&
+                    result.score1 == r.score1 && result.score2 == r.score2;
+        }
+        allEqual = allEqual && equal;
+
+        char name[32];
+        snprintf(name, sizeof(name), "Lote %-14s", batchKernelName(kernel));
+        std::cout << name << " " << (long long)(matchTicks / seconds) << " partida-ticks/s  "
+                  << (long long)(matches / seconds) << " partidas/s  x" << referenceSeconds / seconds
+                  << (equal ? "  [idéntico]" : "  [DIFERENTE]") << '\n';
+    }
+
+    // Los mismos lotes en coma fija: redondean distinto, así que no se comparan con float,
+    // sino el kernel AVX2 con el escalar
+    Fixed16 fixedDelta = Fixed16::fromRatio(1, tickRate);
+    uint64_t fixedScalarHash = 0;
+    BatchKernel fixedKernels[] = { KERNEL_SCALAR, KERNEL_AVX2 };
+    for (int k = 0; k < 2; k++) {
+        BatchKernel kernel = fixedKernels[k];
+        if (kernel > FixedBatchPhysics::bestKernel()) continue;
+
+        FixedBatchPhysics batch(matches);
+        for (size_t i = 0; i < matches; i++) {
+            batch.loadMatch(i, initial[i]);
+            batch.input1[i] = (inputs1[i].up ? BATCH_INPUT_UP : 0) | (inputs1[i].down ? BATCH_INPUT_DOWN : 0);
+        }
+        start = std::chrono::steady_clock::now();
+        batch.run(fixedDelta, kernel, ticks);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        uint64_t hash = batch.fingerprint();
+        if (kernel == KERNEL_SCALAR) fixedScalarHash = hash;
+        bool equal = hash == fixedScalarHash;
+        allEqual = allEqual && equal;
+
+        char name[32];
+        snprintf(name, sizeof(name), "Fijo %-14s", batchKernelName(kernel));
+        std::cout << name << " " << (long long)(matchTicks / seconds) << " partida-ticks/s  "
+                  << (long long)(matches / seconds) << " partidas/s  x" << referenceSeconds / seconds
+                  << "  (x" << kernelSeconds[kernel] / seconds << " frente a float " << batchKernelName(kernel) << ")"
+                  << (equal ? "" : "  [DIFERENTE del escalar]") << '\n';
+    }
+    std::cout.flush();
+    return allEqual;
+}
+
+// Huella de --check-determinism con los valores por defecto (4096 partidas, 2000 ticks,
+// DEFAULT_TICK_RATE y semilla 1). La coma fija debe dar esta misma en cualquier compilación.
+const uint64_t DETERMINISM_REFERENCE = 0xa60f18e126580624ull;
+
+// Partidas de la comprobación: como las del benchmark, pero con las dificultades y los
+// saques como fracciones enteras, para que el estado inicial en coma fija tampoco dependa
+// de operaciones en float
+template <typename Real>
+inline void setupDeterminismBatch(BasicBatchPhysics<Real>& batch, uint32_t seed) {
+    XorShift32 rng(seed);
+    for (size_t i = 0; i < batch.size(); i++) {
+        batch.ai1[i] = (i % 4 != 3) ? 1 : 0;
+        batch.ai1Speed[i] = Real(PADDLE_SPEED) * realFromRatio<Real>(3 + (int)(i % 8), 10);
+        batch.ai1DeadZone[i] = Real((int)(i % 3) * 5);
+        batch.ai2Speed[i] = Real(PADDLE_SPEED) * realFromRatio<Real>(8, 10);
+        batch.ai2DeadZone[i] = Real(10);
+        uint32_t r = rng.next();
+        batch.ballVX[i] = (r & 1) ? Real(BALL_SPEED) : -Real(BALL_SPEED);
+        batch.ballVY[i] = realFromRatio<Real>((int)((r >> 1) % 2001) - 1000, 1000) * Real(BALL_SPEED);
+        batch.input1[i] = ((r >> 12) % 3 == 1 ? BATCH_INPUT_UP : 0) | ((r >> 12) % 3 == 2 ? BATCH_INPUT_DOWN : 0);
+    }
+}
+
+// Simula las partidas de la comprobación con el kernel indicado y devuelve la huella final
+template <typename Batch, typename Real>
+inline uint64_t runDeterminismBatch(Batch& batch, long ticks, Real deltaTime, uint32_t seed, double& seconds) {
+    setupDeterminismBatch(batch, seed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    batch.runScalar(deltaTime, ticks);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return batch.fingerprint();
+}
+
+// Huella de las partidas completas (BasicMatch<Fixed16>) con los valores por defecto
+const uint64_t DETERMINISM_MATCH_REFERENCE = 0x35208099a22bdc3eull;
+
+// Configuraciones de las partidas completas: colisión continua o discreta, IA que persigue
+// o que predice, y jugador 1 con teclado y stick pseudoaleatorios o con IA
+const int DETERMINISM_MATCH_CONFIGS = 8;
+
+// Partida completa de la comprobación: la misma Match::step() que usan el juego, las
+// repeticiones, el rollback y el servidor compilados con -DPONG_FIXED_PHYSICS. El saque es
+// una fracción entera, como en setupDeterminismBatch()
+template <typename Real>
+inline void setupDeterminismMatch(BasicMatch<Real>& match, int game, XorShift32& rng) {
+    int config = game % DETERMINISM_MATCH_CONFIGS;
+    match.collisionMode = (config & 1) ? COLLISION_DISCRETE : COLLISION_SWEPT;
+    match.player1.isAI = (config & 4) != 0;
+    match.player2.isAI = true;
+    match.player1.ai.mode = (config & 2) ? AI_CHASE : AI_PREDICT;
+    match.player2.ai.mode = (config & 2) ? AI_PREDICT : AI_CHASE;
+    match.player2.ai.difficulty = 0.7f;
+    match.reset();
+    uint32_t r = rng.next();
+    match.ball.velocityX = (r & 1) ? Real(BALL_SPEED) : -Real(BALL_SPEED);
+    match.ball.velocityY = realFromRatio<Real>((int)((r >> 1) % 2001) - 1000, 1000) * Real(BALL_SPEED);
+}
+
+// Entrada del jugador 1 cuando no es la IA: teclas o stick ya cuantizado, como en una repetición
+inline PaddleInput determinismInput(XorShift32& rng) {
+    uint32_t r = rng.next();
+    PaddleInput input((r & 2) != 0, (r & 4) != 0);
+    if (r & 1) {
+        input = PaddleInput();
+        input.axis = axisFromSteps((int)((r >> 8) % 255) - 127);
+    }
+    return input;
+}
+
+// Simula las partidas completas y devuelve la huella de la suma de su estado en cada tick.
+// Si recorder no es nulo graba la primera en path y guarda su suma a mitad y al final.
+template <typename Real>
+inline uint64_t runDeterminismMatches(int games, long ticks, int tickRate, uint32_t seed,
+                                      ReplayRecorder* recorder, const std::string& path,
+                                      uint32_t& middleChecksum, uint32_t& finalChecksum) {
+    Real deltaTime = realFromRatio<Real>(1, tickRate);
+    XorShift32 rng(seed);
+    uint64_t hash = 1469598103934665603ull;
+    for (int game = 0; game < games; game++) {
+        BasicMatch<Real> match;
+        setupDeterminismMatch(match, game, rng);
+        bool recording = recorder && game == 0 && recorder->start(path, match, tickRate);
+        PaddleInput none;
+        for (long t = 0; t < ticks; t++) {
+            PaddleInput input1 = match.player1.isAI ? none : determinismInput(rng);
+            match.step(deltaTime, input1, none);
+            uint32_t checksum = matchChecksum(match);
+            hash = (hash ^ checksum) * 1099511628211ull;
+            if (!recording) continue;
+            recorder->recordTick(input1, none, match);
+            if (t + 1 == ticks / 2) middleChecksum = checksum;
+        }
+        if (recording) {
+            recorder->finish();
+            finalChecksum = matchChecksum(match);
+        }
+    }
+    return hash;
+}
+
+// Ida y vuelta por una repetición: la abre, la reproduce comprobando cada tick y salta a la
+// mitad desde el final (keyframe + simulación); las sumas deben ser las de la partida grabada
+inline bool checkDeterminismReplay(const std::string& path, long ticks, uint32_t middleChecksum,
+                                   uint32_t finalChecksum, std::ostream& out) {
+    ReplayReader reader;
+    if (!reader.open(path)) return false;
+    if (!reader.usesPhysics<Fixed16>() || (long)reader.getHeader().tickCount != ticks) {
+        out << "Repetición: la cabecera no corresponde a la partida grabada\n";
+        return false;
+    }
+    FixedMatch match;
+    reader.restoreInitialState(match);
+    Fixed16 deltaTime = Fixed16::fromRatio(1, reader.getHeader().tickRate);
+    PaddleInput input1, input2;
+    while (reader.nextInputs(input1, input2)) {
+        match.step(deltaTime, input1, input2);
+        reader.verify(match);
+    }
+    bool replayed = reader.getDesyncTick() < 0 && reader.getTicksRead() == ticks &&
+                    matchChecksum(match) == finalChecksum;
+    bool sought = reader.seek(match, ticks / 2) && matchChecksum(match) == middleChecksum;
+    out << "Repetición en coma fija (" << ticks << " ticks): ";
+    if (reader.getDesyncTick() >= 0) {
+        out << "DESYNC en el tick " << reader.getDesyncTick();
+    } else {
+        out << (replayed ? "reproducida sin desync" : "estado final DIFERENTE");
+    }
+    out << ", salto al tick " << ticks / 2 << (sought ? " correcto" : " DIFERENTE") << '\n';
+    return replayed && sought;
+}
+
+// Archivo temporal para la repetición de la comprobación (vacío si no se puede crear)
+inline std::string determinismReplayPath() {
+#ifndef _WIN32
+    char path[] = "/tmp/pong-determinismo-XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return std::string();
+    close(fd);
+    return path;
+#else
+    char path[L_tmpnam];
+    return std::tmpnam(path) ? std::string(path) : std::string();
+#endif
+}
+
+// Simula las mismas partidas en coma fija y en float y muestra la huella de cada estado
+// final. La de coma fija se compara con DETERMINISM_REFERENCE (solo con los valores por
+// defecto) y con la del kernel AVX2; la de float se muestra para ver cuánto cambia entre
+// compilaciones. Después hace lo mismo con partidas completas de BasicMatch (matches / 64
+// partidas de 8 * ticks ticks, contra DETERMINISM_MATCH_REFERENCE) y graba la primera en
+// coma fija para reproducirla desde el archivo.
+inline bool runDeterminismCheck(size_t matches, long ticks, int tickRate, uint32_t seed) {
+    Fixed16 fixedDelta = Fixed16::fromRatio(1, tickRate);
+    double fixedSeconds = 0.0, floatSeconds = 0.0;
+    FixedBatchPhysics fixedBatch(matches);
+    uint64_t fixedHash = runDeterminismBatch(fixedBatch, ticks, fixedDelta, seed, fixedSeconds);
+    BasicBatchPhysics<float> floatBatch(matches);
+    uint64_t floatHash = runDeterminismBatch(floatBatch, ticks, 1.0f / tickRate, seed, floatSeconds);
+
+    int games = (int)(matches / 64) < DETERMINISM_MATCH_CONFIGS ? DETERMINISM_MATCH_CONFIGS : (int)(matches / 64);
+    long matchTicks = ticks * 8;
+    std::string replayPath = determinismReplayPath();
+    uint32_t middleChecksum = 0, finalChecksum = 0, unused = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t fixedMatchHash;
+    {
+        // El grabador anuncia el archivo por consola: silenciarlo, el resultado va abajo
+        ReplayRecorder recorder;
+        std::cout.setstate(std::ios::failbit);
+        fixedMatchHash = runDeterminismMatches<Fixed16>(games, matchTicks, tickRate, seed,
+                                                        replayPath.empty() ? NULL : &recorder, replayPath,
+                                                        middleChecksum, finalChecksum);
+        std::cout.clear();
+    }
+    double fixedMatchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    uint64_t floatMatchHash = runDeterminismMatches<float>(games, matchTicks, tickRate, seed, NULL,
+                                                           std::string(), unused, unused);
+    double floatMatchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream out;
+    out << "=== COMPROBACIÓN DE DETERMINISMO ===\n";
+    out << "Partidas: " << matches << " x " << ticks << " ticks a " << tickRate << " ticks/s, semilla " << seed << '\n';
+    out << std::hex << std::setfill('0');
+    out << "Coma fija 16.16: huella " << std::setw(16) << fixedHash << '\n';
+    out << "Coma flotante:   huella " << std::setw(16) << floatHash << " (puede cambiar según el compilador y sus opciones)\n";
+    out << std::dec << std::setfill(' ');
+    out << "Tiempo escalar: coma fija " << fixedSeconds * 1000.0 << " ms  float " << floatSeconds * 1000.0 << " ms\n";
+
+    bool ok = true;
+    if (FixedBatchPhysics::bestKernel() == KERNEL_AVX2) {
+        FixedBatchPhysics vectorBatch(matches);
+        setupDeterminismBatch(vectorBatch, seed);
+        vectorBatch.run(fixedDelta, KERNEL_AVX2, ticks);
+        bool same = vectorBatch.fingerprint() == fixedHash;
+        out << "Coma fija AVX2: " << (same ? "misma huella que el escalar" : "DIFERENTE del escalar") << '\n';
+        ok = same;
+    }
+
+    out << "Partidas completas (Match::step, colisión continua y discreta, IA chase y predict): "
+        << games << " x " << matchTicks << " ticks\n";
+    out << std::hex << std::setfill('0');
+    out << "Coma fija 16.16: huella " << std::setw(16) << fixedMatchHash << '\n';
+    out << "Coma flotante:   huella " << std::setw(16) << floatMatchHash << " (puede cambiar según el compilador y sus opciones)\n";
+    out << std::dec << std::setfill(' ');
+    out << "Tiempo: coma fija " << fixedMatchSeconds * 1000.0 << " ms  float " << floatMatchSeconds * 1000.0 << " ms\n";
+
+    if (replayPath.empty()) {
+        out << "Repetición: no se pudo crear un archivo temporal\n";
+        ok = false;
+    } else {
+        ok = checkDeterminismReplay(replayPath, matchTicks, middleChecksum, finalChecksum, out) && ok;
+        std::remove(replayPath.c_str());
+    }
+
+    bool defaults = matches == 4096 && ticks == 2000 && tickRate == DEFAULT_TICK_RATE && seed == 1;
+    if (defaults) {
+        bool matchesReference = fixedHash == DETERMINISM_REFERENCE;
+        out << (matchesReference ? "Coma fija: coincide con la referencia\n" : "Coma fija: DIFERENTE de la referencia\n");
+        bool matchMatchesReference = fixedMatchHash == DETERMINISM_MATCH_REFERENCE;
+        out << (matchMatchesReference ? "Partidas completas en coma fija: coinciden con la referencia\n"
+                                      : "Partidas completas en coma fija: DIFERENTES de la referencia\n");
+        ok = ok && matchesReference && matchMatchesReference;
+    } else {
+        out << "(sin referencia para estos valores: compara la huella entre compilaciones)\n";
+    }
+    std::cout << out.str() << std::flush;
+    return ok;
+}
+
+#endif
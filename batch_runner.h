@@ -0,0 +1,328 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+// Ejecución por lotes de miles de partidas headless repartidas entre todos los núcleos.
+// Dos modos:
+//   - sweep: cada combinación de la rejilla de parámetros de IA juega contra la IA de referencia
+//   - tournament: todas las combinaciones juegan entre sí (round-robin)
+// Para cada configuración se informa del porcentaje de victorias, golpes por punto y Elo.
+
+#include "pong_core.h"
+#include "headless.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Rango "min:max:paso" o un único valor
+struct ParamRange {
+    float min, max, step;
+
+    ParamRange(float value = 0.0f) : min(value), max(value), step(1.0f) {}
+    ParamRange(float lo, float hi, float st) : min(lo), max(hi), step(st) {}
+
+    static bool parse(const char* text, ParamRange& range) {
+        float lo, hi, st;
+        if (sscanf(text, "%f:%f:%f", &lo, &hi, &st) == 3 && st > 0.0f && hi >= lo) {
+            range = ParamRange(lo, hi, st);
+            return true;
+        }
+        if (sscanf(text, "%f", &lo) == 1) {
+            range = ParamRange(lo);
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<float> values() const {
+        std::vector<float> result;
+        int count = (int)std::floor((max - min) / step + 0.5f) + 1;
+        for (int i = 0; i < count; i++) {
+            result.push_back(min + i * step);
+        }
+        return result;
+    }
+};
+
+struct AIVariant {
+    std::string name;
+    AIParams params;
+};
+
+enum BatchMode {
+    BATCH_SWEEP,
+    BATCH_TOURNAMENT
+};
+
+struct BatchConfig {
+    BatchMode mode;
+    AIMode aiMode;          // Modo de IA de las variantes (la referencia siempre es AI_CHASE)
+    ParamRange difficulty;
+    ParamRange deadZone;
+    ParamRange reactionDelay;
+    ParamRange aimError;
+    int gamesPerPairing;
+    int pointsToWin;
+    long maxTicks;
+    int tickRate;
+    unsigned threads;   // 0 = todos los núcleos
+    uint32_t seed;
+    std::string csvPath;
+
+    BatchConfig() : mode(BATCH_SWEEP), aiMode(AI_CHASE), difficulty(0.2f, 1.0f, 0.2f), deadZone(0.0f, 20.0f, 10.0f),
+                    reactionDelay(AIParams().reactionDelay), aimError(AIParams().aimError),
+                    gamesPerPairing(20), pointsToWin(5), maxTicks(DEFAULT_TICK_RATE * 600L),
+                    tickRate(DEFAULT_TICK_RATE), threads(0), seed(1) {}
+};
+
+struct BatchMatchResult {
+    int left, right;           // Índices de variante
+    int scoreLeft, scoreRight;
+    long ticks;
+    int rallies;
+    long long rallyHits;
+};
+
+struct VariantStats {
+    int played, wins, losses, draws;
+    long long rallies, rallyHits;
+    double elo;
+
+    VariantStats() : played(0), wins(0), losses(0), draws(0), rallies(0), rallyHits(0), elo(1500.0) {}
+
+    double winRate() const {
+        return played > 0 ? (wins + 0.5 * draws) / played : 0.0;
+    }
+
+    double averageRally() const {
+        return rallies > 0 ? (double)rallyHits / rallies : 0.0;
+    }
+};
+
+class BatchRunner {
+private:
+    BatchConfig config;
+    std::vector<AIVariant> variants;
+    std::vector<VariantStats> stats;
+    int referenceIndex;
+    double seconds;
+    long long totalTicks;
+    size_t totalMatches;
+    unsigned threadsUsed;
+
+public:
+    explicit BatchRunner(const BatchConfig& cfg) :
+        config(cfg), referenceIndex(-1), seconds(0.0), totalTicks(0), totalMatches(0), threadsUsed(0) {
+        std::vector<float> difficulties = config.difficulty.values();
+        // La zona muerta solo afecta a AI_CHASE; reacción y error solo a AI_PREDICT
+        std::vector<float> deadZones = config.aiMode == AI_CHASE ? config.deadZone.values() : std::vector<float>(1, 0.0f);
+        std::vector<float> reactions = config.aiMode == AI_PREDICT ? config.reactionDelay.values() : std::vector<float>(1, 0.0f);
+        std::vector<float> errors = config.aiMode == AI_PREDICT ? config.aimError.values() : std::vector<float>(1, 0.0f);
+        for (size_t i = 0; i < difficulties.size(); i++) {
+            for (size_t j = 0; j < deadZones.size(); j++) {
+                for (size_t k = 0; k < reactions.size(); k++) {
+                    for (size_t e = 0; e < errors.size(); e++) {
+                        AIVariant variant;
+                        char name[48];
+                        variant.params.mode = config.aiMode;
+                        variant.params.difficulty = difficulties[i];
+                        if (config.aiMode == AI_CHASE) {
+                            variant.params.deadZone = deadZones[j];
+                            snprintf(name, sizeof(name), "d%.2f_z%.1f", difficulties[i], deadZones[j]);
+                        } else {
+                            variant.params.reactionDelay = reactions[k];
+                            variant.params.aimError = errors[e];
+                            snprintf(name, sizeof(name), "p%.2f_r%.2f_e%.0f", difficulties[i], reactions[k], errors[e]);
+                        }
+                        variant.name = name;
+                        variants.push_back(variant);
+                    }
+                }
+            }
+        }
+        if (config.mode == BATCH_SWEEP) {
+            AIVariant reference;
+            reference.name = "referencia";
+            referenceIndex = (int)variants.size();
+            variants.push_back(reference);
+        }
+    }
+
+    // Juega una partida hasta pointsToWin (o maxTicks) con un saque inicial aleatorio
+    static BatchMatchResult playMatch(const BatchConfig& config, const AIParams& leftAI, const AIParams& rightAI,
+                                      uint32_t seed) {
+        Match match;
+        match.player1.isAI = true;
+        match.player2.isAI = true;
+        match.player1.ai = leftAI;
+        match.player2.ai = rightAI;
+        match.reset();
+
+        // La IA es determinista: el saque aleatorio hace que cada partida sea distinta
+        XorShift32 rng(seed);
+        uint32_t r = rng.next();
+        match.ball.velocityX = PhysicsReal((r & 1) ? BALL_SPEED : -BALL_SPEED);
+        match.ball.velocityY = realFromRatio<PhysicsReal>((int)((r >> 1) % 2001) - 1000, 1000) * PhysicsReal(BALL_SPEED);
+
+        BatchMatchResult result;
+        result.rallies = 0;
+        result.rallyHits = 0;
+        PhysicsReal deltaTime = physicsDelta(config.tickRate);
+        PaddleInput none;
+        long t = 0;
+        while (t < config.maxTicks && match.score1 < config.pointsToWin && match.score2 < config.pointsToWin) {
+            if (match.step(deltaTime, none, none) != NO_POINT) {
+                result.rallies++;
+                result.rallyHits += match.lastRallyLength;
+            }
+            t++;
+        }
+        result.scoreLeft = match.score1;
+        result.scoreRight = match.score2;
+        result.ticks = t;
+        return result;
+    }
+
+    void run() {
+        // Emparejamientos: cada variante contra la referencia, o todos contra todos
+        std::vector<std::pair<int, int> > pairings;
+        if (config.mode == BATCH_SWEEP) {
+            for (int i = 0; i < referenceIndex; i++) {
+                pairings.push_back(std::make_pair(i, referenceIndex));
+            }
+        } else {
+            for (size_t i = 0; i < variants.size(); i++) {
+                for (size_t j = i + 1; j < variants.size(); j++) {
+                    pairings.push_back(std::make_pair((int)i, (int)j));
+                }
+            }
+        }
+
+        // Orden "partida mayor": la partida g de todos los emparejamientos antes que la g+1,
+        // para que el Elo secuencial no dependa del orden de los emparejamientos
+        totalMatches = pairings.size() * config.gamesPerPairing;
+        std::vector<BatchMatchResult> results(totalMatches);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        {
+            ThreadPool pool(config.threads);
+            threadsUsed = pool.size();
+            for (size_t index = 0; index < totalMatches; index++) {
+                pool.submit([this, &pairings, &results, index]() {
+                    const std::pair<int, int>& pairing = pairings[index % pairings.size()];
+                    int game = (int)(index / pairings.size());
+                    // Se alternan los lados para que ninguna variante saque ventaja del campo
+                    int left = (game % 2 == 0) ? pairing.first : pairing.second;
+                    int right = (game % 2 == 0) ? pairing.second : pairing.first;
+                    uint32_t seed = config.seed * 2654435761u + (uint32_t)index * 40503u + 1u;
+                    BatchMatchResult result = playMatch(config, variants[left].params, variants[right].params, seed);
+                    result.left = left;
+                    result.right = right;
+                    results[index] = result;
+                });
+            }
+            pool.wait();
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        seconds = std::chrono::duration<double>(end - start).count();
+
+        aggregate(results);
+    }
+
+    void printReport() const {
+        std::vector<size_t> order(variants.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), EloGreater(stats));
+
+        std::cout << "=== LOTE " << (config.mode == BATCH_SWEEP ? "SWEEP" : "TORNEO") << " ===" << '\n';
+        std::cout << "Variantes: " << variants.size() << " | Partidas: " << totalMatches
+                  << " | Hilos: " << threadsUsed << '\n';
+        char line[160];
+        snprintf(line, sizeof(line), "%-18s %6s %6s %6s %6s %7s %8s %9s %8s",
+                 "variante", "dific", "zona", "reacc", "error", "jugadas", "victoria", "golpes/pt", "elo");
+        std::cout << line << '\n';
+        for (size_t k = 0; k < order.size(); k++) {
+            const AIVariant& v = variants[order[k]];
+            const VariantStats& s = stats[order[k]];
+            snprintf(line, sizeof(line), "%-18s %6.2f %6.1f %6.2f %6.1f %7d %7.1f%% %9.2f %8.1f",
+                     v.name.c_str(), v.params.difficulty, v.params.deadZone,
+                     v.params.reactionDelay, v.params.aimError, s.played,
+                     s.winRate() * 100.0, s.averageRally(), s.elo);
+            std::cout << line << '\n';
+        }
+        std::cout << "Tiempo: " << seconds << " s | " << (long long)(totalMatches / (seconds > 0 ? seconds : 1))
+                  << " partidas/s | " << (long long)(totalTicks / (seconds > 0 ? seconds : 1)) << " ticks/s" << std::endl;
+    }
+
+    bool writeCSV(const std::string& path) const {
+        std::ofstream out(path.c_str());
+        if (!out) {
+            std::cout << "Error escribiendo " << path << std::endl;
+            return false;
+        }
+        out << "variant,mode,difficulty,dead_zone,reaction_delay,aim_error,played,wins,losses,draws,win_rate,avg_rally,elo\n";
+        for (size_t i = 0; i < variants.size(); i++) {
+            const VariantStats& s = stats[i];
+            const AIParams& a = variants[i].params;
+            out << variants[i].name << ',' << (a.mode == AI_PREDICT ? "predict" : "chase") << ','
+                << a.difficulty << ',' << a.deadZone << ',' << a.reactionDelay << ',' << a.aimError << ','
+                << s.played << ',' << s.wins << ',' << s.losses << ',' << s.draws << ','
+                << s.winRate() << ',' << s.averageRally() << ',' << s.elo << '\n';
+        }
+        return true;
+    }
+
+private:
+    struct EloGreater {
+        const std::vector<VariantStats>& stats;
+        explicit EloGreater(const std::vector<VariantStats>& s) : stats(s) {}
+        bool operator()(size_t a, size_t b) const { return stats[a].elo > stats[b].elo; }
+    };
+
+    void aggregate(const std::vector<BatchMatchResult>& results) {
+        const double K = 16.0;
+        stats.assign(variants.size(), VariantStats());
+        totalTicks = 0;
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const BatchMatchResult& r = results[i];
+            VariantStats& a = stats[r.left];
+            VariantStats& b = stats[r.right];
+            totalTicks += r.ticks;
+
+            a.played++;
+            b.played++;
+            a.rallies += r.rallies;
+            b.rallies += r.rallies;
+            a.rallyHits += r.rallyHits;
+            b.rallyHits += r.rallyHits;
+
+            double scoreA;
+            if (r.scoreLeft > r.scoreRight) {
+                a.wins++;
+                b.losses++;
+                scoreA = 1.0;
+            } else if (r.scoreLeft < r.scoreRight) {
+                a.losses++;
+                b.wins++;
+                scoreA = 0.0;
+            } else {
+                a.draws++;
+                b.draws++;
+                scoreA = 0.5;
+            }
+
+            double expectedA = 1.0 / (1.0 + std::pow(10.0, (b.elo - a.elo) / 400.0));
+            a.elo += K * (scoreA - expectedA);
+            b.elo -= K * (scoreA - expectedA);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,245 @@
+// Banco de pruebas de rendimiento (make bench).
+// Mide los caminos calientes del juego: física de la pelota, IA de las paletas, un tick
+// completo de la partida y el render del juego y del menú sobre un renderer por software
+// sin ventana. Cada prueba se calienta, se repite varias veces y se informa la mediana en
+// ns/op; los resultados se guardan en CSV para comparar compilaciones.
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "pong_core.h"
+#include "game.h"
+
+struct BenchConfig {
+    int repetitions;
+    int warmup;
+    double scale;         // Multiplica las operaciones por repetición
+    std::string filter;   // Solo las pruebas cuyo nombre contiene este texto
+    std::string outPath;
+
+    BenchConfig() : repetitions(10), warmup(2), scale(1.0), outPath("bench_results.csv") {}
+};
+
+struct BenchResult {
+    std::string name;
+    long opsPerRep;
+    int repetitions;
+    double nsMedian, nsMin, nsMax;
+
+    double opsPerSecond() const {
+        return nsMedian > 0.0 ? 1e9 / nsMedian : 0.0;
+    }
+};
+
+// Evita que el compilador elimine el trabajo medido
+static volatile float benchSink;
+
+class BenchSuite {
+private:
+    BenchConfig config;
+    std::vector<BenchResult> results;
+
+public:
+    explicit BenchSuite(const BenchConfig& benchConfig) : config(benchConfig) {}
+
+    // fn(n) ejecuta la operación n veces
+    template <typename Fn>
+    void run(const char* name, long baseOps, Fn fn) {
+        if (!config.filter.empty() && std::string(name).find(config.filter) == std::string::npos) {
+            return;
+        }
+        long ops = std::max(1L, (long)(baseOps * config.scale));
+
+        for (int i = 0; i < config.warmup; i++) {
+            fn(ops);
+        }
+
+        std::vector<double> nsPerOp;
+        for (int i = 0; i < config.repetitions; i++) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            fn(ops);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            nsPerOp.push_back(ns / ops);
+        }
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+
+        BenchResult result;
+        result.name = name;
+        result.opsPerRep = ops;
+        result.repetitions = config.repetitions;
+        result.nsMedian = nsPerOp[nsPerOp.size() / 2];
+        result.nsMin = nsPerOp.front();
+        result.nsMax = nsPerOp.back();
+        results.push_back(result);
+
+        printf("%-24s %12.1f ns/op %14.0f ops/s  (mín %.1f, máx %.1f)\n", name,
+               result.nsMedian, result.opsPerSecond(), result.nsMin, result.nsMax);
+    }
+
+    bool writeCSV() const {
+        std::ofstream out(config.outPath.c_str());
+        if (!out) {
+            std::cout << "Error escribiendo " << config.outPath << std::endl;
+            return false;
+        }
+        out << "benchmark,ops_per_rep,repetitions,ns_per_op_median,ns_per_op_min,ns_per_op_max,ops_per_sec,compiler\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            out << r.name << ',' << r.opsPerRep << ',' << r.repetitions << ','
+                << r.nsMedian << ',' << r.nsMin << ',' << r.nsMax << ',' << r.opsPerSecond()
+                << ",\"" << __VERSION__ << "\"\n";
+        }
+        std::cout << "Resultados guardados en " << config.outPath << std::endl;
+        return true;
+    }
+};
+
+// Estados de pelota de una partida real, para alimentar la IA sin medir la física
+static std::vector<Ball> recordBallStates(size_t count) {
+    Match match;
+    match.player1.isAI = true;
+    std::vector<Ball> states;
+    states.reserve(count);
+    PaddleInput none(false, false);
+    for (size_t i = 0; i < count; i++) {
+        match.step(physicsDelta(DEFAULT_TICK_RATE), none, none);
+        states.push_back(match.ball);
+    }
+    return states;
+}
+
+static void runSimulationBenchmarks(BenchSuite& suite) {
+    const PhysicsReal dt = physicsDelta(DEFAULT_TICK_RATE);
+
+    suite.run("ball_update_collision", 2000000, [dt](long ops) {
+        Match match; // Solo para tener las paletas en su sitio
+        Ball ball;
+        for (long i = 0; i < ops; i++) {
+            ball.update(dt);
+            ball.checkCollision(match.player1);
+            ball.checkCollision(match.player2);
+            if (ball.x < 0 || ball.x > WINDOW_WIDTH) {
+                ball.reset();
+            }
+        }
+        benchSink = realToFloat(ball.x + ball.y);
+    });
+
+    const std::vector<Ball> states = recordBallStates(4096);
+
+    suite.run("paddle_ai_chase", 2000000, [dt, &states](long ops) {
+        Match match;
+        Paddle& paddle = match.player2;
+        for (long i = 0; i < ops; i++) {
+            const Ball& ball = states[i & 4095];
+            paddle.updateAI(dt, ball.y + BALL_SIZE / 2, ball.velocityX);
+        }
+        benchSink = realToFloat(paddle.y);
+    });
+
+    suite.run("paddle_ai_predict", 2000000, [dt, &states](long ops) {
+        Match match;
+        Paddle& paddle = match.player2;
+        paddle.ai.mode = AI_PREDICT;
+        for (long i = 0; i < ops; i++) {
+            const Ball& ball = states[i & 4095];
+            paddle.updatePredictiveAI(dt, ball.x, ball.y, ball.velocityX, ball.velocityY);
+        }
+        benchSink = realToFloat(paddle.y);
+    });
+
+    suite.run("match_step", 1000000, [dt](long ops) {
+        Match match;
+        PaddleInput none(false, false);
+        for (long i = 0; i < ops; i++) {
+            match.step(dt, none, none);
+        }
+        benchSink = realToFloat(match.ball.x) + match.score1 + match.score2;
+    });
+}
+
+static bool runGameBenchmarks(BenchSuite& suite) {
+    // Renderer por software sobre una superficie en memoria: sin ventana ni GPU
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        std::cout << "Error creando la superficie: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_Renderer* renderer = SDL_CreateSoftwareRenderer(surface);
+    if (!renderer) {
+        std::cout << "Error creando el renderer por software: " << SDL_GetError() << std::endl;
+        SDL_FreeSurface(surface);
+        return false;
+    }
+
+    Game game;
+    game.attachRenderer(renderer);
+    const PaddleInput none(false, false);
+    const PhysicsReal dt = physicsDelta(game.getTickRate());
+
+    // simulateTick anuncia cada punto por consola: silenciarla mientras se mide
+    std::cout.setstate(std::ios::failbit);
+    game.startMode(SINGLE_PLAYER);
+    suite.run("game_tick", 500000, [&game, &none, dt](long ops) {
+        for (long i = 0; i < ops; i++) {
+            game.simulateTick(dt, none, none);
+        }
+    });
+    std::cout.clear();
+
+    suite.run("render_game", 2000, [&game](long ops) {
+        for (long i = 0; i < ops; i++) {
+            game.render();
+        }
+    });
+
+    game.returnToMenu();
+    suite.run("render_menu", 2000, [&game](long ops) {
+        for (long i = 0; i < ops; i++) {
+            game.render();
+        }
+    });
+
+    game.cleanup(); // Destruye el renderer
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            config.repetitions = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            config.warmup = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            config.scale = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            config.filter = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            config.outPath = argv[++i];
+        } else {
+            std::cout << "Opción desconocida: " << argv[i] << std::endl;
+            std::cout << "Uso: pong_bench [--reps N] [--warmup N] [--scale F] [--filter texto] [--out archivo.csv]" << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "=== Banco de pruebas (" << config.repetitions << " repeticiones, "
+              << config.warmup << " de calentamiento) ===" << std::endl;
+
+    BenchSuite suite(config);
+    runSimulationBenchmarks(suite);
+    if (!runGameBenchmarks(suite)) {
+        std::cout << "Se omiten las pruebas del juego y del render" << std::endl;
+    }
+    return suite.writeCSV() ? 0 : -1;
+}
@@ -0,0 +1,459 @@
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+// Emisión de partidas en directo para espectadores.
+// Cada tick se cuantiza el estado visible (pelota, velocidad, paletas y marcador) a enteros
+// y se envía solo lo que cambió respecto al tick anterior, como diferencias pequeñas en
+// varint: un tick normal ocupa unos 8 bytes. El estado completo (keyframe) solo se envía
+// cuando la pelota vuelve al centro (Ball::reset() tras un punto o una partida nueva) o
+// cuando llega un espectador nuevo.
+//
+// El paquete de cada tick se codifica una sola vez y se envía igual a todos los
+// espectadores por sockets locales (AF_UNIX de datagramas, que no pierden ni desordenan
+// paquetes). Si un espectador no lee a tiempo y se descarta un paquete, ve el salto en la
+// secuencia y vuelve a suscribirse, lo que provoca un keyframe para todos.
+// Solo POSIX.
+
+#include "pong_core.h"
+#include "replay.h"
+#include "net.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+const uint16_t BROADCAST_MAGIC = 0x5042;
+const int BROADCAST_POSITION_SCALE = 8;   // Posiciones y velocidades en 1/8 de píxel
+const int BROADCAST_FIELDS = 8;
+const size_t BROADCAST_MAX_PACKET = 3 + 2 + 2 + BROADCAST_FIELDS * 5;
+const size_t SPECTATOR_MAX_BUFFER = 4;    // Ticks pendientes antes de descartar los más antiguos
+
+enum BroadcastPacketType {
+    BROADCAST_KEYFRAME = 1,     // Estado completo y ticks por segundo
+    BROADCAST_DELTA = 2,        // Máscara de campos cambiados y sus diferencias
+    BROADCAST_SUBSCRIBE = 3,    // Espectador → emisor: alta o petición de keyframe
+    BROADCAST_UNSUBSCRIBE = 4
+};
+
+// Estado visible cuantizado: pelota x, y, vx, vy; paleta 1 y 2; marcador 1 y 2
+struct BroadcastSnapshot {
+    int32_t fields[BROADCAST_FIELDS];
+    bool keyframe;  // La pelota se ha teletransportado: no interpolar desde el anterior
+
+    BroadcastSnapshot() : keyframe(false) {
+        memset(fields, 0, sizeof(fields));
+    }
+
+    static int32_t quantize(float value) {
+        return (int32_t)std::lround(value * BROADCAST_POSITION_SCALE);
+    }
+
+    static float dequantize(int32_t value) {
+        return (float)value / BROADCAST_POSITION_SCALE;
+    }
+
+    static BroadcastSnapshot fromMatch(const Match& match) {
+        BroadcastSnapshot snapshot;
+        snapshot.fields[0] = quantize(realToFloat(match.ball.x));
+        snapshot.fields[1] = quantize(realToFloat(match.ball.y));
+        snapshot.fields[2] = quantize(realToFloat(match.ball.velocityX));
+        snapshot.fields[3] = quantize(realToFloat(match.ball.velocityY));
+        snapshot.fields[4] = quantize(realToFloat(match.player1.y));
+        snapshot.fields[5] = quantize(realToFloat(match.player2.y));
+        snapshot.fields[6] = match.score1;
+        snapshot.fields[7] = match.score2;
+        return snapshot;
+    }
+
+    // Solo el estado visible: el resto de Match no se toca
+    void applyTo(Match& match) const {
+        match.ball.x = PhysicsReal(dequantize(fields[0]));
+        match.ball.y = PhysicsReal(dequantize(fields[1]));
+        match.ball.velocityX = PhysicsReal(dequantize(fields[2]));
+        match.ball.velocityY = PhysicsReal(dequantize(fields[3]));
+        match.player1.y = PhysicsReal(dequantize(fields[4]));
+        match.player2.y = PhysicsReal(dequantize(fields[5]));
+        match.score1 = fields[6];
+        match.score2 = fields[7];
+    }
+};
+
+// Enteros con signo en varint zigzag: las diferencias pequeñas ocupan un byte
+inline void putVarint(uint8_t*& out, int32_t value) {
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    while (zigzag >= 0x80) {
+        *out++ = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *out++ = (uint8_t)zigzag;
+}
+
+inline bool getVarint(const uint8_t*& in, const uint8_t* end, int32_t& value) {
+    uint32_t zigzag = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (in >= end) return false;
+        uint8_t byte = *in++;
+        zigzag |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool makeUnixAddress(const std::string& path, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Ruta de socket demasiado larga: " << path << std::endl;
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+// Borra un socket que quedó de una ejecución anterior. La ruta la da el usuario: si hay otra
+// cosa (un archivo normal, un directorio...) no se toca y se devuelve false
+inline bool removeStaleSocket(const std::string& path) {
+    struct stat info;
+    if (lstat(path.c_str(), &info) != 0) {
+        if (errno == ENOENT) return true;
+        std::cout << "Error comprobando " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        std::cout << path << " ya existe y no es un socket; no se sobrescribe" << std::endl;
+        return false;
+    }
+    unlink(path.c_str());
+    return true;
+}
+
+// Emisor: un solo codificador y la lista de espectadores
+class Broadcaster {
+public:
+    Broadcaster() : fd(-1), tickRate(DEFAULT_TICK_RATE), sequence(0), hasPrevious(false), keyframePending(true),
+                    keyframes(0), deltas(0), deltaBytes(0), sends(0), dropped(0), peakSubscribers(0) {}
+
+    ~Broadcaster() {
+        close();
+    }
+
+    bool open(const std::string& socketPath, int rate) {
+        sockaddr_un address;
+        if (!makeUnixAddress(socketPath, address)) return false;
+        if (!removeStaleSocket(socketPath)) return false; // Restos de una emisión anterior
+        fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            std::cout << "Error creando el socket de emisión: " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (bind(fd, (const sockaddr*)&address, sizeof(address)) != 0) {
+            std::cout << "Error abriendo " << socketPath << ": " << strerror(errno) << std::endl;
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        path = socketPath;
+        tickRate = rate;
+        std::cout << "Emitiendo en " << path << " (./pong --spectate " << path << ")" << std::endl;
+        return true;
+    }
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    void setTickRate(int rate) {
+        if (rate != tickRate) {
+            tickRate = rate;
+            keyframePending = true; // Los espectadores leen la frecuencia del keyframe
+        }
+    }
+
+    // El siguiente tick sale completo (partida nueva, salto en una repetición)
+    void requestKeyframe() {
+        keyframePending = true;
+    }
+
+    // Llamar después de cada tick simulado
+    void publish(const Match& match) {
+        if (fd < 0) return;
+        pollSubscribers();
+
+        BroadcastSnapshot snapshot = BroadcastSnapshot::fromMatch(match);
+        // Un cambio de marcador es un punto: la pelota ha vuelto al centro con Ball::reset()
+        bool keyframe = keyframePending || !hasPrevious ||
+                        snapshot.fields[6] != previous.fields[6] || snapshot.fields[7] != previous.fields[7];
+        uint8_t packet[BROADCAST_MAX_PACKET];
+        size_t size = keyframe ? encodeKeyframe(packet, snapshot) : encodeDelta(packet, snapshot);
+        previous = snapshot;
+        hasPrevious = true;
+        keyframePending = false;
+        if (keyframe) {
+            keyframes++;
+        } else {
+            deltas++;
+            deltaBytes += size;
+        }
+
+        // El mismo paquete para todos; sin espectadores solo se mantiene el estado
+        for (size_t i = 0; i < subscribers.size();) {
+            ssize_t sent = sendto(fd, packet, size, 0, (const sockaddr*)&subscribers[i], sizeof(sockaddr_un));
+            if (sent == (ssize_t)size) {
+                sends++;
+                i++;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                dropped++; // Espectador lento: verá el salto y pedirá un keyframe
+                i++;
+            } else {
+                subscribers.erase(subscribers.begin() + i); // Ya no existe
+            }
+        }
+    }
+
+    void close() {
+        if (fd < 0) return;
+        ::close(fd);
+        fd = -1;
+        removeStaleSocket(path);
+    }
+
+    void printReport() const {
+        if (keyframes + deltas == 0) return;
+        std::cout << "=== Emisión ===" << std::endl;
+        std::cout << "Espectadores: " << subscribers.size() << " (máximo " << peakSubscribers << ")  Envíos: "
+                  << sends << "  descartados: " << dropped << std::endl;
+        std::cout << "Paquetes: " << keyframes << " keyframes, " << deltas << " deltas";
+        if (deltas > 0) {
+            char line[96];
+            snprintf(line, sizeof(line), " de %.1f bytes de media (keyframe %d bytes, estado en float %d bytes)",
+                     (double)deltaBytes / deltas, (int)keyframeSize(), (int)(3 + 2 + 6 * 4 + 2));
+            std::cout << line;
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    int fd;
+    std::string path;
+    int tickRate;
+    uint16_t sequence;
+    BroadcastSnapshot previous;
+    bool hasPrevious;
+    bool keyframePending;
+    std::vector<sockaddr_un> subscribers;
+    uint64_t keyframes, deltas, deltaBytes, sends, dropped;
+    size_t peakSubscribers;
+
+    void pollSubscribers() {
+        uint8_t buffer[16];
+        while (true) {
+            sockaddr_un from;
+            socklen_t fromSize = sizeof(from);
+            ssize_t size = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr*)&from, &fromSize);
+            if (size < 0) break;
+            const uint8_t* in = buffer;
+            if (size < 3 || getU16(in) != BROADCAST_MAGIC || fromSize <= sizeof(sa_family_t)) continue;
+            uint8_t type = *in;
+            std::vector<sockaddr_un>::iterator found = subscribers.begin();
+            while (found != subscribers.end() && strcmp(found->sun_path, from.sun_path) != 0) ++found;
+            if (type == BROADCAST_SUBSCRIBE) {
+                if (found == subscribers.end()) {
+                    memset((char*)&from + fromSize, 0, sizeof(from) - fromSize);
+                    subscribers.push_back(from);
+                    peakSubscribers = std::max(peakSubscribers, subscribers.size());
+                }
+                keyframePending = true; // Espectador nuevo o que perdió un paquete
+            } else if (type == BROADCAST_UNSUBSCRIBE && found != subscribers.end()) {
+                subscribers.erase(found);
+            }
+        }
+    }
+
+    size_t keyframeSize() const {
+        uint8_t packet[BROADCAST_MAX_PACKET];
+        return encodeKeyframe(packet, previous);
+    }
+
+    size_t encodeKeyframe(uint8_t* packet, const BroadcastSnapshot& snapshot) const {
+        uint8_t* out = packet;
+        putU16(out, BROADCAST_MAGIC);
+        *out++ = BROADCAST_KEYFRAME;
+        putU16(out, sequence);
+        putU16(out, (uint16_t)tickRate);
+        for (int i = 0; i < BROADCAST_FIELDS; i++) putVarint(out, snapshot.fields[i]);
+        return out - packet;
+    }
+
+    size_t encodeDelta(uint8_t* packet, const BroadcastSnapshot& snapshot) {
+        uint8_t* out = packet;
+        putU16(out, BROADCAST_MAGIC);
+        *out++ = BROADCAST_DELTA;
+        putU16(out, ++sequence);
+        uint8_t* mask = out++;
+        *mask = 0;
+        for (int i = 0; i < BROADCAST_FIELDS; i++) {
+            if (snapshot.fields[i] != previous.fields[i]) {
+                *mask |= (uint8_t)(1 << i);
+                putVarint(out, snapshot.fields[i] - previous.fields[i]);
+            }
+        }
+        return out - packet;
+    }
+};
+
+// Espectador: se suscribe a una emisión y reconstruye el estado de cada tick
+class SpectatorClient {
+public:
+    SpectatorClient() : fd(-1), tickRate(DEFAULT_TICK_RATE), expected(0), synced(false), lastSubscribeMs(0),
+                        received(0), resyncs(0) {}
+
+    ~SpectatorClient() {
+        close();
+    }
+
+    bool open(const std::string& broadcastPath) {
+        if (!makeUnixAddress(broadcastPath, server)) return false;
+        static int opened = 0;
+        char localPath[64];
+        snprintf(localPath, sizeof(localPath), "/tmp/pong-espectador-%d-%d.sock", (int)getpid(), ++opened);
+        sockaddr_un local;
+        makeUnixAddress(localPath, local);
+        if (!removeStaleSocket(localPath)) return false;
+        fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (fd < 0 || bind(fd, (const sockaddr*)&local, sizeof(local)) != 0) {
+            std::cout << "Error creando el socket del espectador: " << strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        path = localPath;
+        subscribe();
+        return true;
+    }
+
+    bool isOpen() const {
+        return fd >= 0;
+    }
+
+    // Hay estado: se recibió al menos un keyframe
+    bool isSynced() const {
+        return synced;
+    }
+
+    int getTickRate() const {
+        return tickRate;
+    }
+
+    // Añade a out los ticks recibidos desde la última llamada
+    void poll(std::deque<BroadcastSnapshot>& out) {
+        if (fd < 0) return;
+        uint8_t buffer[BROADCAST_MAX_PACKET];
+        ssize_t size;
+        while ((size = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            decode(buffer, (size_t)size, out);
+        }
+        // Sin keyframe todavía: la emisión no estaba abierta o se perdió la suscripción
+        uint32_t now = netTimeMs();
+        if (!synced && now - lastSubscribeMs > 1000) {
+            subscribe();
+        }
+    }
+
+    void close() {
+        if (fd < 0) return;
+        uint8_t packet[3];
+        uint8_t* out = packet;
+        putU16(out, BROADCAST_MAGIC);
+        *out++ = BROADCAST_UNSUBSCRIBE;
+        sendto(fd, packet, sizeof(packet), 0, (const sockaddr*)&server, sizeof(server));
+        ::close(fd);
+        fd = -1;
+        removeStaleSocket(path);
+        synced = false;
+    }
+
+    void printReport() const {
+        if (received == 0) return;
+        std::cout << "=== Espectador ===" << std::endl;
+        std::cout << "Ticks recibidos: " << received << "  Resincronizaciones: " << resyncs << std::endl;
+    }
+
+private:
+    int fd;
+    sockaddr_un server;
+    std::string path;
+    int tickRate;
+    uint16_t expected;
+    bool synced;
+    BroadcastSnapshot current;
+    uint32_t lastSubscribeMs;
+    uint64_t received, resyncs;
+
+    void subscribe() {
+        uint8_t packet[3];
+        uint8_t* out = packet;
+        putU16(out, BROADCAST_MAGIC);
+        *out++ = BROADCAST_SUBSCRIBE;
+        sendto(fd, packet, sizeof(packet), 0, (const sockaddr*)&server, sizeof(server));
+        lastSubscribeMs = netTimeMs();
+    }
+
+    void decode(const uint8_t* data, size_t size, std::deque<BroadcastSnapshot>& out) {
+        const uint8_t* in = data;
+        const uint8_t* end = data + size;
+        if (size < 5 || getU16(in) != BROADCAST_MAGIC) return;
+        uint8_t type = *in++;
+        uint16_t sequence = getU16(in);
+
+        if (type == BROADCAST_KEYFRAME && size >= 7) {
+            tickRate = getU16(in);
+            BroadcastSnapshot snapshot;
+            for (int i = 0; i < BROADCAST_FIELDS; i++) {
+                if (!getVarint(in, end, snapshot.fields[i])) return;
+            }
+            snapshot.keyframe = true;
+            current = snapshot;
+            expected = sequence + 1;
+            synced = true;
+        } else if (type == BROADCAST_DELTA && synced && size >= 6) {
+            if (sequence != expected) {
+                // Se perdió un paquete: los deltas siguientes no sirven hasta otro keyframe
+                synced = false;
+                resyncs++;
+                subscribe();
+                return;
+            }
+            uint8_t mask = *in++;
+            BroadcastSnapshot snapshot = current;
+            snapshot.keyframe = false;
+            for (int i = 0; i < BROADCAST_FIELDS; i++) {
+                int32_t delta;
+                if (!(mask & (1 << i))) continue;
+                if (!getVarint(in, end, delta)) return;
+                snapshot.fields[i] += delta;
+            }
+            current = snapshot;
+            expected++;
+        } else {
+            return;
+        }
+        received++;
+        out.push_back(current);
+    }
+};
+
+#endif
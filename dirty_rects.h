@@ -0,0 +1,163 @@
+#ifndef DIRTY_RECTS_H
+#define DIRTY_RECTS_H
+
+// Regiones a redibujar en cada frame con el renderer por software (redibujado parcial).
+// Sin GPU, limpiar y repintar los 800x600 píxeles cada frame es casi todo el coste del
+// frame, aunque solo se muevan la pelota y las paletas. El juego apunta aquí los sprites
+// (pelota, paletas) y las zonas que cambian (el HUD al cambiar el marcador); al cerrar el
+// frame se suman los sprites del frame anterior (hay que borrarlos donde estaban), se
+// fusionan los rectángulos cercanos y, si el área total es grande, se redibuja todo.
+
+#include <SDL2/SDL.h>
+#include <iostream>
+
+// Cuándo usar el redibujado parcial (--redraw)
+enum RedrawMode {
+    REDRAW_AUTO,  // Solo si no hay renderer acelerado
+    REDRAW_FULL,  // Siempre limpiar y repintar todo (el renderer que dé SDL)
+    REDRAW_DIRTY  // Forzar el renderer por software con redibujado parcial
+};
+
+const int MAX_DIRTY_RECTS = 16;                // Más rectángulos: redibujado completo
+const float DIRTY_FULL_REDRAW_FRACTION = 0.4f; // Fracción de la pantalla a partir de la que se redibuja todo
+const int DIRTY_MERGE_SLACK = 1024;            // Píxeles de más que se aceptan al fusionar dos rectángulos
+
+class DirtyRegion {
+public:
+    DirtyRegion() : width(0), height(0), spriteCount(0), previousCount(0), count(0), full(true), fullNext(true),
+                    fullFrames(0), partialFrames(0), idleFrames(0), partialPixels(0) {}
+
+    void init(int screenWidth, int screenHeight) {
+        width = screenWidth;
+        height = screenHeight;
+        invalidate();
+    }
+
+    // El siguiente frame se redibuja entero (cambio de modo, ventana expuesta, capa nueva...)
+    void invalidate() {
+        fullNext = true;
+    }
+
+    // Algo que se dibuja cada frame en una posición que cambia: también se repinta en el
+    // frame siguiente para borrarlo
+    void addSprite(const SDL_Rect& rect) {
+        if (spriteCount < MAX_DIRTY_RECTS) {
+            sprites[spriteCount++] = rect;
+        } else {
+            fullNext = true;
+        }
+        add(rect);
+    }
+
+    // Zona que cambia solo en este frame
+    void addArea(const SDL_Rect& rect) {
+        add(rect);
+    }
+
+    // Cierra el frame: decide entre redibujado parcial (getRects) o completo
+    void finish() {
+        for (int i = 0; i < previousCount; i++) {
+            add(previous[i]);
+        }
+        mergeOverlapping();
+
+        long area = 0;
+        for (int i = 0; i < count; i++) {
+            area += (long)rects[i].w * rects[i].h;
+        }
+        full = fullNext || area > (long)(DIRTY_FULL_REDRAW_FRACTION * width * height);
+        if (full) {
+            fullFrames++;
+        } else if (count == 0) {
+            idleFrames++;
+        } else {
+            partialFrames++;
+            partialPixels += area;
+        }
+
+        for (int i = 0; i < spriteCount; i++) {
+            previous[i] = sprites[i];
+        }
+        previousCount = spriteCount;
+        spriteCount = 0;
+        fullNext = false;
+    }
+
+    bool isFullRedraw() const {
+        return full;
+    }
+
+    // Rectángulos del frame cerrado (sin solapes grandes y recortados a la pantalla)
+    const SDL_Rect* getRects() const {
+        return rects;
+    }
+
+    int getCount() const {
+        return full ? 0 : count;
+    }
+
+    // Prepara el siguiente frame (llamar antes de apuntar nada)
+    void beginFrame() {
+        count = 0;
+    }
+
+    void printReport() const {
+        long frames = fullFrames + partialFrames + idleFrames;
+        if (frames == 0) return;
+        std::cout << "=== Redibujado parcial ===" << std::endl;
+        std::cout << "Frames parciales: " << partialFrames << "  completos: " << fullFrames
+                  << "  sin cambios: " << idleFrames << std::endl;
+        if (partialFrames > 0) {
+            std::cout << "Píxeles por frame parcial: " << partialPixels / partialFrames << " ("
+                      << 100.0 * partialPixels / partialFrames / ((double)width * height) << "% de la pantalla)" << std::endl;
+        }
+    }
+
+private:
+    int width, height;
+    SDL_Rect sprites[MAX_DIRTY_RECTS];  // Sprites de este frame
+    SDL_Rect previous[MAX_DIRTY_RECTS]; // Sprites del frame anterior
+    int spriteCount, previousCount;
+    SDL_Rect rects[MAX_DIRTY_RECTS * 2];
+    int count;
+    bool full, fullNext;
+    long fullFrames, partialFrames, idleFrames;
+    long partialPixels;
+
+    void add(SDL_Rect rect) {
+        SDL_Rect screen = {0, 0, width, height};
+        SDL_Rect clipped;
+        if (!SDL_IntersectRect(&rect, &screen, &clipped)) {
+            return;
+        }
+        if (count < MAX_DIRTY_RECTS * 2) {
+            rects[count++] = clipped;
+        } else {
+            fullNext = true;
+        }
+    }
+
+    // Fusiona pares cuyo rectángulo envolvente apenas añade área (una paleta y su posición
+    // anterior, por ejemplo) hasta que no quede ninguno
+    void mergeOverlapping() {
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (int i = 0; i < count && !merged; i++) {
+                for (int j = i + 1; j < count; j++) {
+                    SDL_Rect both;
+                    SDL_UnionRect(&rects[i], &rects[j], &both);
+                    long separate = (long)rects[i].w * rects[i].h + (long)rects[j].w * rects[j].h;
+                    if ((long)both.w * both.h <= separate + DIRTY_MERGE_SLACK) {
+                        rects[i] = both;
+                        rects[j] = rects[--count];
+                        merged = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef DRAW_BATCH_H
+#define DRAW_BATCH_H
+
+// Buffer de comandos de dibujo por frame.
+// El código de render usa setColor()/fillRect()/drawRect() igual que con SDL, pero los
+// rectángulos se acumulan en lotes por estado (color, modo de mezcla, relleno/contorno) y
+// flush() los emite con un SDL_RenderFillRects/SDL_RenderDrawRects por lote.
+//
+// Orden de dibujo: un rectángulo nuevo se une al lote más reciente con su mismo estado
+// solo si no se solapa con ningún lote posterior a ese; si se solapa, abre un lote nuevo
+// al final. Así solo se reordena lo que no se pisa y el resultado en pantalla es idéntico.
+//
+// También acepta copias de texturas teñidas con el color actual (glifos de texto): las de
+// una misma textura forman un lote que se emite con un solo SDL_RenderGeometry.
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+class DrawBatch {
+public:
+    DrawBatch() : commandCount(0), lastCommandCount(0), lastDrawCalls(0), batchCount(0) {
+        current.r = current.g = current.b = 0;
+        current.a = 255;
+        currentBlend = SDL_BLENDMODE_NONE;
+    }
+
+    void setColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255) {
+        current.r = r;
+        current.g = g;
+        current.b = b;
+        current.a = a;
+    }
+
+    void setBlendMode(SDL_BlendMode mode) {
+        currentBlend = mode;
+    }
+
+    void fillRect(const SDL_Rect& rect) {
+        add(rect, false);
+    }
+
+    void drawRect(const SDL_Rect& rect) {
+        add(rect, true);
+    }
+
+    void fillRects(const SDL_Rect* rects, int count) {
+        for (int i = 0; i < count; i++) add(rects[i], false);
+    }
+
+    // Copia src de la textura a dst, teñida con el color actual (mezcla según la textura)
+    void drawTexture(SDL_Texture* texture, const SDL_Rect& src, const SDL_Rect& dst) {
+        add(dst, false, texture, &src);
+    }
+
+    SDL_Color getColor() const {
+        return current;
+    }
+
+    // Emite todos los lotes y vacía el buffer (los lotes se reutilizan entre frames)
+    void flush(SDL_Renderer* renderer) {
+        int calls = 0;
+        for (size_t i = 0; i < batchCount; i++) {
+            const Batch& batch = batches[i];
+            if (batch.texture) {
+                flushTextured(renderer, batch);
+                calls++;
+                continue;
+            }
+            SDL_SetRenderDrawBlendMode(renderer, batch.blend);
+            SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+            if (batch.outline) {
+                SDL_RenderDrawRects(renderer, &batch.rects[0], (int)batch.rects.size());
+            } else {
+                SDL_RenderFillRects(renderer, &batch.rects[0], (int)batch.rects.size());
+            }
+            calls++;
+        }
+        lastCommandCount = commandCount;
+        lastDrawCalls = calls;
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i < batchCount; i++) {
+            batches[i].rects.clear();
+            batches[i].sources.clear();
+            batches[i].tints.clear();
+        }
+        batchCount = 0;
+        commandCount = 0;
+    }
+
+    int getLastCommandCount() const {
+        return lastCommandCount;
+    }
+
+    int getLastDrawCalls() const {
+        return lastDrawCalls;
+    }
+
+private:
+    struct Batch {
+        SDL_Color color;
+        SDL_BlendMode blend;
+        bool outline;
+        SDL_Rect bounds;
+        std::vector<SDL_Rect> rects;
+        SDL_Texture* texture;            // nullptr en los lotes de rectángulos
+        std::vector<SDL_Rect> sources;   // Rectángulos origen en la textura
+        std::vector<SDL_Color> tints;    // Color de cada copia
+    };
+
+    std::vector<Batch> batches;
+    std::vector<SDL_Vertex> vertices;    // Reutilizados entre flushes
+    std::vector<int> indices;
+    SDL_Color current;
+    SDL_BlendMode currentBlend;
+    int commandCount;
+    int lastCommandCount;
+    int lastDrawCalls;
+    size_t batchCount;
+
+    bool sameState(const Batch& batch, bool outline, SDL_Texture* texture) const {
+        if (batch.texture || texture) {
+            return batch.texture == texture; // El color va en cada vértice
+        }
+        return batch.outline == outline && batch.blend == currentBlend &&
+               batch.color.r == current.r && batch.color.g == current.g &&
+               batch.color.b == current.b && batch.color.a == current.a;
+    }
+
+    static bool overlaps(const SDL_Rect& a, const SDL_Rect& b) {
+        return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+
+    static bool overlapsBatch(const Batch& batch, const SDL_Rect& rect) {
+        if (!overlaps(batch.bounds, rect)) return false;
+        for (size_t i = 0; i < batch.rects.size(); i++) {
+            if (overlaps(batch.rects[i], rect)) return true;
+        }
+        return false;
+    }
+
+    void add(const SDL_Rect& rect, bool outline, SDL_Texture* texture = nullptr, const SDL_Rect* source = nullptr) {
+        if (rect.w <= 0 || rect.h <= 0) return;
+        commandCount++;
+
+        // Buscar hacia atrás un lote compatible sin cruzar ningún lote que se solape
+        for (size_t i = batchCount; i-- > 0;) {
+            Batch& batch = batches[i];
+            if (sameState(batch, outline, texture)) {
+                batch.rects.push_back(rect);
+                if (texture) {
+                    batch.sources.push_back(*source);
+                    batch.tints.push_back(current);
+                }
+                SDL_Rect merged;
+                SDL_UnionRect(&batch.bounds, &rect, &merged);
+                batch.bounds = merged;
+                return;
+            }
+            if (overlapsBatch(batch, rect)) {
+                break;
+            }
+        }
+
+        if (batchCount == batches.size()) {
+            batches.push_back(Batch());
+        }
+        Batch& batch = batches[batchCount++];
+        batch.color = current;
+        batch.blend = currentBlend;
+        batch.outline = outline;
+        batch.bounds = rect;
+        batch.rects.push_back(rect);
+        batch.texture = texture;
+        if (texture) {
+            batch.sources.push_back(*source);
+            batch.tints.push_back(current);
+        }
+    }
+
+    void flushTextured(SDL_Renderer* renderer, const Batch& batch) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        int texW = 1, texH = 1;
+        SDL_QueryTexture(batch.texture, nullptr, nullptr, &texW, &texH);
+        float invW = 1.0f / texW;
+        float invH = 1.0f / texH;
+
+        vertices.resize(batch.rects.size() * 4);
+        indices.resize(batch.rects.size() * 6);
+        for (size_t i = 0; i < batch.rects.size(); i++) {
+            const SDL_Rect& dst = batch.rects[i];
+            const SDL_Rect& src = batch.sources[i];
+            float x0 = (float)dst.x, y0 = (float)dst.y;
+            float x1 = (float)(dst.x + dst.w), y1 = (float)(dst.y + dst.h);
+            float u0 = src.x * invW, v0 = src.y * invH;
+            float u1 = (src.x + src.w) * invW, v1 = (src.y + src.h) * invH;
+
+            SDL_Vertex* v = &vertices[i * 4];
+            v[0].position.x = x0; v[0].position.y = y0; v[0].tex_coord.x = u0; v[0].tex_coord.y = v0;
+            v[1].position.x = x1; v[1].position.y = y0; v[1].tex_coord.x = u1; v[1].tex_coord.y = v0;
+            v[2].position.x = x1; v[2].position.y = y1; v[2].tex_coord.x = u1; v[2].tex_coord.y = v1;
+            v[3].position.x = x0; v[3].position.y = y1; v[3].tex_coord.x = u0; v[3].tex_coord.y = v1;
+            for (int k = 0; k < 4; k++) v[k].color = batch.tints[i];
+
+            int* idx = &indices[i * 6];
+            int base = (int)(i * 4);
+            idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+        }
+        SDL_RenderGeometry(renderer, batch.texture, &vertices[0], (int)vertices.size(),
+                           &indices[0], (int)indices.size());
+#else
+        // SDL anterior a 2.0.18: sin geometría, una copia por rectángulo
+        for (size_t i = 0; i < batch.rects.size(); i++) {
+            const SDL_Color& tint = batch.tints[i];
+            SDL_SetTextureColorMod(batch.texture, tint.r, tint.g, tint.b);
+            SDL_SetTextureAlphaMod(batch.texture, tint.a);
+            SDL_RenderCopy(renderer, batch.texture, &batch.sources[i], &batch.rects[i]);
+        }
+#endif
+    }
+};
+
+#endif
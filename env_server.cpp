@@ -0,0 +1,196 @@
+// Entorno de aprendizaje por refuerzo (pong-env).
+// Sirve un VectorEnv por memoria compartida a un entrenador en otro proceso, o mide cuántos
+// pasos de entorno por segundo da en esta máquina.
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "shared_env.h"
+#include "vector_env.h"
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterrupt(int) {
+    interrupted = 1;
+}
+
+// Pasos con acciones aleatorias; si shmName no está vacío, a través de la memoria compartida
+// con el servidor en un proceso hijo (el mismo camino que un entrenador externo)
+static bool runBenchmark(const EnvConfig& config, long steps, const std::string& shmName, bool force) {
+    std::vector<uint8_t> localActions(config.numEnvs);
+    XorShift32 rng(config.seed);
+    uint8_t* actions = localActions.data();
+    const float* rewards = nullptr;
+    const uint8_t* dones = nullptr;
+    std::vector<float> observations, localRewards;
+    std::vector<uint8_t> frames, localDones;
+    EnvBuffers buffers;
+    VectorEnv* env = nullptr;
+    SharedEnvClient client;
+    pid_t server = -1;
+    unsigned threads = 1;
+    int frameWidth = 0, frameHeight = 0;
+
+    if (shmName.empty()) {
+        env = new VectorEnv(config);
+        observations.resize((size_t)config.numEnvs * ENV_OBSERVATION_SIZE);
+        frames.resize((size_t)config.numEnvs * env->getFrameSize());
+        localRewards.resize(config.numEnvs);
+        localDones.resize(config.numEnvs);
+        buffers.observations = observations.data();
+        buffers.frames = frames.empty() ? nullptr : frames.data();
+        buffers.rewards = localRewards.data();
+        buffers.dones = localDones.data();
+        rewards = buffers.rewards;
+        dones = buffers.dones;
+        threads = env->getThreadCount();
+        frameWidth = env->getFrameWidth();
+        frameHeight = env->getFrameHeight();
+        env->reset(buffers);
+    } else {
+        server = fork();
+        if (server == 0) {
+            // Hijo: servidor hasta que el padre lo cierre. _exit no llama a destructores, así
+            // que el segmento se borra al salir del bloque
+            bool served = false;
+            {
+                VectorEnv serverEnv(config);
+                SharedEnvServer shared(serverEnv);
+                if (shared.create(shmName, force)) {
+                    shared.serve(&interrupted);
+                    served = true;
+                }
+            }
+            _exit(served ? 0 : 1);
+        }
+        if (server < 0 || !client.attach(shmName) || !client.reset(5000)) {
+            std::cout << "No se pudo arrancar el servidor de memoria compartida" << std::endl;
+            if (server > 0) {
+                kill(server, SIGTERM);
+                waitpid(server, nullptr, 0);
+            }
+            return false;
+        }
+        actions = client.getActions();
+        rewards = client.getRewards();
+        dones = client.getDones();
+        threads = VectorEnv(config).getThreadCount();
+        frameWidth = client.getFrameWidth();
+        frameHeight = client.getFrameHeight();
+    }
+
+    double totalReward = 0.0;
+    long episodes = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long s = 0; s < steps && !interrupted; s++) {
+        for (int i = 0; i < config.numEnvs; i++) {
+            actions[i] = (uint8_t)(rng.next() % 3);
+        }
+        if (env) {
+            env->step(actions, buffers);
+        } else if (!client.step(5000)) {
+            std::cout << "El servidor no responde" << std::endl;
+            break;
+        }
+        for (int i = 0; i < config.numEnvs; i++) {
+            totalReward += rewards[i];
+            if (dones[i] != ENV_RUNNING) episodes++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "=== BENCHMARK DEL ENTORNO" << (env ? "" : " (memoria compartida)") << " ===" << std::endl;
+    std::cout << "Partidas: " << config.numEnvs << "  pasos: " << steps << "  ticks por paso: " << config.ticksPerStep
+              << "  hilos: " << threads;
+    if (frameWidth > 0) std::cout << "  imagen: " << frameWidth << "x" << frameHeight;
+    std::cout << std::endl;
+    double envSteps = (double)config.numEnvs * steps;
+    std::cout << "Pasos de entorno/s: " << (long long)(envSteps / seconds) << "  (" << (long long)(steps / seconds)
+              << " llamadas a step/s, " << seconds * 1e6 / steps << " us por llamada)" << std::endl;
+    std::cout << "Episodios terminados: " << episodes << "  recompensa media por paso: "
+              << totalReward / envSteps << std::endl;
+
+    if (env) {
+        delete env;
+    } else {
+        client.close();
+        client.detach();
+        waitpid(server, nullptr, 0);
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    EnvConfig config;
+    std::string shmName;
+    long benchSteps = 0;
+    bool force = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+            shmName = argv[++i];
+        } else if (strcmp(argv[i], "--envs") == 0 && i + 1 < argc) {
+            config.numEnvs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ticks-per-step") == 0 && i + 1 < argc) {
+            config.ticksPerStep = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            config.tickRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            config.pointsPerEpisode = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc) {
+            config.maxStepsPerEpisode = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            config.frameScale = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc) {
+            config.opponent.difficulty = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            benchSteps = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--force") == 0) {
+            force = true;
+        } else {
+            std::cout << "Opción desconocida: " << argv[i] << std::endl;
+            std::cout << "Uso: pong-env [--shm /nombre] [--envs N] [--ticks-per-step N] [--tick-rate N] [--points N]" << std::endl;
+            std::cout << "                [--max-steps N] [--frames ESCALA] [--difficulty X] [--threads N] [--seed S]" << std::endl;
+            std::cout << "                [--bench PASOS] [--force]" << std::endl;
+            return -1;
+        }
+    }
+
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+
+    if (benchSteps > 0) {
+        return runBenchmark(config, benchSteps, shmName, force) ? 0 : -1;
+    }
+    if (shmName.empty()) {
+        std::cout << "Indica --shm /nombre para servir el entorno o --bench PASOS para medirlo" << std::endl;
+        return -1;
+    }
+
+    VectorEnv env(config);
+    SharedEnvServer server(env);
+    if (!server.create(shmName, force)) {
+        if (!force) {
+            std::cout << "Si es de un servidor que terminó sin borrarla, usa --force o borra /dev/shm"
+                      << (shmName[0] == '/' ? "" : "/") << shmName << std::endl;
+        }
+        return -1;
+    }
+    std::cout << "Entorno en la memoria compartida " << shmName << ": " << env.getNumEnvs() << " partidas, "
+              << env.getThreadCount() << " hilos";
+    if (env.getFrameWidth() > 0) std::cout << ", imagen " << env.getFrameWidth() << "x" << env.getFrameHeight();
+    std::cout << std::endl;
+    server.serve(&interrupted);
+    std::cout << "Pasos atendidos: " << server.getSteps() << std::endl;
+    return 0;
+}
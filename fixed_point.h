@@ -0,0 +1,144 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+// Números en coma fija 16.16 (Fixed16) para la física determinista.
+// Con float, el resultado depende de cómo compile cada máquina (FMA, x87 con precisión
+// extendida en 32 bits, -ffast-math, reordenaciones...), así que dos ordenadores pueden
+// separarse en unos pocos ticks. Con enteros cada operación da los mismos bits en cualquier
+// compilación: sumas y restas directas, productos en 64 bits desplazados 16 bits (redondeo
+// hacia abajo, como el desplazamiento aritmético de los kernels SIMD) y divisiones en 64 bits
+// truncando hacia cero.
+//
+// Fixed16 se usa como parámetro de plantilla en lugar de float (BasicMatch en pong_core.h y
+// BasicBatchPhysics en batch_physics.h), así que ofrece lo que usa ese código: construcción
+// desde int, desde float (solo para parámetros como la dificultad; explícita) y desde una
+// fracción entera, aritmética, comparaciones y (int). Lo que float hace con funciones de
+// <cmath> (fmin, fmax, fmod) va en las funciones real*() de abajo, con una versión para cada tipo.
+//
+// Rango: ±32767 con paso 1/65536 (~0,000015); el campo mide 800x600 y las velocidades son de
+// cientos de píxeles por segundo, así que hay margen de sobra.
+
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+
+struct Fixed16 {
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    int32_t raw;
+
+    Fixed16() : raw(0) {}
+    Fixed16(int value) : raw((int32_t)(value * ONE)) {}
+    // Redondeo al valor representable más cercano: el producto por 2^16 es exacto en double
+    explicit Fixed16(float value) : raw((int32_t)std::lround((double)value * ONE)) {}
+    // Sin esto un float pasaría en silencio por Fixed16(int) y se truncaría (dt = 1/60 -> 0):
+    // la promoción a double gana a la conversión a int y la llamada no compila
+    Fixed16(double value) = delete;
+
+    static Fixed16 fromRaw(int32_t raw) {
+        Fixed16 result;
+        result.raw = raw;
+        return result;
+    }
+
+    // numerator / denominator sin pasar por float (dt = 1 / tickRate, dificultades...)
+    static Fixed16 fromRatio(int64_t numerator, int64_t denominator) {
+        return fromRaw((int32_t)(numerator * ONE / denominator));
+    }
+
+    float toFloat() const {
+        return (float)raw / ONE;
+    }
+
+    // Redondea hacia abajo (un desplazamiento, también en SIMD). Con valores positivos, como
+    // todas las coordenadas del campo, es lo mismo que (int) sobre un float
+    explicit operator int() const {
+        return raw >> FRACTION_BITS;
+    }
+
+    Fixed16 operator-() const { return fromRaw(-raw); }
+    Fixed16 operator+(Fixed16 other) const { return fromRaw(raw + other.raw); }
+    Fixed16 operator-(Fixed16 other) const { return fromRaw(raw - other.raw); }
+    // >> sobre negativos es aritmético en GCC, Clang y MSVC (y obligatorio desde C++20)
+    Fixed16 operator*(Fixed16 other) const {
+        return fromRaw((int32_t)(((int64_t)raw * other.raw) >> FRACTION_BITS));
+    }
+    // Satura al rango en vez de desbordar: en la colisión continua, el tiempo hasta una pared
+    // con una velocidad casi nula no cabe en 16.16 y solo importa que sea muy grande
+    Fixed16 operator/(Fixed16 other) const {
+        int64_t quotient = (int64_t)raw * ONE / other.raw;
+        if (quotient > std::numeric_limits<int32_t>::max()) return fromRaw(std::numeric_limits<int32_t>::max());
+        if (quotient < -std::numeric_limits<int32_t>::max()) return fromRaw(-std::numeric_limits<int32_t>::max());
+        return fromRaw((int32_t)quotient);
+    }
+    Fixed16& operator+=(Fixed16 other) { raw += other.raw; return *this; }
+    Fixed16& operator-=(Fixed16 other) { raw -= other.raw; return *this; }
+
+    bool operator<(Fixed16 other) const { return raw < other.raw; }
+    bool operator>(Fixed16 other) const { return raw > other.raw; }
+    bool operator<=(Fixed16 other) const { return raw <= other.raw; }
+    bool operator>=(Fixed16 other) const { return raw >= other.raw; }
+    bool operator==(Fixed16 other) const { return raw == other.raw; }
+    bool operator!=(Fixed16 other) const { return raw != other.raw; }
+};
+
+// Fracción entera en el tipo de la física: para float es la división de siempre (la que hace
+// el código original) y para Fixed16 no toca la coma flotante
+template <typename Real>
+inline Real realFromRatio(int numerator, int denominator) {
+    return (float)numerator / denominator;
+}
+
+template <>
+inline Fixed16 realFromRatio<Fixed16>(int numerator, int denominator) {
+    return Fixed16::fromRatio(numerator, denominator);
+}
+
+// Valor muy grande que hace de infinito (tiempos de impacto que no llegan a producirse)
+template <typename Real>
+inline Real realHuge() {
+    return 1e30f;
+}
+
+template <>
+inline Fixed16 realHuge<Fixed16>() {
+    return Fixed16::fromRaw(std::numeric_limits<int32_t>::max());
+}
+
+inline float realMin(float a, float b) { return std::fmin(a, b); }
+inline float realMax(float a, float b) { return std::fmax(a, b); }
+inline Fixed16 realMin(Fixed16 a, Fixed16 b) { return a < b ? a : b; }
+inline Fixed16 realMax(Fixed16 a, Fixed16 b) { return a > b ? a : b; }
+
+// Resto con el signo del dividendo, como fmod
+inline float realMod(float a, float b) { return std::fmod(a, b); }
+inline Fixed16 realMod(Fixed16 a, Fixed16 b) { return Fixed16::fromRaw(a.raw % b.raw); }
+
+// Para lo que sale de la física: dibujo, observaciones, paquetes de red
+inline float realToFloat(float value) { return value; }
+inline float realToFloat(Fixed16 value) { return value.toFloat(); }
+
+// Si el tipo de la física es la coma fija (las repeticiones lo guardan en la cabecera)
+template <typename Real>
+inline bool realIsFixed() {
+    return false;
+}
+
+template <>
+inline bool realIsFixed<Fixed16>() {
+    return true;
+}
+
+// Bits del valor, para comparar y resumir estados
+inline uint32_t realBits(float value) {
+    union { float f; uint32_t u; } bits;
+    bits.f = value;
+    return bits.u;
+}
+
+inline uint32_t realBits(Fixed16 value) {
+    return (uint32_t)value.raw;
+}
+
+#endif
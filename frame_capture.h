@@ -0,0 +1,409 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+// Captura de frames a vídeo o a imágenes (--capture).
+// El frame se dibuja en un destino fuera de pantalla, se lee con SDL_RenderReadPixels en
+// uno de los buffers de un anillo reservado al empezar y un hilo escritor lo convierte y lo
+// escribe. El bucle del juego solo copia píxeles: nunca espera al disco. En vivo, si el
+// escritor se retrasa y no queda buffer libre, el frame se descarta (y se cuenta); al
+// exportar sin ventana se espera, porque ahí importa no perder ninguno.
+//
+// Formatos:
+//   y4m  YUV 4:2:0 (BT.601 rango completo), lo leen ffmpeg y casi cualquier reproductor
+//   raw  RGB24 sin cabecera (ffmpeg -f rawvideo -pix_fmt rgb24 -s 800x600 -r FPS -i ...)
+//   png  una imagen por frame (RUTA-000001.png...), sin comprimir: PNG válido sin zlib
+
+#include <SDL2/SDL.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum CaptureFormat {
+    CAPTURE_Y4M,
+    CAPTURE_RAW,
+    CAPTURE_PNG
+};
+
+struct CaptureConfig {
+    std::string path;        // Vacía: sin captura
+    CaptureFormat format;
+    int fps;                 // Frames por segundo del vídeo
+    int buffers;             // Buffers del anillo
+
+    CaptureConfig() : format(CAPTURE_Y4M), fps(60), buffers(8) {}
+
+    // Formato por la extensión de la ruta: .y4m, .png o, si no, raw
+    static CaptureFormat formatForPath(const std::string& path) {
+        size_t dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+        if (extension == "y4m") return CAPTURE_Y4M;
+        if (extension == "png") return CAPTURE_PNG;
+        return CAPTURE_RAW;
+    }
+
+    static bool parseFormat(const char* text, CaptureFormat& format) {
+        std::string name(text);
+        if (name == "y4m") format = CAPTURE_Y4M;
+        else if (name == "raw") format = CAPTURE_RAW;
+        else if (name == "png") format = CAPTURE_PNG;
+        else return false;
+        return true;
+    }
+};
+
+inline const char* captureFormatName(CaptureFormat format) {
+    static const char* names[] = {"y4m", "raw", "png"};
+    return names[format];
+}
+
+class FrameCapture {
+public:
+    FrameCapture() : width(0), height(0), waitWhenFull(false), stopping(false), capturing(false),
+                     nextFrame(0), dropped(0), written(0), bytesWritten(0), writeErrors(0),
+                     readbackMs(0.0), writeMs(0.0) {}
+
+    ~FrameCapture() {
+        finish();
+    }
+
+    // wait: esperar a que haya buffer libre en vez de descartar el frame (exportación)
+    bool open(const CaptureConfig& captureConfig, int frameWidth, int frameHeight, bool wait) {
+        finish();
+        config = captureConfig;
+        width = frameWidth;
+        height = frameHeight;
+        waitWhenFull = wait;
+        if (config.fps < 1) config.fps = 1;
+        if (config.buffers < 2) config.buffers = 2;
+
+        if (config.format != CAPTURE_PNG) {
+            out.open(config.path.c_str(), std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cout << "No se pudo crear " << config.path << std::endl;
+                return false;
+            }
+            if (config.format == CAPTURE_Y4M) {
+                char header[96];
+                int size = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+                                    width, height, config.fps);
+                out.write(header, size);
+            }
+        }
+
+        // Todo se reserva aquí: durante la captura no hay asignaciones
+        pool.assign(config.buffers, std::vector<uint8_t>((size_t)width * height * 4));
+        converted.assign(config.format == CAPTURE_Y4M ? (size_t)width * height * 3 / 2 + 2 * width
+                                                      : (size_t)width * height * 3, 0);
+        freeSlots.clear();
+        for (int i = 0; i < config.buffers; i++) freeSlots.push_back(i);
+        ready.clear();
+        nextFrame = 0;
+        dropped = written = bytesWritten = writeErrors = 0;
+        readbackMs = writeMs = 0.0;
+        stopping = false;
+        capturing = true;
+        startTime = std::chrono::steady_clock::now();
+        writer = std::thread(&FrameCapture::writeLoop, this);
+        std::cout << "Capturando en " << config.path << " (" << captureFormatName(config.format) << ", "
+                  << config.fps << " FPS)" << std::endl;
+        return true;
+    }
+
+    bool isCapturing() const {
+        return capturing;
+    }
+
+    int getFps() const {
+        return config.fps;
+    }
+
+    // Lee el destino actual del renderer (la textura fuera de pantalla o la superficie)
+    bool capture(SDL_Renderer* renderer) {
+        if (!capturing) return false;
+        int slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (freeSlots.empty() && !waitWhenFull) {
+                dropped++;
+                return false;
+            }
+            slotFreed.wait(lock, [this]() { return !freeSlots.empty(); });
+            slot = freeSlots.front();
+            freeSlots.pop_front();
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool ok = SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, &pool[slot][0], width * 4) == 0;
+        readbackMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ok) {
+            freeSlots.push_back(slot);
+            dropped++;
+            return false;
+        }
+        PendingFrame frame = {slot, nextFrame++};
+        ready.push_back(frame);
+        frameReady.notify_one();
+        return true;
+    }
+
+    // Espera a que se escriban los frames pendientes y cierra la salida
+    void finish() {
+        if (!capturing) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        frameReady.notify_one();
+        writer.join();
+        out.close();
+        capturing = false;
+        finishTime = std::chrono::steady_clock::now();
+    }
+
+    void printReport() const {
+        if (nextFrame == 0 && dropped == 0) return;
+        double seconds = std::chrono::duration<double>(finishTime - startTime).count();
+        std::cout << "=== Captura (" << captureFormatName(config.format) << ") ===" << std::endl;
+        std::cout << "Frames escritos: " << written << "  descartados: " << dropped;
+        if (writeErrors > 0) std::cout << "  errores de escritura: " << writeErrors;
+        std::cout << std::endl;
+        if (written > 0 && seconds > 0.0) {
+            std::cout << "Exportados: " << written / seconds << " frames/s (" << written / (double)config.fps
+                      << " s de vídeo en " << seconds << " s)  " << bytesWritten / seconds / (1024.0 * 1024.0)
+                      << " MB/s" << std::endl;
+            std::cout << "Lectura de píxeles: " << readbackMs / nextFrame << " ms/frame  Conversión y escritura: "
+                      << writeMs / written << " ms/frame (hilo escritor)" << std::endl;
+        }
+    }
+
+private:
+    struct PendingFrame {
+        int slot;
+        long number;
+    };
+
+    CaptureConfig config;
+    int width, height;
+    bool waitWhenFull;
+    std::ofstream out;
+    std::vector<std::vector<uint8_t> > pool;
+    std::vector<uint8_t> converted;   // Solo los usa el hilo escritor
+    std::vector<uint8_t> pngData;
+    std::deque<int> freeSlots;
+    std::deque<PendingFrame> ready;
+    std::mutex mutex;
+    std::condition_variable frameReady, slotFreed;
+    std::thread writer;
+    bool stopping;
+    bool capturing;
+    long nextFrame, dropped, written;
+    uint64_t bytesWritten;
+    long writeErrors;
+    double readbackMs, writeMs;
+    std::chrono::steady_clock::time_point startTime, finishTime;
+
+    void writeLoop() {
+        while (true) {
+            PendingFrame frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                frameReady.wait(lock, [this]() { return stopping || !ready.empty(); });
+                if (ready.empty()) return; // stopping y sin nada pendiente
+                frame = ready.front();
+                ready.pop_front();
+            }
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            bool ok = writeFrame(&pool[frame.slot][0], frame.number);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            writeMs += ms;
+            if (ok) written++;
+            else writeErrors++;
+            freeSlots.push_back(frame.slot);
+            slotFreed.notify_one();
+        }
+    }
+
+    bool writeFrame(const uint8_t* argb, long number) {
+        if (config.format == CAPTURE_Y4M) {
+            toYuv420(argb);
+            out.write("FRAME\n", 6);
+            out.write((const char*)&converted[0], (std::streamsize)yuvSize());
+            bytesWritten += 6 + yuvSize();
+            return (bool)out;
+        }
+        toRgb24(argb);
+        if (config.format == CAPTURE_RAW) {
+            out.write((const char*)&converted[0], (std::streamsize)width * height * 3);
+            bytesWritten += (uint64_t)width * height * 3;
+            return (bool)out;
+        }
+        return writePng(pngPath(number));
+    }
+
+    size_t yuvSize() const {
+        size_t chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+        return (size_t)width * height + 2 * chromaW * chromaH;
+    }
+
+    // captura.png -> captura-000001.png
+    std::string pngPath(long number) const {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "-%06ld", number + 1);
+        size_t dot = config.path.find_last_of('.');
+        size_t slash = config.path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = config.path.size();
+        return config.path.substr(0, dot) + suffix + config.path.substr(dot);
+    }
+
+    void toRgb24(const uint8_t* argb) {
+        const uint32_t* pixels = (const uint32_t*)argb;
+        uint8_t* rgb = &converted[0];
+        for (size_t i = 0, n = (size_t)width * height; i < n; i++) {
+            uint32_t p = pixels[i];
+            rgb[3 * i] = (uint8_t)(p >> 16);
+            rgb[3 * i + 1] = (uint8_t)(p >> 8);
+            rgb[3 * i + 2] = (uint8_t)p;
+        }
+    }
+
+    // BT.601 de rango completo (C420jpeg); el croma es la media de cada bloque de 2x2
+    void toYuv420(const uint8_t* argb) {
+        const uint32_t* pixels = (const uint32_t*)argb;
+        int chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+        uint8_t* yPlane = &converted[0];
+        uint8_t* uPlane = yPlane + (size_t)width * height;
+        uint8_t* vPlane = uPlane + (size_t)chromaW * chromaH;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint32_t p = pixels[(size_t)y * width + x];
+                int r = (p >> 16) & 0xFF, g = (p >> 8) & 0xFF, b = p & 0xFF;
+                yPlane[(size_t)y * width + x] = (uint8_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+            }
+        }
+        for (int cy = 0; cy < chromaH; cy++) {
+            for (int cx = 0; cx < chromaW; cx++) {
+                int r = 0, g = 0, b = 0, count = 0;
+                for (int dy = 0; dy < 2 && 2 * cy + dy < height; dy++) {
+                    for (int dx = 0; dx < 2 && 2 * cx + dx < width; dx++) {
+                        uint32_t p = pixels[(size_t)(2 * cy + dy) * width + 2 * cx + dx];
+                        r += (p >> 16) & 0xFF;
+                        g += (p >> 8) & 0xFF;
+                        b += p & 0xFF;
+                        count++;
+                    }
+                }
+                r /= count;
+                g /= count;
+                b /= count;
+                uPlane[(size_t)cy * chromaW + cx] = (uint8_t)std::min(255, std::max(0, (-43 * r - 85 * g + 128 * b + 128) / 256 + 128));
+                vPlane[(size_t)cy * chromaW + cx] = (uint8_t)std::min(255, std::max(0, (128 * r - 107 * g - 21 * b + 128) / 256 + 128));
+            }
+        }
+    }
+
+    // PNG RGB de 8 bits con los datos en bloques deflate sin comprimir (stored)
+    bool writePng(const std::string& path) {
+        std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        file.write((const char*)signature, 8);
+
+        uint8_t header[13];
+        putBigEndian(header, (uint32_t)width);
+        putBigEndian(header + 4, (uint32_t)height);
+        header[8] = 8;  // Bits por canal
+        header[9] = 2;  // RGB
+        header[10] = header[11] = header[12] = 0;
+        writeChunk(file, "IHDR", header, 13);
+
+        // Cada fila lleva delante su filtro (0: ninguno)
+        const size_t rowBytes = (size_t)width * 3 + 1;
+        const size_t rawSize = rowBytes * height;
+        const size_t blocks = (rawSize + 65534) / 65535;
+        std::vector<uint8_t>& idat = pngData; // Reutilizado entre frames
+        idat.resize(2 + rawSize + blocks * 5 + 4);
+        size_t pos = 0;
+        idat[pos++] = 0x78; // zlib: deflate, ventana de 32 KB
+        idat[pos++] = 0x01;
+        uint32_t adlerA = 1, adlerB = 0;
+        size_t blockLeft = 0;
+        size_t blocksWritten = 0;
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = &converted[(size_t)y * width * 3];
+            for (size_t i = 0; i < rowBytes; i++) {
+                if (blockLeft == 0) {
+                    size_t remaining = rawSize - (size_t)y * rowBytes - i;
+                    size_t length = std::min<size_t>(remaining, 65535);
+                    idat[pos++] = (++blocksWritten == blocks) ? 1 : 0;
+                    idat[pos++] = (uint8_t)length;
+                    idat[pos++] = (uint8_t)(length >> 8);
+                    idat[pos++] = (uint8_t)~length;
+                    idat[pos++] = (uint8_t)(~length >> 8);
+                    blockLeft = length;
+                }
+                uint8_t value = i == 0 ? 0 : row[i - 1];
+                idat[pos++] = value;
+                adlerA = (adlerA + value) % 65521;
+                adlerB = (adlerB + adlerA) % 65521;
+                blockLeft--;
+            }
+        }
+        putBigEndian(&idat[pos], (adlerB << 16) | adlerA);
+        pos += 4;
+        writeChunk(file, "IDAT", &idat[0], pos);
+        writeChunk(file, "IEND", nullptr, 0);
+        bytesWritten += 8 + 25 + pos + 12 + 12;
+        return (bool)file;
+    }
+
+    static void putBigEndian(uint8_t* out, uint32_t value) {
+        out[0] = (uint8_t)(value >> 24);
+        out[1] = (uint8_t)(value >> 16);
+        out[2] = (uint8_t)(value >> 8);
+        out[3] = (uint8_t)value;
+    }
+
+    static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+        static uint32_t table[256];
+        static bool tableReady = false;
+        if (!tableReady) {
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+            tableReady = true;
+        }
+        for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc;
+    }
+
+    static void writeChunk(std::ofstream& file, const char* type, const uint8_t* data, size_t size) {
+        uint8_t length[4], crcBytes[4];
+        putBigEndian(length, (uint32_t)size);
+        file.write((const char*)length, 4);
+        file.write(type, 4);
+        if (size > 0) file.write((const char*)data, (std::streamsize)size);
+        uint32_t crc = crc32Update(0xFFFFFFFFu, (const uint8_t*)type, 4);
+        if (size > 0) crc = crc32Update(crc, data, size);
+        putBigEndian(crcBytes, crc ^ 0xFFFFFFFFu);
+        file.write((const char*)crcBytes, 4);
+    }
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+// Ritmo de frames.
+// Sustituye al SDL_Delay(16) fijo: con vsync el ritmo lo marca SDL_RenderPresent; con un
+// límite de FPS se espera hasta el siguiente instante programado (deadline) con una espera
+// híbrida: SDL_Delay para la mayor parte y espera activa (spin) para el último tramo, que
+// es donde el planificador del sistema es impreciso. Sin límite no se espera nada.
+// También mide el tiempo real entre frames y lo resume al salir.
+//
+// Retraso de entrada (solo con vsync): tras el present, en vez de empezar el frame
+// siguiente enseguida y esperar al refresco dentro de SDL_RenderPresent, se duerme hasta
+// poco antes del refresco (periodo - trabajo estimado - margen). Así los eventos se leen
+// lo más tarde posible y la latencia entrada → pantalla baja casi un frame.
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+enum PacingMode {
+    PACING_VSYNC,    // SDL_RenderPresent espera al refresco de la pantalla
+    PACING_CAP,      // Límite de FPS con espera híbrida
+    PACING_UNCAPPED  // Sin espera (medir rendimiento)
+};
+
+struct FramePacingConfig {
+    PacingMode mode;
+    int fpsCap;       // Solo en PACING_CAP
+    bool inputDelay;  // Solo en PACING_VSYNC
+
+    FramePacingConfig() : mode(PACING_VSYNC), fpsCap(60), inputDelay(false) {}
+};
+
+inline const char* pacingModeName(PacingMode mode) {
+    switch (mode) {
+        case PACING_VSYNC: return "vsync";
+        case PACING_CAP: return "límite de FPS";
+        default: return "sin límite";
+    }
+}
+
+class FramePacer {
+private:
+    PacingMode mode;
+    double framePeriod;      // Segundos por frame con límite
+    double spinMargin;       // Tramo final que se espera en activo (se adapta al sistema)
+    Uint64 frequency;
+    Uint64 nextDeadline;
+    Uint64 lastFrameEnd;
+    std::vector<float> frameTimes; // Milisegundos entre frames consecutivos
+    bool inputDelay;
+    double refreshPeriod;
+    double workEstimate;     // Segundos desde el inicio del frame hasta el present
+    Uint64 workStart;
+
+    static constexpr double INPUT_DELAY_MARGIN = 0.002; // Holgura para no perder el refresco
+
+    static const int MAX_SAMPLES = 1 << 20; // ~4,8 h a 60 Hz
+
+    double secondsSince(Uint64 start, Uint64 end) const {
+        return (double)(end - start) / frequency;
+    }
+
+    // Duerme casi todo el tiempo restante y termina con espera activa
+    void waitUntil(Uint64 deadline) {
+        while (true) {
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (now >= deadline) return;
+            double remaining = secondsSince(now, deadline);
+            if (remaining <= spinMargin) break;
+
+            Uint32 sleepMs = (Uint32)((remaining - spinMargin) * 1000.0);
+            if (sleepMs == 0) break;
+            SDL_Delay(sleepMs);
+
+            // Si el sistema duerme más de lo pedido, ampliar el margen de espera activa
+            double overshoot = secondsSince(now, SDL_GetPerformanceCounter()) - sleepMs / 1000.0;
+            if (overshoot > spinMargin) {
+                spinMargin = std::min(overshoot, 0.004);
+            }
+        }
+        while (SDL_GetPerformanceCounter() < deadline) {
+            // Espera activa: solo el último milisegundo o dos
+        }
+    }
+
+public:
+    FramePacer() : mode(PACING_VSYNC), framePeriod(1.0 / 60.0), spinMargin(0.0015),
+                   frequency(1), nextDeadline(0), lastFrameEnd(0), inputDelay(false),
+                   refreshPeriod(1.0 / 60.0), workEstimate(0.0), workStart(0) {}
+
+    void configure(PacingMode pacingMode, int fpsCap) {
+        mode = pacingMode;
+        if (fpsCap < 1) fpsCap = 1;
+        framePeriod = 1.0 / fpsCap;
+    }
+
+    void enableInputDelay(int refreshRate) {
+        inputDelay = true;
+        refreshPeriod = 1.0 / (refreshRate > 0 ? refreshRate : 60);
+    }
+
+    PacingMode getMode() const {
+        return mode;
+    }
+
+    int getFpsCap() const {
+        return (int)std::lround(1.0 / framePeriod);
+    }
+
+    void start() {
+        frequency = SDL_GetPerformanceFrequency();
+        lastFrameEnd = SDL_GetPerformanceCounter();
+        nextDeadline = lastFrameEnd;
+        frameTimes.clear();
+    }
+
+    // Llamar al empezar el frame, antes de leer los eventos
+    void beginFrame() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (inputDelay && mode == PACING_VSYNC) {
+            double delay = refreshPeriod - workEstimate - INPUT_DELAY_MARGIN;
+            if (delay > 0.0) {
+                waitUntil(now + (Uint64)(delay * frequency));
+                now = SDL_GetPerformanceCounter();
+            }
+        }
+        workStart = now;
+    }
+
+    // Llamar justo antes de SDL_RenderPresent: mide el trabajo del frame
+    void markSubmit() {
+        double work = secondsSince(workStart, SDL_GetPerformanceCounter());
+        // Sube enseguida ante un frame lento y baja despacio
+        if (work > workEstimate) {
+            workEstimate = work;
+        } else {
+            workEstimate += (work - workEstimate) * 0.02;
+        }
+    }
+
+    // Llamar justo después de SDL_RenderPresent
+    void endFrame() {
+        if (mode == PACING_CAP) {
+            Uint64 period = (Uint64)(framePeriod * frequency);
+            nextDeadline += period;
+
+            // Si vamos más de un frame tarde, no intentar recuperar frames perdidos
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (now > nextDeadline + period) {
+                nextDeadline = now;
+            } else {
+                waitUntil(nextDeadline);
+            }
+        }
+
+        Uint64 frameEnd = SDL_GetPerformanceCounter();
+        if (frameTimes.size() < (size_t)MAX_SAMPLES) {
+            frameTimes.push_back((float)(secondsSince(lastFrameEnd, frameEnd) * 1000.0));
+        }
+        lastFrameEnd = frameEnd;
+    }
+
+    bool isInputDelayActive() const {
+        return inputDelay && mode == PACING_VSYNC;
+    }
+
+    void printReport() const {
+        if (frameTimes.size() < 2) return;
+
+        // El primer frame incluye la inicialización: no es representativo
+        std::vector<float> sorted(frameTimes.begin() + 1, frameTimes.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++) sum += sorted[i];
+        double mean = sum / sorted.size();
+        double variance = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++) variance += (sorted[i] - mean) * (sorted[i] - mean);
+        double stddev = std::sqrt(variance / sorted.size());
+        float p99 = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+
+        std::cout << "=== Ritmo de frames (" << pacingModeName(mode);
+        if (mode == PACING_CAP) std::cout << ", " << getFpsCap() << " FPS";
+        std::cout << ") ===" << std::endl;
+        std::cout << "Frames: " << sorted.size() << "  FPS medios: " << 1000.0 / mean << std::endl;
+        std::cout << "Tiempo de frame (ms): medio " << mean << "  mín " << sorted.front()
+                  << "  máx " << sorted.back() << "  p99 " << p99 << "  desviación " << stddev << std::endl;
+        if (mode == PACING_CAP) {
+            // Frames que tardaron más de 1,5 periodos: se notan como tirones
+            double limit = framePeriod * 1500.0;
+            size_t late = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), (float)limit);
+            std::cout << "Frames tardíos (> " << limit << " ms): " << late << std::endl;
+        }
+    }
+};
+
+#endif
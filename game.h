@@ -0,0 +1,1606 @@
+#ifndef GAME_H
+#define GAME_H
+
+// Juego interactivo: ventana, menú, partida, audio y render.
+// main.cpp solo interpreta la línea de comandos; el banco de pruebas (bench.cpp) usa
+// esta misma clase sobre un renderer por software sin ventana.
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <chrono>
+#include "pong_core.h"
+#include "draw_batch.h"
+#include "layer_cache.h"
+#include "dirty_rects.h"
+#include "text_renderer.h"
+#include "frame_pacer.h"
+#include "profiler.h"
+#include "input.h"
+#include "replay.h"
+#include "rollback.h"
+#include "broadcast.h"
+#include "music_loader.h"
+#include "sound_effects.h"
+#include "startup_trace.h"
+#include "frame_capture.h"
+#include <atomic>
+#include <deque>
+#include <thread>
+
+enum GameMode {
+    MENU,
+    SINGLE_PLAYER,
+    MULTIPLAYER
+};
+
+// Ruta de la música, relativa al directorio actual o al ejecutable
+const char* const MUSIC_PATH = "assets/Funk It - Dyalla.mp3";
+
+// Muestras por buffer de audio (--audio-buffer). 512 a 44.1 kHz son ~12 ms; antes eran 2048 (~46 ms)
+const int DEFAULT_AUDIO_BUFFER = 512;
+const int MIN_AUDIO_BUFFER = 128;
+const int MAX_AUDIO_BUFFER = 4096;
+
+// Estado del dispositivo de audio, que se abre en un hilo la primera vez que hace falta
+enum AudioDeviceState {
+    AUDIO_CLOSED,
+    AUDIO_OPENING,
+    AUDIO_READY,
+    AUDIO_FAILED
+};
+
+class AudioManager {
+private:
+    MusicLoader musicLoader;
+    MusicLoadState reportedState; // Último estado de la carga ya tratado
+    SoundEffects effects;
+    int bufferSize;               // Muestras por buffer del dispositivo
+    bool musicEnabled;
+    int musicVolume;
+    std::atomic<int> deviceState;
+    int reportedDevice;           // Último estado del dispositivo ya tratado
+    std::thread opener;
+    std::string deviceError;      // Lo escribe el hilo antes de publicar AUDIO_FAILED
+    StartupTrace* trace;
+    
+public:
+    AudioManager() : reportedState(MUSIC_IDLE), bufferSize(DEFAULT_AUDIO_BUFFER),
+                     musicEnabled(false), musicVolume(64), deviceState(AUDIO_CLOSED),
+                     reportedDevice(AUDIO_CLOSED), trace(nullptr) {}
+    
+    ~AudioManager() {
+        if (opener.joinable()) opener.join();
+    }
+    
+    // Antes de abrir el dispositivo; buffers pequeños bajan la latencia de los efectos
+    void setBufferSize(int samples) {
+        bufferSize = std::max(MIN_AUDIO_BUFFER, std::min(MAX_AUDIO_BUFFER, samples));
+    }
+    
+    void setStartupTrace(StartupTrace* startupTrace) {
+        trace = startupTrace;
+    }
+    
+    // Abre el dispositivo y prepara los efectos en un hilo, solo la primera vez. Se llama
+    // al necesitar sonido (partida o música), no al arrancar: abrir el dispositivo puede
+    // tardar decenas de ms y no hace falta para mostrar el menú.
+    void prepare() {
+        if (deviceState != AUDIO_CLOSED) {
+            return;
+        }
+        deviceState = AUDIO_OPENING;
+        opener = std::thread(&AudioManager::openDevice, this);
+    }
+    
+    bool isReady() const {
+        return deviceState == AUDIO_READY;
+    }
+    
+    // Llamar cada frame: trata la apertura del dispositivo y el fin de la carga de la música,
+    // y arranca la música si se pidió mientras tanto. Devuelve true si cambia el indicador
+    // de música del HUD.
+    bool update() {
+        int device = deviceState.load();
+        if (device != reportedDevice) {
+            reportedDevice = device;
+            if (device == AUDIO_FAILED || device == AUDIO_READY) {
+                opener.join(); // Ya terminó
+            }
+            if (device == AUDIO_FAILED) {
+                std::cout << "Advertencia: Audio no disponible (" << deviceError << ")" << std::endl;
+                if (musicEnabled) {
+                    musicEnabled = false;
+                    return true;
+                }
+                return false;
+            }
+            if (device == AUDIO_READY && musicEnabled) {
+                musicLoader.start(MUSIC_PATH);
+            }
+        }
+        if (device != AUDIO_READY) {
+            return false;
+        }
+        
+        MusicLoadState state = musicLoader.getState();
+        if (state == reportedState) {
+            return false;
+        }
+        reportedState = state;
+        if (state == MUSIC_READY) {
+            if (trace) {
+                trace->record("musica (decodificador)", musicLoader.getStartTime(), musicLoader.getEndTime(), true);
+            }
+            std::cout << "Música cargada exitosamente: Funk It - Dyalla (" << (int)musicLoader.getLoadMs()
+                      << " ms en segundo plano)" << std::endl;
+            if (musicEnabled) {
+                startPlayback();
+            }
+            return true;
+        }
+        if (state == MUSIC_FAILED) {
+            std::cout << "Advertencia: No se pudo cargar la música (" << musicLoader.getError() << ")" << std::endl;
+            std::cout << "El juego funcionará sin música de fondo." << std::endl;
+            musicEnabled = false;
+            return true;
+        }
+        return false;
+    }
+    
+    void toggleMusic() {
+        musicEnabled = !musicEnabled;
+        if (musicEnabled) {
+            prepare();
+            int device = deviceState.load();
+            if (device == AUDIO_OPENING) {
+                // update() empieza la carga al abrirse el dispositivo
+                std::cout << "♪ Abriendo el audio: la música sonará en cuanto esté lista" << std::endl;
+                return;
+            }
+            MusicLoadState state = musicLoader.getState();
+            if (device == AUDIO_READY && state == MUSIC_IDLE) {
+                musicLoader.start(MUSIC_PATH);
+                state = MUSIC_LOADING;
+            }
+            if (device == AUDIO_READY && state == MUSIC_READY) {
+                startPlayback();
+            } else if (device == AUDIO_READY && state == MUSIC_LOADING) {
+                std::cout << "♪ Cargando música: sonará en cuanto esté lista" << std::endl;
+            } else {
+                std::cout << "No hay música disponible para reproducir" << std::endl;
+                musicEnabled = false;
+            }
+        } else {
+            if (isReady()) {
+                Mix_HaltMusic();
+            }
+            std::cout << "♪ Música desactivada" << std::endl;
+        }
+    }
+    
+    // Sonidos de los sucesos del último tick (MatchEvent)
+    void playEvents(uint8_t events) {
+        if (!events || !isReady()) {
+            return;
+        }
+        if (events & EVENT_POINT) {
+            effects.play(SFX_SCORE);
+        } else if (events & EVENT_PADDLE_HIT) {
+            effects.play(SFX_PADDLE_HIT);
+        } else if (events & EVENT_WALL_BOUNCE) {
+            effects.play(SFX_WALL_BOUNCE);
+        }
+    }
+    
+    void printReport() const {
+        if (isReady()) {
+            effects.printReport();
+        }
+    }
+    
+    bool isMusicEnabled() const {
+        return musicEnabled;
+    }
+    
+    bool isMusicPlaying() const {
+        return isReady() && Mix_PlayingMusic();
+    }
+    
+    void setMusicVolume(int volume) {
+        // Volumen entre 0-128
+        musicVolume = volume;
+        if (musicVolume < 0) musicVolume = 0;
+        if (musicVolume > 128) musicVolume = 128;
+        if (isReady()) {
+            Mix_VolumeMusic(musicVolume);
+        }
+        
+        if (musicEnabled) {
+            std::cout << "♪ Volumen: " << (musicVolume * 100 / 128) << "%" << std::endl;
+        }
+    }
+    
+    void increaseVolume() {
+        setMusicVolume(musicVolume + 16);
+    }
+    
+    void decreaseVolume() {
+        setMusicVolume(musicVolume - 16);
+    }
+    
+    void cleanup() {
+        if (opener.joinable()) {
+            opener.join(); // Espera a que termine de abrirse
+        }
+        musicLoader.free(); // Espera a la carga si sigue en curso
+        if (isReady()) {
+            effects.cleanup();
+            Mix_CloseAudio();
+        }
+        deviceState = AUDIO_CLOSED;
+        reportedDevice = AUDIO_CLOSED;
+    }
+    
+private:
+    void openDevice() {
+        StartupTrace::Clock::time_point start = StartupTrace::now();
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            deviceError = SDL_GetError(); // Los errores de SDL son por hilo
+            deviceState = AUDIO_FAILED;
+            return;
+        }
+        if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, bufferSize) < 0) {
+            deviceError = std::string("SDL_mixer: ") + Mix_GetError();
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+            deviceState = AUDIO_FAILED;
+            return;
+        }
+        if (trace) trace->record("dispositivo de audio", start, true);
+        
+        // Sin efectos el juego sigue con música
+        start = StartupTrace::now();
+        effects.init(bufferSize);
+        if (trace) trace->record("efectos de sonido", start, true);
+        deviceState = AUDIO_READY;
+    }
+    
+    void startPlayback() {
+        if (Mix_PlayMusic(musicLoader.getMusic(), -1) == -1) {
+            std::cout << "Error reproduciendo música: " << Mix_GetError() << std::endl;
+            musicEnabled = false;
+        } else {
+            Mix_VolumeMusic(musicVolume);
+            std::cout << "♪ Música activada: Funk It - Dyalla (Volumen: " << (musicVolume * 100 / 128) << "%)" << std::endl;
+        }
+    }
+};
+
+class Game {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    DrawBatch draw;
+    LayerCache layers;
+    TextRenderer font;
+    RedrawMode redrawMode;
+    bool surfaceRendering;    // Renderer por software sobre la superficie de la ventana
+    DirtyRegion dirty;
+    GameMode renderedMode;    // Modo y overlay del último frame, para redibujar todo al cambiar
+    bool renderedOverlay;
+    CaptureConfig captureConfig;
+    FrameCapture capture;
+    SDL_Texture* captureTarget; // Destino fuera de pantalla de la captura en vivo
+    double captureClock;        // Segundos acumulados hacia el siguiente frame capturado
+    Uint64 captureCounter;
+    FramePacer pacer;
+    FrameProfiler profiler;
+    InputSystem input;
+    bool inputDelay;
+    ReplayRecorder recorder;
+    std::string recordPath;
+    int recordedMatches;
+    ReplayReader replay;
+    bool replaying;
+    float replaySpeed;
+    int liveTickRate;     // Frecuencia a restaurar al terminar una repetición
+    // Paletas y colisión de la partida normal: la repetición impone las de su archivo
+    struct MatchSettings {
+        bool ai1, ai2;
+        AIParams params1, params2;
+        CollisionMode collisionMode;
+    };
+    MatchSettings liveSettings;
+    RollbackSession net;
+    NetConfig netConfig;
+    bool online;          // Partida en red (modo MULTIPLAYER con una paleta remota)
+    bool onlineStarted;
+    int onlineScore1, onlineScore2;
+    Broadcaster broadcaster;
+    std::string broadcastPath;
+    SpectatorClient spectator;
+    std::string spectatePath;
+    bool spectating;
+    std::deque<BroadcastSnapshot> spectatorQueue; // Ticks recibidos aún sin mostrar
+    std::string profileCsvPath;
+    bool running;
+    GameMode currentMode;
+    Match match;
+    
+    // Simulación a paso fijo: estado del tick anterior para interpolar al renderizar
+    Paddle prevPlayer1, prevPlayer2;
+    Ball prevBall;
+    int tickRate;
+    float tickDelta;
+    PhysicsReal stepDelta;  // tickDelta en el tipo de la física (coma fija sin pasar por float)
+    double accumulator;
+    float renderAlpha;
+    Uint64 lastCounter;
+    AudioManager audioManager;
+    int selectedMenuOption;
+    StartupTrace trace;       // Etapas del arranque hasta el primer frame y las diferidas
+    
+public:
+    Game() : window(nullptr), renderer(nullptr), redrawMode(REDRAW_AUTO), surfaceRendering(false),
+             renderedMode(MENU), renderedOverlay(false), captureTarget(nullptr), captureClock(0.0),
+             captureCounter(0), inputDelay(false), recordedMatches(0),
+             replaying(false), replaySpeed(1.0f), liveTickRate(DEFAULT_TICK_RATE), online(false),
+             onlineStarted(false), onlineScore1(0), onlineScore2(0), spectating(false), running(true),
+             currentMode(MENU),
+             prevPlayer1(match.player1), prevPlayer2(match.player2), prevBall(match.ball),
+             tickRate(DEFAULT_TICK_RATE), tickDelta(1.0f / DEFAULT_TICK_RATE),
+             stepDelta(physicsDelta(DEFAULT_TICK_RATE)),
+             accumulator(0.0), renderAlpha(0.0f), lastCounter(0), selectedMenuOption(0) {
+        audioManager.setStartupTrace(&trace);
+    }
+    
+    void setTickRate(int rate) {
+        if (rate < MIN_TICK_RATE) rate = MIN_TICK_RATE;
+        if (rate > MAX_TICK_RATE) rate = MAX_TICK_RATE;
+        tickRate = rate;
+        tickDelta = 1.0f / rate;
+        stepDelta = physicsDelta(rate);
+        broadcaster.setTickRate(rate);
+    }
+    
+    int getTickRate() const {
+        return tickRate;
+    }
+    
+    void setAIParams(const AIParams& params) {
+        match.player2.ai = params;
+    }
+    
+    void setFramePacing(const FramePacingConfig& config) {
+        pacer.configure(config.mode, config.fpsCap);
+        inputDelay = config.inputDelay;
+    }
+    
+    // Mide la latencia desde cada evento de entrada hasta el present que lo muestra
+    void setLatencyMeasurement(bool enabled) {
+        input.setLatencyMeasurement(enabled);
+    }
+    
+    // Graba cada partida: la primera en path y las siguientes numeradas (partida-2.rpl...)
+    void setRecordPath(const std::string& path) {
+        recordPath = path;
+    }
+    
+    // Juega en red: como anfitrión o uniéndose a la dirección de config
+    void setNetwork(const NetConfig& config) {
+        netConfig = config;
+        online = true;
+    }
+    
+    // Emite cada tick a los espectadores por el socket local path
+    void setBroadcast(const std::string& path) {
+        broadcastPath = path;
+    }
+    
+    // Muestra la partida que emite otro proceso en path
+    void setSpectate(const std::string& path) {
+        spectatePath = path;
+        spectating = true;
+    }
+    
+    // Redibujado completo o parcial (--redraw); llamar antes de init()
+    void setRedrawMode(RedrawMode mode) {
+        redrawMode = mode;
+    }
+    
+    // Graba las partidas de la ventana a vídeo o imágenes; llamar antes de init()
+    void setCapture(const CaptureConfig& config) {
+        captureConfig = config;
+    }
+    
+    // Muestras por buffer de audio; llamar antes de init()
+    void setAudioBuffer(int samples) {
+        audioManager.setBufferSize(samples);
+    }
+    
+    // Mide cada frame desde el inicio y vuelca el perfil a CSV al salir
+    void setProfileCSV(const std::string& path) {
+        profileCsvPath = path;
+        profiler.setRecordFrames(!path.empty());
+    }
+    
+    // Imprime el desglose del arranque con tiempos (--startup-trace)
+    void setStartupTrace(bool enabled) {
+        trace.setEnabled(enabled);
+    }
+    
+    // Lo imprescindible para el primer frame (vídeo, ventana, renderer) va primero y el frame
+    // se presenta antes de volver; los mandos se inicializan justo después y el audio cuando
+    // haga falta (AudioManager::prepare), en un hilo aparte.
+    bool init() {
+        trace.restart();
+        StartupTrace::Clock::time_point stage = StartupTrace::now();
+        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+            std::cout << "Error inicializando SDL: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        trace.record("SDL_Init (vídeo)", stage);
+        
+        stage = StartupTrace::now();
+        window = SDL_CreateWindow("Pong Game - Menú Principal", 
+                                SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                WINDOW_WIDTH, WINDOW_HEIGHT, 
+                                SDL_WINDOW_SHOWN);
+        
+        if (!window) {
+            std::cout << "Error creando ventana: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        trace.record("ventana", stage);
+        
+        stage = StartupTrace::now();
+        Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+        if (pacer.getMode() == PACING_VSYNC) {
+            rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+        }
+        renderer = SDL_CreateRenderer(window, -1, rendererFlags);
+        // Sin GPU, SDL no encuentra renderer acelerado o da uno por software que repinta la
+        // ventana entera en cada present: mejor dibujar en su superficie y presentar solo lo que cambia
+        if (!captureConfig.path.empty() && redrawMode != REDRAW_FULL) {
+            // La captura lee cada frame completo de su textura: sin redibujado parcial
+            redrawMode = REDRAW_FULL;
+        }
+        SDL_RendererInfo created;
+        bool software = !renderer || (SDL_GetRendererInfo(renderer, &created) == 0 &&
+                                      (created.flags & SDL_RENDERER_SOFTWARE));
+        if (redrawMode == REDRAW_DIRTY || (software && redrawMode == REDRAW_AUTO)) {
+            createSurfaceRenderer();
+        } else if (!renderer) {
+            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+        }
+        if (!renderer) {
+            std::cout << "Error creando renderer: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        
+        SDL_DisplayMode displayMode;
+        int refreshRate = 60;
+        if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &displayMode) == 0 &&
+            displayMode.refresh_rate > 0) {
+            refreshRate = displayMode.refresh_rate;
+        }
+        
+        // Si el driver ignora el vsync, limitar a la frecuencia de refresco de la pantalla
+        SDL_RendererInfo info;
+        if (pacer.getMode() == PACING_VSYNC &&
+            (SDL_GetRendererInfo(renderer, &info) != 0 || !(info.flags & SDL_RENDERER_PRESENTVSYNC))) {
+            std::cout << "Advertencia: vsync no disponible, limitando a " << refreshRate << " FPS" << std::endl;
+            pacer.configure(PACING_CAP, refreshRate);
+        }
+        if (inputDelay) {
+            pacer.enableInputDelay(refreshRate);
+        }
+        
+        trace.record("renderer", stage);
+        
+        stage = StartupTrace::now();
+        attachRenderer(renderer);
+        trace.record("capas y fuente", stage);
+        
+        if (!captureConfig.path.empty()) {
+            captureTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                              WINDOW_WIDTH, WINDOW_HEIGHT);
+            if (!captureTarget) {
+                std::cout << "Error creando la textura de captura: " << SDL_GetError() << std::endl;
+                return false;
+            }
+            if (!capture.open(captureConfig, WINDOW_WIDTH, WINDOW_HEIGHT, false)) {
+                return false;
+            }
+        }
+        
+        stage = StartupTrace::now();
+        if (online) {
+            if (!net.start(netConfig, tickRate)) {
+                return false;
+            }
+            currentMode = MULTIPLAYER;
+            lastCounter = SDL_GetPerformanceCounter();
+            SDL_SetWindowTitle(window, "Pong - En red");
+        }
+        if (!broadcastPath.empty() && !broadcaster.open(broadcastPath, tickRate)) {
+            return false;
+        }
+        if (spectating) {
+            if (!spectator.open(spectatePath)) {
+                return false;
+            }
+            liveTickRate = tickRate;
+            currentMode = MULTIPLAYER;
+            resetGame();
+            SDL_SetWindowTitle(window, "Pong - Espectador");
+        }
+        if (online || !broadcastPath.empty() || spectating) {
+            trace.record("sockets", stage);
+        }
+        
+        stage = StartupTrace::now();
+        render();
+        presentFrame();
+        trace.record("primer frame (render)", stage);
+        double firstFrameMs = trace.elapsedMs();
+        std::cout << "Primer frame: " << (int)firstFrameMs << " ms desde el inicio" << std::endl;
+        trace.reportFirstFrame(firstFrameMs);
+        
+        // Los mandos no hacen falta para el menú: enumerarlos puede tardar (HIDAPI, udev).
+        // Van antes de abrir el audio para no inicializar subsistemas desde dos hilos a la vez.
+        stage = StartupTrace::now();
+        if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) < 0) {
+            std::cout << "Advertencia: mandos no disponibles: " << SDL_GetError() << std::endl;
+        } else {
+            input.init();
+        }
+        trace.record("mandos", stage);
+        
+        return true;
+    }
+    
+    // Renderer por software que dibuja directamente en la superficie de la ventana: lo
+    // dibujado se conserva entre frames y SDL_UpdateWindowSurfaceRects copia solo lo que cambió
+    void createSurfaceRenderer() {
+        if (renderer) {
+            SDL_DestroyRenderer(renderer);
+            renderer = nullptr;
+        }
+        SDL_Surface* surface = SDL_GetWindowSurface(window);
+        if (surface) {
+            renderer = SDL_CreateSoftwareRenderer(surface);
+        }
+        if (!renderer) {
+            std::cout << "Advertencia: sin redibujado parcial: " << SDL_GetError() << std::endl;
+            renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+            return;
+        }
+        surfaceRendering = true;
+        dirty.init(WINDOW_WIDTH, WINDOW_HEIGHT);
+        std::cout << "Renderer por software: redibujado parcial activado" << std::endl;
+    }
+    
+    // Prepara los recursos de dibujo para un renderer (el de la ventana o uno sin ventana).
+    // El juego pasa a ser su dueño y lo destruye en cleanup().
+    void attachRenderer(SDL_Renderer* target) {
+        renderer = target;
+        layers.init(renderer, &draw, WINDOW_WIDTH, WINDOW_HEIGHT);
+        font.init(renderer);
+    }
+    
+    void returnToMenu() {
+        recorder.finish();
+        if (online) {
+            net.stop(); // La partida en red termina al volver al menú
+            online = false;
+        }
+        if (replaying) {
+            replaying = false;
+            setTickRate(liveTickRate);
+            match.player1.isAI = liveSettings.ai1;
+            match.player2.isAI = liveSettings.ai2;
+            match.player1.ai = liveSettings.params1;
+            match.player2.ai = liveSettings.params2;
+            match.collisionMode = liveSettings.collisionMode;
+        }
+        if (spectating) {
+            spectator.close();
+            spectatorQueue.clear();
+            spectating = false;
+            setTickRate(liveTickRate);
+        }
+        currentMode = MENU;
+        if (window) {
+            SDL_SetWindowTitle(window, "Pong Game - Menú Principal");
+        }
+    }
+    
+    // Empieza una partida desde el menú
+    void startMode(GameMode mode) {
+        currentMode = mode;
+        match.player2.isAI = (mode == SINGLE_PLAYER);
+        resetGame();
+        if (!recordPath.empty()) {
+            recorder.start(numberedReplayPath(recordPath, ++recordedMatches), match, tickRate);
+        }
+        if (window) {
+            SDL_SetWindowTitle(window, mode == SINGLE_PLAYER ? "Pong - Vs IA" : "Pong - Multijugador");
+        }
+    }
+    
+    // Reproduce una repetición en la ventana desde startTick; speed multiplica el tiempo real
+    bool startReplay(const std::string& path, float speed, long startTick = 0) {
+        if (!replay.open(path)) {
+            return false;
+        }
+        const ReplayHeader& header = replay.getHeader();
+        if (!replay.usesPhysics<PhysicsReal>()) {
+            std::cout << "La repetición " << path << " se grabó con física en "
+                      << (header.fixedPoint ? "coma fija" : "float")
+                      << "; esta compilación no puede mostrarla (--headless --replay sí la comprueba)" << std::endl;
+            return false;
+        }
+        if (!replaying) {
+            liveTickRate = tickRate;
+            liveSettings.ai1 = match.player1.isAI;
+            liveSettings.ai2 = match.player2.isAI;
+            liveSettings.params1 = match.player1.ai;
+            liveSettings.params2 = match.player2.ai;
+            liveSettings.collisionMode = match.collisionMode;
+        }
+        setTickRate(header.tickRate);
+        currentMode = (header.ai2 && !header.ai1) ? SINGLE_PLAYER : MULTIPLAYER;
+        resetGame();
+        replay.restoreInitialState(match);
+        if (startTick > 0) {
+            replay.seek(match, startTick);
+        }
+        savePreviousState();
+        replaying = true;
+        replaySpeed = speed > 0.0f ? speed : 1.0f;
+        if (window) {
+            SDL_SetWindowTitle(window, "Pong - Repetición");
+        }
+        std::cout << "Reproduciendo " << path << " a " << replaySpeed << "x" << std::endl;
+        return true;
+    }
+    
+    void handleEvents() {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            input.handleEvent(event);
+            if (event.type == SDL_QUIT) {
+                running = false;
+            }
+            if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+                layers.invalidateAll(); // El contenido de las texturas de render se ha perdido
+                font.clearCache();
+                dirty.invalidate();
+            }
+            if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                dirty.invalidate(); // La ventana estuvo tapada: su superficie hay que repintarla entera
+            }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) {
+                profiler.toggleOverlay();
+            }
+            
+            if (currentMode == MENU) {
+                handleMenuEvents(event);
+            } else {
+                handleGameEvents(event);
+            }
+        }
+    }
+    
+    void handleMenuEvents(SDL_Event& event) {
+        if (event.type == SDL_KEYDOWN) {
+            switch (event.key.keysym.sym) {
+                case SDLK_UP:
+                    selectedMenuOption = (selectedMenuOption - 1 + 2) % 2;
+                    layers.invalidate(LAYER_MENU);
+                    break;
+                case SDLK_DOWN:
+                    selectedMenuOption = (selectedMenuOption + 1) % 2;
+                    layers.invalidate(LAYER_MENU);
+                    break;
+                case SDLK_RETURN:
+                    switch (selectedMenuOption) {
+                        case 0: // Multijugador
+                            startMode(MULTIPLAYER);
+                            break;
+                        case 1: // Vs IA
+                            startMode(SINGLE_PLAYER);
+                            break;
+                    }
+                    break;
+                case SDLK_ESCAPE:
+                    running = false;
+                    break;
+            }
+        }
+    }
+    
+    void handleGameEvents(SDL_Event& event) {
+        if (event.type == SDL_KEYDOWN) {
+            if (event.key.keysym.sym == SDLK_ESCAPE) {
+                returnToMenu();
+            } else if (replaying && (event.key.keysym.sym == SDLK_LEFT || event.key.keysym.sym == SDLK_RIGHT)) {
+                // Saltar 5 s atrás o adelante en la repetición
+                long step = (long)REPLAY_KEYFRAME_SECONDS * tickRate;
+                seekReplay(replay.getTicksRead() + (event.key.keysym.sym == SDLK_LEFT ? -step : step));
+            } else if (event.key.keysym.sym == SDLK_m) {
+                audioManager.toggleMusic();
+                layers.invalidate(LAYER_GAME_HUD); // Indicador de música
+            } else if (event.key.keysym.sym == SDLK_PLUS || event.key.keysym.sym == SDLK_EQUALS) {
+                audioManager.increaseVolume();
+            } else if (event.key.keysym.sym == SDLK_MINUS) {
+                audioManager.decreaseVolume();
+            }
+        }
+    }
+    
+    void resetGame() {
+        match.reset();
+        input.reset();
+        broadcaster.requestKeyframe();
+        layers.invalidate(LAYER_GAME_HUD); // Marcador a cero y etiquetas del modo
+        savePreviousState();
+        
+        // El tiempo pasado en el menú no debe contar para la simulación
+        accumulator = 0.0;
+        renderAlpha = 0.0f;
+        lastCounter = SDL_GetPerformanceCounter();
+    }
+    
+    void savePreviousState() {
+        prevPlayer1 = match.player1;
+        prevPlayer2 = match.player2;
+        prevBall = match.ball;
+    }
+    
+    void update() {
+        if (audioManager.update()) {
+            layers.invalidate(LAYER_GAME_HUD); // Indicador de música
+        }
+        if (currentMode == MENU) {
+            return; // No hay lógica de juego en el menú
+        }
+        audioManager.prepare(); // Primera partida: abrir el audio para los efectos
+        if (online && !updateConnection()) {
+            return;
+        }
+        
+        Uint64 currentCounter = SDL_GetPerformanceCounter();
+        double frameTime = (double)(currentCounter - lastCounter) / SDL_GetPerformanceFrequency();
+        lastCounter = currentCounter;
+        
+        // Un frame muy lento no debe convertirse en un paso enorme: se descarta el exceso
+        if (frameTime > MAX_FRAME_TIME) {
+            frameTime = MAX_FRAME_TIME;
+        }
+        accumulator += replaying ? frameTime * replaySpeed : frameTime;
+        if (spectating) {
+            pollSpectator();
+        }
+        
+        // Cada tick aplica la entrada ocurrida hasta su final (en el reloj de SDL_GetTicks)
+        double nowMs = SDL_GetTicks();
+        while (accumulator >= tickDelta) {
+            accumulator -= tickDelta;
+            savePreviousState();
+            if (replaying) {
+                if (!replayTick()) {
+                    finishReplay();
+                    return;
+                }
+                continue;
+            }
+            if (spectating) {
+                if (!spectatorTick()) {
+                    accumulator = 0.0; // Sin ticks recibidos: esperar sin acumular retraso
+                    break;
+                }
+                continue;
+            }
+            
+            input.advanceTo(nowMs - accumulator * 1000.0, accumulator < tickDelta);
+            if (online) {
+                // Puede re-simular ticks anteriores o esperar al rival
+                match.events = 0; // Si espera al rival no hay tick nuevo que suene
+                net.advance(match, input.getCombinedInput());
+                audioManager.playEvents(match.events);
+                broadcaster.publish(match);
+            } else {
+                // En modo IA la paleta 2 tiene isAI y Match ignora su entrada
+                simulateTick(stepDelta, input.getInput(0), input.getInput(1));
+            }
+            input.endTick();
+        }
+        if (online) {
+            // Un rollback puede cambiar el marcador hacia delante o hacia atrás
+            if (match.score1 != onlineScore1 || match.score2 != onlineScore2) {
+                onlineScore1 = match.score1;
+                onlineScore2 = match.score2;
+                layers.invalidate(LAYER_GAME_HUD);
+            }
+            net.endFrame();
+        }
+        
+        // Fracción del siguiente tick ya transcurrida, usada para interpolar el render
+        renderAlpha = (float)(accumulator / tickDelta);
+    }
+    
+    // Red: recibe paquetes y empieza la partida al conectar. false mientras no haya partida.
+    bool updateConnection() {
+        net.beginFrame();
+        net.poll();
+        if (net.isFinished()) {
+            returnToMenu();
+            return false;
+        }
+        if (!net.isConnected()) {
+            lastCounter = SDL_GetPerformanceCounter(); // La espera no cuenta como tiempo de juego
+            return false;
+        }
+        if (!onlineStarted) {
+            onlineStarted = true;
+            setTickRate(net.getTickRate());
+            match.player1.isAI = false;
+            match.player2.isAI = false;
+            resetGame();
+            onlineScore1 = onlineScore2 = 0;
+            std::cout << "Partida en red: juegas con la paleta " << (net.getLocalPlayer() == 0 ? "izquierda" : "derecha") << std::endl;
+            if (window) {
+                SDL_SetWindowTitle(window, net.getLocalPlayer() == 0 ? "Pong - En red (jugador 1)" : "Pong - En red (jugador 2)");
+            }
+        }
+        return true;
+    }
+    
+    void simulateTick(PhysicsReal deltaTime, const PaddleInput& input1, const PaddleInput& input2) {
+        PointScored point = match.step(deltaTime, input1, input2);
+        audioManager.playEvents(match.events);
+        if (recorder.isRecording()) {
+            recorder.recordTick(input1, input2, match);
+        }
+        broadcaster.publish(match);
+        if (point != NO_POINT) {
+            prevBall = match.ball; // Teletransporte: no interpolar desde la posición anterior
+            layers.invalidate(LAYER_GAME_HUD);
+            if (currentMode == SINGLE_PLAYER) {
+                std::cout << "Jugador: " << match.score1 << " - IA: " << match.score2 << std::endl;
+            } else {
+                std::cout << "Jugador 1: " << match.score1 << " - Jugador 2: " << match.score2 << std::endl;
+            }
+        }
+    }
+    
+    // Simula el siguiente tick grabado; false al terminar la repetición
+    bool replayTick() {
+        PaddleInput input1, input2;
+        if (!replay.nextInputs(input1, input2)) {
+            return false;
+        }
+        simulateTick(stepDelta, input1, input2);
+        if (!replay.verify(match) && replay.getDesyncTick() == replay.getTicksRead() - 1) {
+            std::cout << "DESYNC en el tick " << replay.getDesyncTick() << std::endl;
+        }
+        return true;
+    }
+    
+    void seekReplay(long tick) {
+        replay.seek(match, tick);
+        broadcaster.requestKeyframe();
+        savePreviousState(); // Sin interpolar desde antes del salto
+        layers.invalidate(LAYER_GAME_HUD);
+    }
+    
+    // Lee la emisión; si se acumulan muchos ticks (el emisor va más rápido o hubo un parón)
+    // se descartan los más antiguos para no ver la partida con retraso creciente
+    void pollSpectator() {
+        spectator.poll(spectatorQueue);
+        if (spectator.getTickRate() != tickRate) {
+            setTickRate(spectator.getTickRate());
+        }
+        while (spectatorQueue.size() > SPECTATOR_MAX_BUFFER) {
+            bool keyframe = spectatorQueue.front().keyframe;
+            spectatorQueue.pop_front();
+            spectatorQueue.front().keyframe |= keyframe;
+        }
+    }
+    
+    // Muestra el siguiente tick recibido; false si no hay ninguno
+    bool spectatorTick() {
+        if (spectatorQueue.empty()) {
+            return false;
+        }
+        const BroadcastSnapshot& snapshot = spectatorQueue.front();
+        int score1 = match.score1, score2 = match.score2;
+        snapshot.applyTo(match);
+        if (snapshot.keyframe) {
+            savePreviousState(); // Saque o salto: no interpolar desde la posición anterior
+        }
+        if (match.score1 != score1 || match.score2 != score2) {
+            layers.invalidate(LAYER_GAME_HUD);
+        }
+        spectatorQueue.pop_front();
+        return true;
+    }
+    
+    void finishReplay() {
+        std::cout << "Repetición terminada: " << replay.getTicksRead() << " ticks, "
+                  << (replay.getDesyncTick() < 0 ? "sin desync" : "con desync") << std::endl;
+        returnToMenu();
+    }
+    
+    void render() {
+        if (surfaceRendering) {
+            renderDirty();
+            return;
+        }
+        
+        // Limpiar pantalla
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        drawScene();
+    }
+    
+    // Con captura, el frame se dibuja en la textura fuera de pantalla, se copia al anillo de
+    // la captura y se compone en la ventana
+    void renderFrame() {
+        if (!captureTarget) {
+            render();
+            return;
+        }
+        SDL_SetRenderTarget(renderer, captureTarget);
+        render();
+        if (currentMode != MENU) {
+            captureLiveFrame();
+        } else {
+            captureCounter = 0; // El tiempo en el menú no cuenta
+        }
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_RenderCopy(renderer, captureTarget, nullptr, nullptr);
+    }
+    
+    // El vídeo va a captureConfig.fps aunque la pantalla vaya a otro ritmo: se captura un
+    // frame por cada 1/fps de tiempo real (repitiendo el último si la pantalla va más lenta)
+    void captureLiveFrame() {
+        Uint64 now = SDL_GetPerformanceCounter();
+        double interval = 1.0 / capture.getFps();
+        if (captureCounter == 0) {
+            captureClock = interval; // Primer frame de la partida
+        } else {
+            captureClock += (double)(now - captureCounter) / SDL_GetPerformanceFrequency();
+        }
+        captureCounter = now;
+        for (int copies = 0; captureClock >= interval && copies < 4; copies++) {
+            capture.capture(renderer);
+            captureClock -= interval;
+        }
+        if (captureClock >= interval) {
+            captureClock = 0.0; // Tras un parón no se intenta recuperar el retraso
+        }
+    }
+    
+    // Exporta sin ventana ni GPU: renderer por software sobre una superficie en memoria y la
+    // repetición (o una partida IA contra IA de ticks ticks) simulada tan rápido como se
+    // pueda, con un frame cada tickRate/fps ticks. Aquí la captura espera al escritor en
+    // vez de descartar frames.
+    bool exportCapture(const CaptureConfig& config, const std::string& replayPath, long startTick, long ticks) {
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Renderer* target = surface ? SDL_CreateSoftwareRenderer(surface) : nullptr;
+        if (!target) {
+            std::cout << "Error creando el renderer por software: " << SDL_GetError() << std::endl;
+            if (surface) SDL_FreeSurface(surface);
+            return false;
+        }
+        attachRenderer(target);
+        
+        bool ok = true;
+        if (!replayPath.empty()) {
+            ok = startReplay(replayPath, 1.0f, startTick);
+        } else {
+            match.player1.isAI = true;
+            match.player1.ai = match.player2.ai;
+            startMode(SINGLE_PLAYER);
+            if (ticks <= 0) ticks = (long)tickRate * 30;
+        }
+        if (ok) {
+            ok = capture.open(config, WINDOW_WIDTH, WINDOW_HEIGHT, true);
+        }
+        if (ok) {
+            const PaddleInput none(false, false);
+            double framesPerTick = (double)capture.getFps() / tickRate;
+            double frameClock = 1.0; // El estado inicial es el primer frame
+            renderAlpha = 1.0f;      // Siempre el último tick, sin interpolar
+            for (long tick = 0; ; tick++) {
+                while (frameClock >= 1.0) {
+                    render();
+                    capture.capture(renderer);
+                    frameClock -= 1.0;
+                }
+                if (ticks > 0 && tick >= ticks) break;
+                if (replaying) {
+                    if (!replayTick()) break;
+                } else {
+                    simulateTick(stepDelta, none, none);
+                }
+                frameClock += framesPerTick;
+            }
+            capture.finish();
+            capture.printReport();
+        }
+        
+        replaying = false;
+        recorder.finish();
+        layers.cleanup();
+        font.cleanup();
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+        SDL_FreeSurface(surface);
+        return ok;
+    }
+    
+    // Todo lo visible del frame, sobre la pantalla ya limpia
+    void drawScene() {
+        // Las funciones de dibujo solo acumulan rectángulos; flush() los agrupa por color.
+        // Las partes estáticas salen de la caché de capas.
+        if (currentMode == MENU) {
+            layers.draw(LAYER_MENU, [this]() { renderMenu(); });
+        } else {
+            renderGame();
+        }
+        
+        if (profiler.isOverlayVisible()) {
+            drawProfilerOverlay();
+            draw.flush(renderer);
+        }
+    }
+    
+    // Redibujado parcial: la escena entera recortada a cada rectángulo que cambia. Solo se
+    // rasterizan los píxeles recortados, así que repintar la pelota cuesta lo que mide.
+    void renderDirty() {
+        markDirtyRegions();
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        if (dirty.isFullRedraw()) {
+            SDL_RenderSetClipRect(renderer, nullptr);
+            SDL_RenderClear(renderer);
+            drawScene();
+            return;
+        }
+        const SDL_Rect* rects = dirty.getRects();
+        for (int i = 0; i < dirty.getCount(); i++) {
+            SDL_RenderSetClipRect(renderer, &rects[i]);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderFillRect(renderer, &rects[i]); // SDL_RenderClear ignora el recorte
+            drawScene();
+        }
+        SDL_RenderSetClipRect(renderer, nullptr);
+    }
+    
+    // Qué cambia este frame: pelota y paletas (con su posición anterior), el HUD si se
+    // redibujó su capa y lo que se dibuja cada frame fuera de las capas
+    void markDirtyRegions() {
+        dirty.beginFrame();
+        bool overlay = profiler.isOverlayVisible();
+        if (currentMode != renderedMode || overlay != renderedOverlay || !layers.isEnabled() ||
+            (online && !net.isConnected()) || (spectating && !spectator.isSynced())) {
+            dirty.invalidate(); // Cambia toda la pantalla o hay textos centrados que no se siguen
+        }
+        renderedMode = currentMode;
+        renderedOverlay = overlay;
+        
+        // Las capas invalidadas se redibujan aquí, antes de recortar
+        if (currentMode == MENU) {
+            if (layers.prepare(LAYER_MENU, [this]() { renderMenu(); })) {
+                dirty.invalidate();
+            }
+        } else {
+            if (layers.prepare(LAYER_GAME_BACKGROUND, [this]() { drawGameBackground(); })) {
+                dirty.invalidate();
+            }
+            if (layers.prepare(LAYER_GAME_HUD, [this]() { drawHud(); })) {
+                // Marcador e indicador de música encima del campo, instrucciones debajo
+                SDL_Rect top = {0, 0, WINDOW_WIDTH, GAME_MARGIN_TOP};
+                SDL_Rect bottom = {0, GAME_MARGIN_TOP + GAME_HEIGHT, WINDOW_WIDTH, GAME_MARGIN_BOTTOM};
+                dirty.addArea(top);
+                dirty.addArea(bottom);
+            }
+            // Las paletas llevan el indicador de jugador a 8 px de cada lado
+            SDL_Rect paddle1 = match.player1.getInterpolatedRect(prevPlayer1, renderAlpha);
+            SDL_Rect paddle2 = match.player2.getInterpolatedRect(prevPlayer2, renderAlpha);
+            SDL_Rect ball = match.ball.getInterpolatedRect(prevBall, renderAlpha);
+            dirty.addSprite(inflateRect(paddle1, 8, 1));
+            dirty.addSprite(inflateRect(paddle2, 8, 1));
+            dirty.addSprite(inflateRect(ball, 1, 1));
+            if (online) {
+                SDL_Rect netInfo = {8, 8, 240, 12};
+                dirty.addArea(netInfo);
+            }
+        }
+        if (overlay) {
+            dirty.addArea(profilerPanelRect());
+        }
+        dirty.finish();
+    }
+    
+    static SDL_Rect inflateRect(const SDL_Rect& rect, int dx, int dy) {
+        SDL_Rect inflated = {rect.x - dx, rect.y - dy, rect.w + 2 * dx, rect.h + 2 * dy};
+        return inflated;
+    }
+    
+    // Con el renderer de la superficie, SDL_RenderPresent solo vacía la cola de comandos:
+    // la copia a la ventana se hace aquí, entera o solo de los rectángulos redibujados
+    void presentFrame() {
+        SDL_RenderPresent(renderer);
+        if (!surfaceRendering) {
+            return;
+        }
+        if (dirty.isFullRedraw()) {
+            SDL_UpdateWindowSurface(window);
+        } else if (dirty.getCount() > 0) {
+            SDL_UpdateWindowSurfaceRects(window, dirty.getRects(), dirty.getCount());
+        }
+    }
+    
+    SDL_Rect profilerPanelRect() const {
+        const int lineHeight = 10;
+        SDL_Rect panel = {10, 10, 222, (PHASE_COUNT + 2) * lineHeight + 8};
+        return panel;
+    }
+    
+    void drawProfilerOverlay() {
+        // Percentiles de los últimos frames por fase (F3), en milisegundos
+        const int lineHeight = 10;
+        SDL_Rect panel = profilerPanelRect();
+        draw.setColor(0, 0, 0, 255);
+        draw.fillRect(panel);
+        draw.setColor(100, 100, 100, 255);
+        draw.drawRect(panel);
+        
+        char line[64];
+        snprintf(line, sizeof(line), "%-8s %6s %6s %6s %6s", "fase", "p50", "p95", "p99", "max");
+        draw.setColor(255, 255, 0, 255);
+        drawSmallText(line, panel.x + 6, panel.y + 5);
+        
+        for (int phase = 0; phase <= FrameProfiler::TOTAL; phase++) {
+            PhaseStats stats = profiler.getStats(phase);
+            snprintf(line, sizeof(line), "%-8s %6.2f %6.2f %6.2f %6.2f",
+                     profilePhaseName(phase), stats.p50, stats.p95, stats.p99, stats.max);
+            draw.setColor(phase == FrameProfiler::TOTAL ? 255 : 100, 255, phase == FrameProfiler::TOTAL ? 255 : 100, 255);
+            drawSmallText(line, panel.x + 6, panel.y + 5 + (phase + 1) * lineHeight);
+        }
+    }
+    
+    void renderMenu() {
+        // Título simple y claro
+        draw.setColor(255, 255, 0, 255);
+        drawSimpleTitle();
+        
+        // Solo 2 opciones principales
+        const char* options[] = {
+            "MULTIJUGADOR",
+            "JUGAR vs IA"
+        };
+        
+        int startY = WINDOW_HEIGHT / 2 - 50;
+        
+        for (int i = 0; i < 2; i++) {
+            bool selected = (i == selectedMenuOption);
+            drawSimpleMenuOption(options[i], i, WINDOW_WIDTH / 2 - 120, startY + i * 60, selected); // Más a la izquierda para compensar el espaciado
+        }
+        
+        // Instrucciones simples
+        draw.setColor(150, 150, 150, 255);
+        drawCenteredText("Flechas: Navegar", WINDOW_HEIGHT - 80);
+        drawCenteredText("ENTER: Seleccionar", WINDOW_HEIGHT - 60);
+        drawCenteredText("ESC: Salir", WINDOW_HEIGHT - 40);
+    }
+    
+    void drawSimpleTitle() {
+        // Título "PONG" simple y grande
+        draw.setColor(255, 255, 0, 255);
+        
+        // P
+        SDL_Rect P[] = {
+            {WINDOW_WIDTH / 2 - 120, 100, 25, 5},   // Top
+            {WINDOW_WIDTH / 2 - 120, 100, 5, 60},   // Left
+            {WINDOW_WIDTH / 2 - 120, 125, 20, 5},   // Middle
+            {WINDOW_WIDTH / 2 - 100, 100, 5, 30}    // Right top
+        };
+        draw.fillRects(P, 4);
+        
+        // O
+        SDL_Rect O[] = {
+            {WINDOW_WIDTH / 2 - 80, 100, 25, 5},    // Top
+            {WINDOW_WIDTH / 2 - 80, 155, 25, 5},    // Bottom
+            {WINDOW_WIDTH / 2 - 80, 100, 5, 60},    // Left
+            {WINDOW_WIDTH / 2 - 60, 100, 5, 60}     // Right
+        };
+        draw.fillRects(O, 4);
+        
+        // N
+        SDL_Rect N[] = {
+            {WINDOW_WIDTH / 2 - 40, 100, 5, 60},    // Left
+            {WINDOW_WIDTH / 2 - 20, 100, 5, 60},    // Right
+            {WINDOW_WIDTH / 2 - 40, 110, 25, 5}     // Diagonal (simplified)
+        };
+        draw.fillRects(N, 3);
+        
+        // G
+        SDL_Rect G[] = {
+            {WINDOW_WIDTH / 2 + 20, 100, 25, 5},    // Top
+            {WINDOW_WIDTH / 2 + 20, 155, 25, 5},    // Bottom
+            {WINDOW_WIDTH / 2 + 20, 100, 5, 60},    // Left
+            {WINDOW_WIDTH / 2 + 40, 125, 5, 35},    // Right bottom
+            {WINDOW_WIDTH / 2 + 35, 125, 10, 5}     // Middle right
+        };
+        draw.fillRects(G, 5);
+    }
+    
+    void drawSimpleMenuOption(const char* text, int index, int x, int y, bool selected) {
+        // Fondo para opción seleccionada
+        if (selected) {
+            draw.setColor(0, 100, 200, 255);
+            SDL_Rect background = {x - 20, y - 10, 320, 40}; // Más ancho para el espaciado
+            draw.fillRect(background);
+            
+            // Flecha indicadora simple
+            draw.setColor(255, 255, 0, 255);
+            SDL_Rect arrow = {x - 15, y + 10, 10, 5};
+            draw.fillRect(arrow);
+        }
+        
+        // Color del texto
+        draw.setColor(selected ? 255 : 180, selected ? 255 : 180, selected ? 255 : 180, 255);
+        
+        // Dibujar texto usando la función mejorada
+        drawMenuText(text, x, y);
+    }
+    
+    // Texto con la fuente del atlas; todas usan el color actual del DrawBatch.
+    // Las opciones del menú y los textos centrados son siempre cadenas fijas (algunas se
+    // dibujan cada frame fuera de las capas), así que van cacheadas en una textura cada una
+    void drawMenuText(const char* text, int x, int y) {
+        font.drawCachedText(draw, text, x, y, 3);
+    }
+    
+    void drawSimpleText(const char* text, int x, int y) {
+        font.drawText(draw, text, x, y, 2);
+    }
+    
+    void drawCenteredText(const char* text, int y) {
+        font.drawCachedText(draw, text, WINDOW_WIDTH / 2 - TextRenderer::measure(text, 2) / 2, y, 2);
+    }
+    
+    void drawTextLine(const char* text, int x, int y) {
+        font.drawText(draw, text, x, y, 2);
+    }
+    
+    void drawSmallText(const char* text, int x, int y) {
+        font.drawText(draw, text, x, y, 1);
+    }
+    
+    void renderGame() {
+        layers.draw(LAYER_GAME_BACKGROUND, [this]() { drawGameBackground(); });
+        
+        // Dibujar paletas con efecto 3D (interpoladas entre los dos últimos ticks)
+        drawPaddle(match.player1.getInterpolatedRect(prevPlayer1, renderAlpha), true);  // Jugador 1
+        drawPaddle(match.player2.getInterpolatedRect(prevPlayer2, renderAlpha), false); // Jugador 2
+        
+        // Dibujar pelota con efecto
+        drawBall(match.ball.getInterpolatedRect(prevBall, renderAlpha));
+        draw.flush(renderer);
+        
+        layers.draw(LAYER_GAME_HUD, [this]() { drawHud(); });
+        
+        if (online) {
+            drawNetInfo();
+            draw.flush(renderer);
+        }
+        if (spectating && !spectator.isSynced()) {
+            draw.setColor(255, 255, 0, 255);
+            drawCenteredText("ESPERANDO LA EMISION...", WINDOW_HEIGHT / 2 - 40);
+            draw.flush(renderer);
+        }
+    }
+    
+    // Estado de la red: cambia cada frame, así que va fuera de las capas cacheadas
+    void drawNetInfo() {
+        if (!net.isConnected()) {
+            draw.setColor(255, 255, 0, 255);
+            drawCenteredText(netConfig.host ? "ESPERANDO AL RIVAL..." : "CONECTANDO...", WINDOW_HEIGHT / 2 - 40);
+            return;
+        }
+        char line[64];
+        snprintf(line, sizeof(line), "RTT %3.0f ms  rollback %2d  %5.1f us",
+                 net.getRttMs(), net.getLastDepth(), net.getLastCostUs());
+        draw.setColor(150, 150, 150, 255);
+        drawSmallText(line, 10, 10);
+    }
+    
+    void drawGameBackground() {
+        // Dibujar marco del área de juego
+        draw.setColor(100, 100, 100, 255);
+        SDL_Rect gameArea = {GAME_MARGIN_SIDES, GAME_MARGIN_TOP, GAME_WIDTH, GAME_HEIGHT};
+        draw.drawRect(gameArea);
+        
+        // Fondo del área de juego
+        draw.setColor(10, 10, 10, 255);
+        draw.fillRect(gameArea);
+        
+        // Dibujar línea central dentro del área de juego
+        draw.setColor(255, 255, 255, 255);
+        int centerX = WINDOW_WIDTH / 2;
+        for (int i = GAME_MARGIN_TOP; i < GAME_MARGIN_TOP + GAME_HEIGHT; i += 15) {
+            SDL_Rect lineSegment = {centerX - 1, i, 2, 8};
+            draw.fillRect(lineSegment);
+        }
+    }
+    
+    void drawHud() {
+        // Mostrar puntuación en la parte superior
+        drawScoreBoard();
+        
+        // Mostrar estado de la música si está activa
+        if (audioManager.isMusicEnabled() && audioManager.isMusicPlaying()) {
+            drawMusicIndicator();
+        }
+        
+        // Mostrar controles en la parte inferior
+        renderGameInstructions();
+    }
+    
+    void drawPaddle(SDL_Rect paddleRect, bool isPlayer1) {
+        // Efecto 3D para las paletas
+        draw.setColor(255, 255, 255, 255);
+        draw.fillRect(paddleRect);
+        
+        // Borde oscuro para efecto 3D
+        draw.setColor(200, 200, 200, 255);
+        draw.drawRect(paddleRect);
+        
+        // Líneas decorativas en el medio
+        int centerY = paddleRect.y + paddleRect.h / 2;
+        for (int i = -1; i <= 1; i++) {
+            SDL_Rect line = {paddleRect.x + 2, centerY + i * 6, paddleRect.w - 4, 1};
+            draw.setColor(150, 150, 150, 255);
+            draw.fillRect(line);
+        }
+        
+        // Indicador de jugador
+        draw.setColor(isPlayer1 ? 100 : 255, isPlayer1 ? 255 : 100, 100, 255);
+        SDL_Rect indicator = {
+            isPlayer1 ? paddleRect.x - 8 : paddleRect.x + paddleRect.w + 3,
+            paddleRect.y + paddleRect.h / 2 - 3,
+            5, 6
+        };
+        draw.fillRect(indicator);
+    }
+    
+    void drawBall(SDL_Rect ballRect) {
+        // Pelota con efecto brillante
+        draw.setColor(255, 255, 255, 255);
+        draw.fillRect(ballRect);
+        
+        // Borde
+        draw.setColor(200, 200, 200, 255);
+        draw.drawRect(ballRect);
+        
+        // Punto brillante en el centro
+        draw.setColor(255, 255, 255, 255);
+        SDL_Rect highlight = {
+            ballRect.x + ballRect.w / 2 - 1,
+            ballRect.y + ballRect.h / 2 - 1,
+            2, 2
+        };
+        draw.fillRect(highlight);
+    }
+    
+    void drawScoreBoard() {
+        // Fondo del marcador en la parte superior (opaco: se dibuja sin mezcla y la capa del
+        // HUD se compone con transparencia, así que el alfa se conserva tal cual)
+        draw.setColor(0, 0, 0, 255);
+        SDL_Rect scoreBackground = {WINDOW_WIDTH / 2 - 100, 15, 200, 50};
+        draw.fillRect(scoreBackground);
+        
+        // Marco del marcador
+        draw.setColor(100, 100, 100, 255);
+        draw.drawRect(scoreBackground);
+        
+        // Separador central
+        draw.setColor(255, 255, 255, 255);
+        SDL_Rect separator = {WINDOW_WIDTH / 2 - 1, 20, 2, 40};
+        draw.fillRect(separator);
+        
+        // Etiquetas de jugadores más pequeñas
+        draw.setColor(200, 200, 200, 255);
+        if (currentMode == SINGLE_PLAYER) {
+            drawSmallText("JUGADOR", WINDOW_WIDTH / 2 - 90, 25);
+            drawSmallText("IA", WINDOW_WIDTH / 2 + 50, 25);
+        } else {
+            drawSmallText("P1", WINDOW_WIDTH / 2 - 70, 25);
+            drawSmallText("P2", WINDOW_WIDTH / 2 + 50, 25);
+        }
+        
+        // Puntuación jugador 1 (izquierda)
+        draw.setColor(100, 255, 100, 255);
+        drawLargeDigit(match.score1, WINDOW_WIDTH / 2 - 60, 35);
+        
+        // Puntuación jugador 2 (derecha)  
+        draw.setColor(255, 100, 100, 255);
+        drawLargeDigit(match.score2, WINDOW_WIDTH / 2 + 30, 35);
+    }
+    
+    void drawLargeDigit(int number, int x, int y) {
+        // Convertir número a string y dibujar cada dígito
+        if (number > 9) {
+            drawDigitalDigit(number / 10, x - 15, y);
+            drawDigitalDigit(number % 10, x + 5, y);
+        } else {
+            drawDigitalDigit(number, x, y);
+        }
+    }
+    
+    void drawDigitalDigit(int digit, int x, int y) {
+        // Patrón simplificado para dígitos 0-9
+        bool segments[7]; // 7 segmentos: top, top-right, bottom-right, bottom, bottom-left, top-left, middle
+        
+        // Inicializar todos los segmentos como falsos
+        for (int i = 0; i < 7; i++) segments[i] = false;
+        
+        // Configurar segmentos según el dígito
+        switch (digit) {
+            case 0: segments[0] = segments[1] = segments[2] = segments[3] = segments[4] = segments[5] = true; break;
+            case 1: segments[1] = segments[2] = true; break;
+            case 2: segments[0] = segments[1] = segments[6] = segments[4] = segments[3] = true; break;
+            case 3: segments[0] = segments[1] = segments[6] = segments[2] = segments[3] = true; break;
+            case 4: segments[5] = segments[6] = segments[1] = segments[2] = true; break;
+            case 5: segments[0] = segments[5] = segments[6] = segments[2] = segments[3] = true; break;
+            case 6: segments[0] = segments[5] = segments[4] = segments[3] = segments[2] = segments[6] = true; break;
+            case 7: segments[0] = segments[1] = segments[2] = true; break;
+            case 8: for (int i = 0; i < 7; i++) segments[i] = true; break;
+            case 9: segments[0] = segments[1] = segments[2] = segments[3] = segments[5] = segments[6] = true; break;
+        }
+        
+        // Dibujar segmentos activos
+        if (segments[0]) { // top
+            SDL_Rect seg = {x, y, 15, 2};
+            draw.fillRect(seg);
+        }
+        if (segments[1]) { // top-right
+            SDL_Rect seg = {x + 13, y, 2, 8};
+            draw.fillRect(seg);
+        }
+        if (segments[2]) { // bottom-right
+            SDL_Rect seg = {x + 13, y + 10, 2, 8};
+            draw.fillRect(seg);
+        }
+        if (segments[3]) { // bottom
+            SDL_Rect seg = {x, y + 16, 15, 2};
+            draw.fillRect(seg);
+        }
+        if (segments[4]) { // bottom-left
+            SDL_Rect seg = {x, y + 10, 2, 8};
+            draw.fillRect(seg);
+        }
+        if (segments[5]) { // top-left
+            SDL_Rect seg = {x, y, 2, 8};
+            draw.fillRect(seg);
+        }
+        if (segments[6]) { // middle
+            SDL_Rect seg = {x, y + 8, 15, 2};
+            draw.fillRect(seg);
+        }
+    }
+    
+    void drawMusicIndicator() {
+        // Indicador de música activa en la esquina superior derecha
+        draw.setColor(100, 255, 100, 255);
+        SDL_Rect musicIcon = {WINDOW_WIDTH - 30, 10, 20, 15};
+        draw.drawRect(musicIcon);
+        
+        // Notas musicales simuladas
+        SDL_Rect note1 = {WINDOW_WIDTH - 28, 12, 3, 3};
+        SDL_Rect note2 = {WINDOW_WIDTH - 20, 15, 3, 3};
+        SDL_Rect note3 = {WINDOW_WIDTH - 12, 12, 3, 3};
+        draw.fillRect(note1);
+        draw.fillRect(note2);
+        draw.fillRect(note3);
+    }
+    
+    void renderGameInstructions() {
+        // Fondo para las instrucciones en la parte inferior (opaco, ver drawScoreBoard)
+        draw.setColor(0, 0, 0, 255);
+        SDL_Rect instructionBg = {10, GAME_MARGIN_TOP + GAME_HEIGHT + 10, WINDOW_WIDTH - 20, 40};
+        draw.fillRect(instructionBg);
+        
+        // Marco
+        draw.setColor(100, 100, 100, 255);
+        draw.drawRect(instructionBg);
+        
+        // Instrucciones compactas según el modo
+        draw.setColor(200, 200, 200, 255);
+        int textY = GAME_MARGIN_TOP + GAME_HEIGHT + 20;
+        
+        if (currentMode == SINGLE_PLAYER) {
+            drawSmallText("W/S: Mover", 20, textY);
+            drawSmallText("M: Musica", 150, textY);
+            drawSmallText("+/-: Volumen", 250, textY);
+            drawSmallText("ESC: Menu", 380, textY);
+        } else {
+            drawSmallText("P1: W/S", 20, textY);
+            drawSmallText("P2: Flechas", 120, textY);
+            drawSmallText("M: Musica", 250, textY);
+            drawSmallText("ESC: Menu", 350, textY);
+        }
+    }
+    
+    void run() {
+        pacer.start();
+        while (running) {
+            profiler.beginFrame();
+            pacer.beginFrame(); // Con retraso de entrada, espera hasta poco antes del refresco
+            profiler.endPhase(PHASE_WAIT);
+            handleEvents();
+            profiler.endPhase(PHASE_EVENTS);
+            update();
+            profiler.endPhase(PHASE_UPDATE);
+            renderFrame();
+            profiler.endPhase(PHASE_RENDER);
+            pacer.markSubmit();
+            presentFrame();
+            input.onPresent();
+            profiler.endPhase(PHASE_PRESENT);
+            pacer.endFrame(); // Espera al siguiente frame según el modo (vsync, límite o nada)
+            profiler.endPhase(PHASE_WAIT);
+            profiler.endFrame();
+        }
+        capture.finish(); // Escribe los frames pendientes
+        capture.printReport();
+        pacer.printReport();
+        if (surfaceRendering) {
+            dirty.printReport();
+        }
+        input.printLatencyReport();
+        audioManager.printReport();
+        net.printReport();
+        broadcaster.printReport();
+        spectator.printReport();
+        if (!profileCsvPath.empty()) {
+            profiler.writeCSV(profileCsvPath);
+        }
+    }
+    
+    void cleanup() {
+        recorder.finish();
+        net.stop();
+        broadcaster.close();
+        spectator.close();
+        audioManager.cleanup();
+        capture.finish();
+        if (captureTarget) {
+            SDL_DestroyTexture(captureTarget);
+            captureTarget = nullptr;
+        }
+        input.cleanup();
+        layers.cleanup();
+        font.cleanup();
+        if (renderer) {
+            SDL_DestroyRenderer(renderer);
+        }
+        if (window) {
+            SDL_DestroyWindow(window);
+        }
+        SDL_Quit();
+    }
+};
+
+#endif
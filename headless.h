@@ -0,0 +1,177 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// Modo headless: partidas sin ventana, renderer ni audio, tan rápido como permita la CPU.
+// Usa exactamente la misma lógica de Match/Paddle/Ball que el juego con ventana.
+
+#include "pong_core.h"
+#include "replay.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdint.h>
+
+enum PaddleController {
+    CONTROL_AI,     // Paddle::updateAI()
+    CONTROL_IDLE,   // No se mueve
+    CONTROL_SWEEP,  // Sube y baja de pared a pared
+    CONTROL_RANDOM  // Cambia de dirección al azar (semilla reproducible)
+};
+
+inline const char* paddleControllerName(PaddleController controller) {
+    switch (controller) {
+        case CONTROL_AI: return "ai";
+        case CONTROL_IDLE: return "idle";
+        case CONTROL_SWEEP: return "sweep";
+        case CONTROL_RANDOM: return "random";
+    }
+    return "?";
+}
+
+inline bool parsePaddleController(const char* name, PaddleController& controller) {
+    if (strcmp(name, "ai") == 0) controller = CONTROL_AI;
+    else if (strcmp(name, "idle") == 0) controller = CONTROL_IDLE;
+    else if (strcmp(name, "sweep") == 0) controller = CONTROL_SWEEP;
+    else if (strcmp(name, "random") == 0) controller = CONTROL_RANDOM;
+    else return false;
+    return true;
+}
+
+// Genera la entrada de una paleta controlada por script
+class ScriptedInput {
+private:
+    PaddleController controller;
+    XorShift32 rng;
+    bool movingUp;
+    int holdTicks;
+    
+public:
+    ScriptedInput(PaddleController mode = CONTROL_IDLE, uint32_t seed = 1) :
+        controller(mode), rng(seed), movingUp(false), holdTicks(0) {}
+    
+    PaddleInput next(const Paddle& paddle) {
+        switch (controller) {
+            case CONTROL_SWEEP:
+                if (paddle.y <= GAME_MARGIN_TOP) movingUp = false;
+                if (paddle.y >= GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT) movingUp = true;
+                return PaddleInput(movingUp, !movingUp);
+            case CONTROL_RANDOM: {
+                if (holdTicks <= 0) {
+                    uint32_t r = rng.next();
+                    movingUp = (r & 1) != 0;
+                    holdTicks = 10 + (int)((r >> 1) % 50);
+                }
+                holdTicks--;
+                return PaddleInput(movingUp, !movingUp);
+            }
+            default:
+                return PaddleInput();
+        }
+    }
+};
+
+struct HeadlessConfig {
+    int matches;
+    long ticksPerMatch;
+    int tickRate;
+    PaddleController left, right;
+    AIParams ai;  // Parámetros de las paletas con CONTROL_AI
+    uint32_t seed;
+    std::string recordPath;  // Graba la primera partida como repetición
+    
+    HeadlessConfig() : matches(1), ticksPerMatch(100000), tickRate(DEFAULT_TICK_RATE),
+                       left(CONTROL_AI), right(CONTROL_AI), seed(1) {}
+};
+
+struct HeadlessStats {
+    long long ticks;
+    long long points1, points2;
+    long long rallies;
+    long long rallyHits;
+    double seconds;
+    
+    HeadlessStats() : ticks(0), points1(0), points2(0), rallies(0), rallyHits(0), seconds(0.0) {}
+    
+    double ticksPerSecond() const {
+        return seconds > 0.0 ? ticks / seconds : 0.0;
+    }
+    
+    double averageRally() const {
+        return rallies > 0 ? (double)rallyHits / rallies : 0.0;
+    }
+};
+
+class HeadlessRunner {
+private:
+    HeadlessConfig config;
+    
+public:
+    explicit HeadlessRunner(const HeadlessConfig& cfg) : config(cfg) {}
+    
+    // Simula una partida completa de config.ticksPerMatch ticks y acumula en stats
+    static void runMatch(const HeadlessConfig& config, uint32_t seed, HeadlessStats& stats,
+                         ReplayRecorder* recorder = nullptr) {
+        Match match;
+        match.player1.isAI = (config.left == CONTROL_AI);
+        match.player2.isAI = (config.right == CONTROL_AI);
+        match.player1.ai = config.ai;
+        match.player2.ai = config.ai;
+        match.reset();
+        
+        ScriptedInput script1(config.left, seed * 2 + 1);
+        ScriptedInput script2(config.right, seed * 2 + 2);
+        PhysicsReal deltaTime = physicsDelta(config.tickRate);
+        if (recorder) {
+            recorder->start(config.recordPath, match, config.tickRate);
+        }
+        
+        for (long t = 0; t < config.ticksPerMatch; t++) {
+            PaddleInput input1 = script1.next(match.player1);
+            PaddleInput input2 = script2.next(match.player2);
+            PointScored point = match.step(deltaTime, input1, input2);
+            if (recorder) {
+                recorder->recordTick(input1, input2, match);
+            }
+            if (point != NO_POINT) {
+                stats.rallies++;
+                stats.rallyHits += match.lastRallyLength;
+            }
+        }
+        if (recorder) {
+            recorder->finish();
+        }
+        
+        stats.ticks += config.ticksPerMatch;
+        stats.points1 += match.score1;
+        stats.points2 += match.score2;
+    }
+    
+    HeadlessStats run() {
+        HeadlessStats stats;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        
+        ReplayRecorder recorder;
+        for (int m = 0; m < config.matches; m++) {
+            bool record = (m == 0 && !config.recordPath.empty());
+            runMatch(config, config.seed + m, stats, record ? &recorder : nullptr);
+        }
+        
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        stats.seconds = std::chrono::duration<double>(end - start).count();
+        return stats;
+    }
+    
+    void printReport(const HeadlessStats& stats) const {
+        std::cout << "=== MODO HEADLESS ===" << '\n';
+        std::cout << "Partidas: " << config.matches << " x " << config.ticksPerMatch << " ticks"
+                  << " (" << config.tickRate << " ticks/s, "
+                  << paddleControllerName(config.left) << " vs " << paddleControllerName(config.right) << ")" << '\n';
+        std::cout << "Puntos: " << stats.points1 << " - " << stats.points2
+                  << " | Golpes por punto: " << stats.averageRally() << '\n';
+        std::cout << "Tiempo simulado: " << (double)stats.ticks / config.tickRate << " s"
+                  << " | Tiempo real: " << stats.seconds << " s" << '\n';
+        std::cout << "Rendimiento: " << (long long)stats.ticksPerSecond() << " ticks/s" << std::endl;
+    }
+};
+
+#endif
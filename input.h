@@ -0,0 +1,294 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// Entrada de baja latencia.
+// En lugar de leer SDL_GetKeyboardState una vez por frame, los eventos de teclado y mando
+// se guardan con su marca de tiempo de SDL y cada tick de simulación aplica solo los que
+// ocurrieron antes de su final; el último tick del frame aplica todo lo pendiente, así que
+// ninguna entrada espera al frame siguiente. Una pulsación más corta que un tick se
+// mantiene durante al menos un tick en vez de perderse.
+// Los mandos (SDL_GameController) mueven la paleta de forma analógica con el stick
+// izquierdo o digital con la cruceta: el primero es el jugador 1 y el segundo el jugador 2.
+// Con la medición activada se registra el tiempo desde cada evento hasta el present del
+// primer frame que lo muestra.
+
+#include "pong_core.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+class InputSystem {
+public:
+    static const int MAX_PLAYERS = 2;
+    static const int MAX_QUEUED = 256;     // Eventos sin consumir (p. ej. en pausa)
+
+    InputSystem() : measuring(false) {
+        for (int p = 0; p < MAX_PLAYERS; p++) {
+            controllers[p] = nullptr;
+            controllerIds[p] = -1;
+        }
+    }
+
+    // Abre los mandos ya conectados; los que se conecten después llegan como eventos
+    void init() {
+        for (int i = 0; i < SDL_NumJoysticks(); i++) {
+            if (SDL_IsGameController(i)) {
+                openController(i);
+            }
+        }
+    }
+
+    void setLatencyMeasurement(bool enabled) {
+        measuring = enabled;
+    }
+
+    // Recibe todos los eventos de SDL; guarda los que afectan a las paletas
+    void handleEvent(const SDL_Event& event) {
+        switch (event.type) {
+            case SDL_KEYDOWN:
+            case SDL_KEYUP: {
+                if (event.key.repeat) return;
+                int player, direction;
+                if (!mapKey(event.key.keysym.scancode, player, direction)) return;
+                queueEvent(event.key.timestamp, player, direction == -1 ? INPUT_UP : INPUT_DOWN,
+                           event.type == SDL_KEYDOWN ? 1.0f : 0.0f, SOURCE_KEYBOARD);
+                break;
+            }
+            case SDL_CONTROLLERBUTTONDOWN:
+            case SDL_CONTROLLERBUTTONUP: {
+                int player = controllerPlayer(event.cbutton.which);
+                if (player < 0) return;
+                int button = event.cbutton.button;
+                if (button != SDL_CONTROLLER_BUTTON_DPAD_UP && button != SDL_CONTROLLER_BUTTON_DPAD_DOWN) return;
+                queueEvent(event.cbutton.timestamp, player,
+                           button == SDL_CONTROLLER_BUTTON_DPAD_UP ? INPUT_UP : INPUT_DOWN,
+                           event.type == SDL_CONTROLLERBUTTONDOWN ? 1.0f : 0.0f, SOURCE_CONTROLLER);
+                break;
+            }
+            case SDL_CONTROLLERAXISMOTION: {
+                int player = controllerPlayer(event.caxis.which);
+                if (player < 0 || event.caxis.axis != SDL_CONTROLLER_AXIS_LEFTY) return;
+                queueEvent(event.caxis.timestamp, player, INPUT_AXIS, axisValue(event.caxis.value), SOURCE_CONTROLLER);
+                break;
+            }
+            case SDL_CONTROLLERDEVICEADDED:
+                openController(event.cdevice.which);
+                break;
+            case SDL_CONTROLLERDEVICEREMOVED:
+                closeController(event.cdevice.which);
+                break;
+        }
+    }
+
+    // Empieza una partida: lo recibido en el menú solo actualiza qué está pulsado
+    void reset() {
+        while (!queue.empty()) {
+            applyEvent(queue.front());
+            queue.pop_front();
+        }
+        endTick();
+        consumed.clear();
+    }
+
+    // Aplica los eventos ocurridos hasta timeMs (reloj de SDL_GetTicks); con lastTick, todos
+    void advanceTo(double timeMs, bool lastTick) {
+        while (!queue.empty() && (lastTick || queue.front().timestamp <= timeMs)) {
+            applyEvent(queue.front());
+            queue.pop_front();
+        }
+    }
+
+    PaddleInput getInput(int player) const {
+        const PlayerState& s = state[player];
+        PaddleInput input(s.up || s.upLatched, s.down || s.downLatched);
+        // La cruceta y el teclado tienen prioridad sobre el stick
+        if (!input.up && !input.down) {
+            input.axis = s.axis;
+        }
+        return input;
+    }
+
+    // En red solo hay una paleta local: vale cualquier tecla (W/S o flechas) y cualquier mando
+    PaddleInput getCombinedInput() const {
+        PaddleInput first = getInput(0), second = getInput(1);
+        PaddleInput input(first.up || second.up, first.down || second.down);
+        if (!input.up && !input.down) {
+            input.axis = first.axis != 0.0f ? first.axis : second.axis;
+        }
+        return input;
+    }
+    
+    // Tras cada tick: las pulsaciones ya vistas dejan de mantenerse
+    void endTick() {
+        for (int p = 0; p < MAX_PLAYERS; p++) {
+            state[p].upLatched = false;
+            state[p].downLatched = false;
+        }
+    }
+
+    // Llamar justo después de SDL_RenderPresent: el frame presentado ya refleja lo consumido
+    void onPresent() {
+        if (!measuring || consumed.empty()) return;
+        Uint32 now = SDL_GetTicks();
+        for (size_t i = 0; i < consumed.size(); i++) {
+            latencies.push_back((float)(now - consumed[i]));
+        }
+        consumed.clear();
+    }
+
+    void printLatencyReport() const {
+        if (!measuring) return;
+        std::cout << "=== Latencia entrada → present ===" << std::endl;
+        if (latencies.empty()) {
+            std::cout << "Sin muestras (no se movió ninguna paleta)" << std::endl;
+            return;
+        }
+        std::vector<float> sorted(latencies);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++) sum += sorted[i];
+        std::cout << "Muestras: " << sorted.size() << "  media " << sum / sorted.size() << " ms"
+                  << "  p50 " << sorted[sorted.size() / 2] << "  p95 " << sorted[sorted.size() * 95 / 100]
+                  << "  máx " << sorted.back() << " (resolución 1 ms)" << std::endl;
+    }
+
+    void cleanup() {
+        for (int p = 0; p < MAX_PLAYERS; p++) {
+            if (controllers[p]) {
+                SDL_GameControllerClose(controllers[p]);
+                controllers[p] = nullptr;
+                controllerIds[p] = -1;
+            }
+        }
+    }
+
+private:
+    enum InputKind { INPUT_UP, INPUT_DOWN, INPUT_AXIS };
+    enum InputSource { SOURCE_KEYBOARD, SOURCE_CONTROLLER };
+
+    struct InputEvent {
+        Uint32 timestamp;
+        int player;
+        InputKind kind;
+        float value;
+        InputSource source;
+    };
+
+    // Teclado y cruceta se combinan: la dirección está pulsada si lo está en cualquiera
+    struct PlayerState {
+        bool keyUp, keyDown, padUp, padDown;
+        bool up, down;
+        bool upLatched, downLatched;
+        float axis;
+
+        PlayerState() : keyUp(false), keyDown(false), padUp(false), padDown(false),
+                        up(false), down(false), upLatched(false), downLatched(false), axis(0.0f) {}
+    };
+
+    std::deque<InputEvent> queue;
+    PlayerState state[MAX_PLAYERS];
+    SDL_GameController* controllers[MAX_PLAYERS];
+    SDL_JoystickID controllerIds[MAX_PLAYERS];
+    bool measuring;
+    std::vector<Uint32> consumed;   // Marcas de tiempo de eventos aplicados aún no presentados
+    std::vector<float> latencies;   // Milisegundos
+
+    static bool mapKey(SDL_Scancode scancode, int& player, int& direction) {
+        switch (scancode) {
+            case SDL_SCANCODE_W: player = 0; direction = -1; return true;
+            case SDL_SCANCODE_S: player = 0; direction = 1; return true;
+            case SDL_SCANCODE_UP: player = 1; direction = -1; return true;
+            case SDL_SCANCODE_DOWN: player = 1; direction = 1; return true;
+            default: return false;
+        }
+    }
+
+    // Stick a [-1, 1] con zona muerta y cuantizado; arriba es negativo, igual que en pantalla
+    static float axisValue(Sint16 raw) {
+        const float deadZone = 0.15f;
+        float value = raw / 32767.0f;
+        if (value < -1.0f) value = -1.0f;
+        if (std::fabs(value) < deadZone) return 0.0f;
+        // Reescalar para que el movimiento empiece en 0 al salir de la zona muerta
+        return axisFromSteps(axisToSteps((value - std::copysign(deadZone, value)) / (1.0f - deadZone)));
+    }
+
+    void queueEvent(Uint32 timestamp, int player, InputKind kind, float value, InputSource source) {
+        if (queue.size() >= (size_t)MAX_QUEUED) {
+            applyEvent(queue.front());
+            queue.pop_front();
+        }
+        InputEvent event = {timestamp, player, kind, value, source};
+        queue.push_back(event);
+    }
+
+    void applyEvent(const InputEvent& event) {
+        PlayerState& s = state[event.player];
+        bool pressed = event.value != 0.0f;
+        switch (event.kind) {
+            case INPUT_UP:
+                (event.source == SOURCE_KEYBOARD ? s.keyUp : s.padUp) = pressed;
+                if (pressed) s.upLatched = true;
+                break;
+            case INPUT_DOWN:
+                (event.source == SOURCE_KEYBOARD ? s.keyDown : s.padDown) = pressed;
+                if (pressed) s.downLatched = true;
+                break;
+            case INPUT_AXIS:
+                s.axis = event.value;
+                break;
+        }
+        s.up = s.keyUp || s.padUp;
+        s.down = s.keyDown || s.padDown;
+
+        // Solo cuentan para la latencia los eventos que ponen la paleta en movimiento
+        if (measuring && (pressed || event.kind == INPUT_AXIS)) {
+            consumed.push_back(event.timestamp);
+        }
+    }
+
+    int controllerPlayer(SDL_JoystickID id) const {
+        for (int p = 0; p < MAX_PLAYERS; p++) {
+            if (controllers[p] && controllerIds[p] == id) return p;
+        }
+        return -1;
+    }
+
+    void openController(int deviceIndex) {
+        for (int p = 0; p < MAX_PLAYERS; p++) {
+            if (controllers[p]) continue;
+            SDL_GameController* controller = SDL_GameControllerOpen(deviceIndex);
+            if (!controller) {
+                std::cout << "Advertencia: no se pudo abrir el mando: " << SDL_GetError() << std::endl;
+                return;
+            }
+            SDL_JoystickID id = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller));
+            if (controllerPlayer(id) >= 0) {
+                SDL_GameControllerClose(controller); // Ya abierto (evento duplicado al arrancar)
+                return;
+            }
+            controllers[p] = controller;
+            controllerIds[p] = id;
+            std::cout << "Mando conectado (jugador " << p + 1 << "): " << SDL_GameControllerName(controller) << std::endl;
+            return;
+        }
+    }
+
+    void closeController(SDL_JoystickID id) {
+        int p = controllerPlayer(id);
+        if (p < 0) return;
+        SDL_GameControllerClose(controllers[p]);
+        controllers[p] = nullptr;
+        controllerIds[p] = -1;
+        state[p].padUp = state[p].padDown = false;
+        state[p].up = state[p].keyUp;
+        state[p].down = state[p].keyDown;
+        state[p].axis = 0.0f;
+        std::cout << "Mando desconectado (jugador " << p + 1 << ")" << std::endl;
+    }
+};
+
+#endif
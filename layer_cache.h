@@ -0,0 +1,127 @@
+#ifndef LAYER_CACHE_H
+#define LAYER_CACHE_H
+
+// Capas estáticas cacheadas en texturas.
+// El fondo del campo, el HUD (marcador, indicador de música, instrucciones) y el menú casi
+// nunca cambian: se dibujan una vez en una textura de render y cada frame se componen con
+// un solo SDL_RenderCopy. El juego invalida una capa solo cuando cambia lo que muestra.
+// Si el renderer no admite texturas de render, draw() dibuja directamente como antes.
+
+#include "draw_batch.h"
+#include <SDL2/SDL.h>
+#include <iostream>
+
+enum LayerId {
+    LAYER_GAME_BACKGROUND, // Marco, fondo del área de juego y línea central
+    LAYER_GAME_HUD,        // Marcador, indicador de música e instrucciones (transparente)
+    LAYER_MENU,            // Menú principal completo
+    LAYER_COUNT
+};
+
+class LayerCache {
+private:
+    SDL_Renderer* renderer;
+    DrawBatch* batch;
+    SDL_Texture* textures[LAYER_COUNT];
+    bool valid[LAYER_COUNT];
+    bool enabled;
+    int rebuilds;
+
+public:
+    LayerCache() : renderer(nullptr), batch(nullptr), enabled(false), rebuilds(0) {
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            textures[i] = nullptr;
+            valid[i] = false;
+        }
+    }
+
+    bool init(SDL_Renderer* target, DrawBatch* drawBatch, int width, int height) {
+        renderer = target;
+        batch = drawBatch;
+
+        SDL_RendererInfo info;
+        if (SDL_GetRendererInfo(renderer, &info) != 0 || !(info.flags & SDL_RENDERER_TARGETTEXTURE)) {
+            std::cout << "Advertencia: el renderer no admite texturas de render, sin caché de capas" << std::endl;
+            return false;
+        }
+
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            textures[i] = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+            if (!textures[i]) {
+                std::cout << "Advertencia: no se pudo crear la capa " << i << ": " << SDL_GetError() << std::endl;
+                cleanup();
+                return false;
+            }
+            // El HUD se compone con transparencia sobre el juego; las demás capas son opacas
+            SDL_SetTextureBlendMode(textures[i], i == LAYER_GAME_HUD ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+        }
+        enabled = true;
+        invalidateAll();
+        return true;
+    }
+
+    void invalidate(LayerId id) {
+        valid[id] = false;
+    }
+
+    // Por ejemplo tras SDL_RENDER_TARGETS_RESET, cuando el contenido de las texturas se pierde
+    void invalidateAll() {
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            valid[i] = false;
+        }
+    }
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    int getRebuildCount() const {
+        return rebuilds;
+    }
+
+    // Pone la capa en pantalla: la redibuja en su textura si está invalidada y la compone.
+    // drawFn dibuja la capa con el DrawBatch compartido, igual que se haría sin caché.
+    template <typename DrawFn>
+    void draw(LayerId id, DrawFn drawFn) {
+        if (!enabled) {
+            drawFn();
+            batch->flush(renderer);
+            return;
+        }
+
+        prepare(id, drawFn);
+        SDL_RenderCopy(renderer, textures[id], nullptr, nullptr);
+    }
+
+    // Solo redibuja la textura si está invalidada, sin componerla. Devuelve true si la
+    // redibujó (el redibujado parcial lo usa para saber qué ha cambiado en pantalla).
+    template <typename DrawFn>
+    bool prepare(LayerId id, DrawFn drawFn) {
+        if (!enabled || valid[id]) {
+            return false;
+        }
+        // Se vuelve al destino que hubiera (la ventana o la textura de captura)
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, textures[id]);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, id == LAYER_GAME_HUD ? 0 : 255);
+        SDL_RenderClear(renderer);
+        drawFn();
+        batch->flush(renderer);
+        SDL_SetRenderTarget(renderer, previousTarget);
+        valid[id] = true;
+        rebuilds++;
+        return true;
+    }
+
+    void cleanup() {
+        for (int i = 0; i < LAYER_COUNT; i++) {
+            if (textures[i]) {
+                SDL_DestroyTexture(textures[i]);
+                textures[i] = nullptr;
+            }
+        }
+        enabled = false;
+    }
+};
+
+#endif
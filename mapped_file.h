@@ -0,0 +1,97 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+// Archivo de solo lectura proyectado en memoria (mmap).
+// Abrirlo no lee nada: el sistema carga cada página al tocarla, así que consultar la
+// cabecera y el índice de un archivo grande solo lee esas páginas. Donde no hay mmap
+// (Windows) se lee el archivo entero en memoria con la misma interfaz.
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+class MappedFile {
+public:
+    MappedFile() : bytes(nullptr), length(0), mapping(nullptr) {}
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        if (length > 0) {
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address == MAP_FAILED) {
+                ::close(fd);
+                length = 0;
+                return false;
+            }
+            mapping = address;
+            bytes = (const uint8_t*)address;
+        }
+        ::close(fd); // La proyección sigue siendo válida sin el descriptor
+        return true;
+#else
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in) return false;
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        bytes = buffer.empty() ? nullptr : &buffer[0];
+        length = buffer.size();
+        return true;
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapping) {
+            munmap(mapping, length);
+        }
+#else
+        buffer.clear();
+#endif
+        mapping = nullptr;
+        bytes = nullptr;
+        length = 0;
+    }
+
+    const uint8_t* data() const {
+        return bytes;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    const uint8_t* bytes;
+    size_t length;
+    void* mapping;
+#ifdef _WIN32
+    std::vector<uint8_t> buffer;
+#endif
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+#endif
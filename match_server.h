@@ -0,0 +1,850 @@
+#ifndef MATCH_SERVER_H
+#define MATCH_SERVER_H
+
+// Servidor autoritativo de partidas (pong-server).
+// Un hilo de entrada (front end) lee todos los paquetes UDP del puerto con epoll, empareja
+// a los clientes en huecos libres y reparte su entrada entre los shards. Cada shard es un
+// hilo fijado a un núcleo que simula sus partidas con Match::step() a ticks fijos y envía
+// el estado a los dos jugadores de cada una. Los shards no comparten partidas, así que no
+// hay bloqueos en la simulación: solo un buzón por shard para los comandos del front end.
+//
+// Cada partida tiene un presupuesto de tiempo por tick (--budget-us): la capacidad de un
+// shard es la parte del periodo del tick que cabe en ese presupuesto, y un shard que se
+// pasa del tiempo total que le toca deja de recibir partidas nuevas.
+// Solo Linux (epoll).
+
+#include "pong_core.h"
+#include "replay.h"
+#include "rollback.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+const uint16_t SERVER_MAGIC = 0x5053;
+const uint8_t SERVER_VERSION = 1;
+const uint32_t SERVER_TIMEOUT_MS = 5000;
+const size_t SERVER_STATE_SIZE = 3 + 4 + 4 + 6 * 4 + 2;
+const float SERVER_UTILISATION = 0.8f; // Parte del periodo del tick que se reparte entre partidas
+
+enum ServerPacketType {
+    SRV_JOIN = 1,    // Cliente → servidor: quiero jugar (se repite hasta recibir ASSIGN)
+    SRV_ASSIGN = 2,  // Partida, lado, ticks/s y ticks entre estados
+    SRV_FULL = 3,    // No hay huecos libres
+    SRV_INPUT = 4,   // Último tick visto y entrada de la paleta
+    SRV_STATE = 5,   // Estado de la partida
+    SRV_END = 6,     // Fin: motivo y marcador
+    SRV_LEAVE = 7    // Cliente → servidor: abandono
+};
+
+enum MatchEndReason {
+    END_POINTS = 0,   // Alguien llegó a los puntos de la partida
+    END_LEFT = 1,     // Un jugador abandonó
+    END_TIMEOUT = 2   // Un jugador dejó de enviar paquetes
+};
+
+struct ServerConfig {
+    uint16_t port;
+    int shards;            // 0 = uno por núcleo
+    int slotsPerShard;
+    int tickRate;
+    int sendEvery;         // Ticks entre estados enviados a los clientes
+    int pointsToWin;
+    float budgetUs;        // Presupuesto por partida y tick
+    bool pinThreads;
+    int reportSeconds;
+
+    ServerConfig() : port(7777), shards(0), slotsPerShard(256), tickRate(DEFAULT_TICK_RATE), sendEvery(2),
+                     pointsToWin(11), budgetUs(25.0f), pinThreads(true), reportSeconds(5) {}
+};
+
+// Estado de partida tal como viaja a los clientes
+struct ServerState {
+    uint32_t matchId;
+    uint32_t tick;
+    float ballX, ballY, ballVelocityX, ballVelocityY;
+    float paddle1Y, paddle2Y;
+    int score1, score2;
+};
+
+inline size_t encodeServerState(uint8_t* packet, const ServerState& state) {
+    uint8_t* out = packet;
+    putU16(out, SERVER_MAGIC);
+    *out++ = SRV_STATE;
+    putU32(out, state.matchId);
+    putU32(out, state.tick);
+    putF32(out, state.ballX);
+    putF32(out, state.ballY);
+    putF32(out, state.ballVelocityX);
+    putF32(out, state.ballVelocityY);
+    putF32(out, state.paddle1Y);
+    putF32(out, state.paddle2Y);
+    *out++ = (uint8_t)std::min(state.score1, 255);
+    *out++ = (uint8_t)std::min(state.score2, 255);
+    return out - packet;
+}
+
+// in apunta justo detrás del tipo
+inline void decodeServerState(const uint8_t* in, ServerState& state) {
+    state.matchId = getU32(in);
+    state.tick = getU32(in);
+    state.ballX = getF32(in);
+    state.ballY = getF32(in);
+    state.ballVelocityX = getF32(in);
+    state.ballVelocityY = getF32(in);
+    state.paddle1Y = getF32(in);
+    state.paddle2Y = getF32(in);
+    state.score1 = *in++;
+    state.score2 = *in++;
+}
+
+inline uint64_t addressKey(const sockaddr_in& address) {
+    return ((uint64_t)address.sin_addr.s_addr << 16) | address.sin_port;
+}
+
+// Histograma de tiempos en nanosegundos con cubetas logarítmicas (error < 7%).
+// Registrar es una suma en un array: sirve dentro del bucle de simulación.
+class TickHistogram {
+public:
+    TickHistogram() {
+        clear();
+    }
+
+    void clear() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        maxNs = 0;
+    }
+
+    void record(uint64_t ns) {
+        counts[bucketOf(ns)]++;
+        total++;
+        if (ns > maxNs) maxNs = ns;
+    }
+
+    void merge(const TickHistogram& other) {
+        for (int i = 0; i < BUCKETS; i++) counts[i] += other.counts[i];
+        total += other.total;
+        maxNs = std::max(maxNs, other.maxNs);
+    }
+
+    uint64_t count() const {
+        return total;
+    }
+
+    double percentileUs(double fraction) const {
+        if (total == 0) return 0.0;
+        uint64_t target = (uint64_t)(fraction * (total - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= target) return std::min(valueOf(i), maxNs) / 1000.0;
+        }
+        return maxNs / 1000.0;
+    }
+
+    double maxUs() const {
+        return maxNs / 1000.0;
+    }
+
+private:
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKETS = 61 * SUB_BUCKETS;
+
+    uint64_t counts[BUCKETS];
+    uint64_t total;
+    uint64_t maxNs;
+
+    // 16 cubetas por potencia de dos
+    static int bucketOf(uint64_t ns) {
+        if (ns < (uint64_t)SUB_BUCKETS) return (int)ns;
+        int exponent = 63 - __builtin_clzll(ns);
+        int mantissa = (int)(ns >> (exponent - 4)) & (SUB_BUCKETS - 1);
+        return (exponent - 3) * SUB_BUCKETS + mantissa;
+    }
+
+    static uint64_t valueOf(int bucket) {
+        if (bucket < SUB_BUCKETS) return (uint64_t)bucket;
+        int exponent = bucket / SUB_BUCKETS + 3;
+        return (uint64_t)(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 4);
+    }
+};
+
+// Medidas de un shard en un intervalo
+struct ShardStats {
+    TickHistogram matchTicks;  // Coste de un Match::step() con su envío
+    TickHistogram shardTicks;  // Coste de un tick completo del shard
+    uint64_t matchTickCount;   // Ticks simulados de partidas en juego
+    uint64_t overruns;         // Ticks de partida por encima del presupuesto
+    uint64_t lateTicks;        // Ticks de shard que terminaron después de su plazo
+    uint64_t busyNs;           // Tiempo de trabajo del shard
+    uint64_t bytesOut, packetsOut;
+    uint64_t finished, timeouts;
+
+    ShardStats() {
+        clear();
+    }
+
+    void clear() {
+        matchTicks.clear();
+        shardTicks.clear();
+        matchTickCount = overruns = lateTicks = busyNs = 0;
+        bytesOut = packetsOut = finished = timeouts = 0;
+    }
+
+    void merge(const ShardStats& other) {
+        matchTicks.merge(other.matchTicks);
+        shardTicks.merge(other.shardTicks);
+        matchTickCount += other.matchTickCount;
+        overruns += other.overruns;
+        lateTicks += other.lateTicks;
+        busyNs += other.busyNs;
+        bytesOut += other.bytesOut;
+        packetsOut += other.packetsOut;
+        finished += other.finished;
+        timeouts += other.timeouts;
+    }
+};
+
+// Hilo de simulación con sus partidas
+class ServerShard {
+public:
+    enum CommandType { CMD_OPEN, CMD_JOIN, CMD_INPUT, CMD_TOUCH, CMD_LEAVE };
+
+    struct Command {
+        uint8_t type;
+        uint8_t side;
+        uint16_t input;
+        int slot;
+        uint32_t matchId;
+        sockaddr_in address;
+    };
+
+    ServerShard(int shardIndex, const ServerConfig& serverConfig, int socketFd, int slotCount) :
+        index(shardIndex), config(serverConfig), fd(socketFd), stopping(false), activeMatches(0),
+        saturated(false), slots(slotCount) {
+        for (size_t i = 0; i < slots.size(); i++) {
+            slots[i].match.player1.isAI = false;
+            slots[i].match.player2.isAI = false;
+        }
+    }
+
+    void start() {
+        thread = std::thread(&ServerShard::loop, this);
+    }
+
+    void stop() {
+        stopping = true;
+        if (thread.joinable()) thread.join();
+    }
+
+    // Desde el front end
+    void push(const Command& command) {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inbox.push_back(command);
+    }
+
+    // Huecos liberados desde la última llamada
+    void takeFinished(std::vector<int>& out) {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        out.insert(out.end(), finishedSlots.begin(), finishedSlots.end());
+        finishedSlots.clear();
+    }
+
+    // Medidas acumuladas desde la última llamada
+    void takeStats(ShardStats& out) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        out.merge(published);
+        published.clear();
+    }
+
+    int getActiveMatches() const {
+        return activeMatches.load();
+    }
+
+    bool isSaturated() const {
+        return saturated.load();
+    }
+
+private:
+    struct Player {
+        sockaddr_in address;
+        PaddleInput input;
+        uint32_t lastHeardMs;
+    };
+
+    struct Slot {
+        bool open;      // Hay al menos un jugador
+        bool started;   // Hay dos: se simula
+        uint32_t matchId;
+        long tick;
+        Match match;
+        Player players[2];
+
+        Slot() : open(false), started(false), matchId(0), tick(0) {}
+    };
+
+    int index;
+    ServerConfig config;
+    int fd;
+    std::thread thread;
+    std::atomic<bool> stopping;
+    std::atomic<int> activeMatches;
+    std::atomic<bool> saturated;
+    std::vector<Slot> slots;
+
+    std::mutex inboxMutex;
+    std::vector<Command> inbox;
+    std::vector<Command> commands;   // Solo el hilo del shard
+
+    std::mutex outboxMutex;
+    std::vector<int> finishedSlots;
+
+    std::mutex statsMutex;
+    ShardStats published;
+    ShardStats local;
+
+    void loop() {
+        pinToCore();
+        typedef std::chrono::steady_clock Clock;
+        Clock::duration period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / config.tickRate));
+        uint64_t budgetNs = (uint64_t)(config.budgetUs * 1000.0f);
+        PhysicsReal deltaTime = physicsDelta(config.tickRate);
+        Clock::time_point deadline = Clock::now();
+        long shardTick = 0;
+
+        while (!stopping) {
+            deadline += period;
+            Clock::time_point tickStart = Clock::now();
+            uint32_t nowMs = netTimeMs();
+            applyCommands(nowMs);
+
+            int active = 0;
+            for (size_t i = 0; i < slots.size(); i++) {
+                Slot& slot = slots[i];
+                if (!slot.open) continue;
+                if (!slot.started) {
+                    if (nowMs - slot.players[0].lastHeardMs > SERVER_TIMEOUT_MS) {
+                        finish((int)i, END_TIMEOUT);
+                    }
+                    continue;
+                }
+                active++;
+                Clock::time_point start = Clock::now();
+                stepSlot((int)i, deltaTime, nowMs);
+                uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                local.matchTicks.record(ns);
+                local.matchTickCount++;
+                if (ns > budgetNs) local.overruns++;
+            }
+            activeMatches = active;
+
+            Clock::time_point tickEnd = Clock::now();
+            uint64_t tickNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(tickEnd - tickStart).count();
+            local.shardTicks.record(tickNs);
+            local.busyNs += tickNs;
+            if (tickEnd > deadline) {
+                local.lateTicks++;
+                if (tickEnd > deadline + period) deadline = tickEnd; // No recuperar ticks perdidos
+            }
+
+            // Publicar una vez por segundo: el informe no bloquea la simulación
+            if (++shardTick % config.tickRate == 0) {
+                publish();
+            }
+            std::this_thread::sleep_until(deadline);
+        }
+        publish();
+    }
+
+    void publish() {
+        // Saturado si el último segundo trabajó más de la parte del periodo que se reparte
+        saturated = local.busyNs > (uint64_t)(1e9 * SERVER_UTILISATION);
+        std::lock_guard<std::mutex> lock(statsMutex);
+        published.merge(local);
+        local.clear();
+    }
+
+    void applyCommands(uint32_t nowMs) {
+        {
+            std::lock_guard<std::mutex> lock(inboxMutex);
+            commands.swap(inbox);
+        }
+        for (size_t i = 0; i < commands.size(); i++) {
+            const Command& command = commands[i];
+            Slot& slot = slots[command.slot];
+            switch (command.type) {
+                case CMD_OPEN:
+                    slot.open = true;
+                    slot.started = false;
+                    slot.matchId = command.matchId;
+                    slot.tick = 0;
+                    slot.match.reset();
+                    for (int side = 0; side < 2; side++) {
+                        slot.players[side].input = PaddleInput();
+                        slot.players[side].lastHeardMs = nowMs;
+                    }
+                    slot.players[0].address = command.address;
+                    break;
+                case CMD_JOIN:
+                    if (!slot.open || slot.matchId != command.matchId) break;
+                    slot.players[1].address = command.address;
+                    slot.players[1].lastHeardMs = nowMs;
+                    slot.started = true;
+                    break;
+                case CMD_INPUT:
+                case CMD_TOUCH:
+                    if (!slot.open || slot.matchId != command.matchId) break;
+                    if (command.type == CMD_INPUT) {
+                        slot.players[command.side].input = decodeNetInput(command.input);
+                    }
+                    slot.players[command.side].lastHeardMs = nowMs;
+                    break;
+                case CMD_LEAVE:
+                    if (slot.open && slot.matchId == command.matchId) {
+                        finish(command.slot, END_LEFT);
+                    }
+                    break;
+            }
+        }
+        commands.clear();
+    }
+
+    void stepSlot(int index, PhysicsReal deltaTime, uint32_t nowMs) {
+        Slot& slot = slots[index];
+        Match& match = slot.match;
+        match.step(deltaTime, slot.players[0].input, slot.players[1].input);
+        slot.tick++;
+
+        if (match.score1 >= config.pointsToWin || match.score2 >= config.pointsToWin) {
+            finish(index, END_POINTS);
+            return;
+        }
+        for (int side = 0; side < 2; side++) {
+            if (nowMs - slot.players[side].lastHeardMs > SERVER_TIMEOUT_MS) {
+                finish(index, END_TIMEOUT);
+                return;
+            }
+        }
+        if (slot.tick % config.sendEvery == 0) {
+            ServerState state;
+            state.matchId = slot.matchId;
+            state.tick = (uint32_t)slot.tick;
+            state.ballX = realToFloat(match.ball.x);
+            state.ballY = realToFloat(match.ball.y);
+            state.ballVelocityX = realToFloat(match.ball.velocityX);
+            state.ballVelocityY = realToFloat(match.ball.velocityY);
+            state.paddle1Y = realToFloat(match.player1.y);
+            state.paddle2Y = realToFloat(match.player2.y);
+            state.score1 = match.score1;
+            state.score2 = match.score2;
+            uint8_t packet[SERVER_STATE_SIZE];
+            size_t size = encodeServerState(packet, state);
+            sendTo(slot.players[0].address, packet, size);
+            sendTo(slot.players[1].address, packet, size);
+        }
+    }
+
+    void finish(int index, MatchEndReason reason) {
+        Slot& slot = slots[index];
+        uint8_t packet[3 + 4 + 1 + 2];
+        uint8_t* out = packet;
+        putU16(out, SERVER_MAGIC);
+        *out++ = SRV_END;
+        putU32(out, slot.matchId);
+        *out++ = (uint8_t)reason;
+        *out++ = (uint8_t)std::min(slot.match.score1, 255);
+        *out++ = (uint8_t)std::min(slot.match.score2, 255);
+        bool started = slot.started;
+        if (reason == END_TIMEOUT) local.timeouts++;
+        if (started) local.finished++;
+        slot.open = false;
+        slot.started = false;
+        // El hueco se publica antes del SRV_END: un JOIN que responda al END llega al front
+        // end cuando takeFinished() ya lo devuelve
+        {
+            std::lock_guard<std::mutex> lock(outboxMutex);
+            finishedSlots.push_back(index);
+        }
+        for (int side = 0; side < (started ? 2 : 1); side++) {
+            sendTo(slot.players[side].address, packet, sizeof(packet));
+        }
+    }
+
+    void sendTo(const sockaddr_in& address, const uint8_t* data, size_t size) {
+        // sendto sobre el mismo socket UDP es seguro desde varios hilos
+        if (sendto(fd, data, size, 0, (const sockaddr*)&address, sizeof(address)) == (ssize_t)size) {
+            local.bytesOut += size;
+            local.packetsOut++;
+        }
+    }
+
+    void pinToCore() {
+#ifdef __linux__
+        if (!config.pinThreads) return;
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+};
+
+class MatchServer {
+public:
+    explicit MatchServer(const ServerConfig& serverConfig) :
+        config(serverConfig), fd(-1), epollFd(-1), nextMatchId(1), capacity(0), waitingShard(-1),
+        waitingSlot(-1), waitingMatchId(0), rejected(0), bytesIn(0), packetsIn(0), intervalBytesIn(0),
+        peakMatches(0) {
+        if (config.shards <= 0) config.shards = (int)std::max(1u, std::thread::hardware_concurrency());
+        if (config.tickRate < MIN_TICK_RATE) config.tickRate = MIN_TICK_RATE;
+        if (config.tickRate > MAX_TICK_RATE) config.tickRate = MAX_TICK_RATE;
+        if (config.sendEvery < 1) config.sendEvery = 1;
+        if (config.pointsToWin < 1) config.pointsToWin = 1;
+        if (config.budgetUs <= 0.0f) config.budgetUs = 1.0f;
+    }
+
+    ~MatchServer() {
+        stop();
+    }
+
+    bool start() {
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            std::cout << "Error creando el socket UDP: " << strerror(errno) << std::endl;
+            return false;
+        }
+        // Cientos de partidas a la vez: búferes del sistema grandes para no perder ráfagas
+        int bufferSize = 8 << 20;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(config.port);
+        if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            std::cout << "Error abriendo el puerto UDP " << config.port << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        epollFd = epoll_create1(0);
+        epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            std::cout << "Error creando epoll: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        // Partidas por shard que caben en el periodo del tick con su presupuesto
+        float periodUs = 1e6f / config.tickRate;
+        capacity = std::max(1, std::min(config.slotsPerShard, (int)(periodUs * SERVER_UTILISATION / config.budgetUs)));
+        for (int i = 0; i < config.shards; i++) {
+            shards.push_back(std::unique_ptr<ServerShard>(new ServerShard(i, config, fd, capacity)));
+            std::vector<int> slots;
+            for (int slot = capacity - 1; slot >= 0; slot--) slots.push_back(slot);
+            freeSlots.push_back(slots);
+        }
+        for (size_t i = 0; i < shards.size(); i++) shards[i]->start();
+
+        std::cout << "pong-server en el puerto " << config.port << ": " << config.shards << " shards, "
+                  << capacity << " partidas por shard, " << config.tickRate << " ticks/s, presupuesto "
+                  << config.budgetUs << " us por partida" << std::endl;
+        startTime = std::chrono::steady_clock::now();
+        lastReport = startTime;
+        return true;
+    }
+
+    // Atiende la red hasta que keepRunning() devuelva false; informa cada reportSeconds
+    template <typename KeepRunning>
+    void run(KeepRunning keepRunning) {
+        epoll_event events[4];
+        uint8_t buffer[NET_MAX_PACKET];
+        while (keepRunning()) {
+            int ready = epoll_wait(epollFd, events, 4, 10);
+            if (ready > 0) {
+                while (true) {
+                    sockaddr_in from;
+                    socklen_t fromSize = sizeof(from);
+                    ssize_t size = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr*)&from, &fromSize);
+                    if (size <= 0) break;
+                    bytesIn += size;
+                    intervalBytesIn += size;
+                    packetsIn++;
+                    handlePacket(buffer, (size_t)size, from);
+                }
+            }
+            releaseFinished();
+            if (config.reportSeconds > 0 &&
+                std::chrono::steady_clock::now() - lastReport >= std::chrono::seconds(config.reportSeconds)) {
+                printInterval();
+            }
+        }
+    }
+
+    void stop() {
+        for (size_t i = 0; i < shards.size(); i++) shards[i]->stop();
+        if (epollFd >= 0) {
+            close(epollFd);
+            epollFd = -1;
+        }
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    void printReport() {
+        for (size_t i = 0; i < shards.size(); i++) {
+            ShardStats stats;
+            shards[i]->takeStats(stats);
+            shardTotals.resize(shards.size());
+            shardTotals[i].merge(stats);
+        }
+        ShardStats total;
+        for (size_t i = 0; i < shardTotals.size(); i++) total.merge(shardTotals[i]);
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "=== pong-server (" << seconds << " s) ===" << std::endl;
+        std::cout << "Partidas terminadas: " << total.finished << "  (" << total.timeouts
+                  << " por tiempo sin paquetes)  Rechazos sin hueco: " << rejected << std::endl;
+        std::cout << "Máximo simultáneo: " << peakMatches << " partidas ("
+                  << (double)peakMatches / shards.size() << " por núcleo, capacidad " << capacity << ")" << std::endl;
+        printTickLine(total);
+        printBandwidthLine(total, bytesIn);
+        for (size_t i = 0; i < shardTotals.size(); i++) {
+            const ShardStats& stats = shardTotals[i];
+            char line[160];
+            snprintf(line, sizeof(line), "  Shard %2d: %8llu ticks de partida, p99 %.2f us, ocupación %.1f%%, %llu fuera de presupuesto, %llu tardíos",
+                     (int)i, (unsigned long long)stats.matchTickCount, stats.matchTicks.percentileUs(0.99),
+                     seconds > 0.0 ? stats.busyNs / (seconds * 1e7) : 0.0,
+                     (unsigned long long)stats.overruns, (unsigned long long)stats.lateTicks);
+            std::cout << line << std::endl;
+        }
+    }
+
+private:
+    struct Session {
+        int shard;
+        int slot;
+        uint8_t side;
+        uint32_t matchId;
+    };
+
+    ServerConfig config;
+    int fd;
+    int epollFd;
+    std::vector<std::unique_ptr<ServerShard> > shards;
+    std::vector<std::vector<int> > freeSlots;          // Huecos libres de cada shard (solo el front end)
+    std::unordered_map<uint64_t, Session> sessions;
+    std::unordered_map<uint64_t, uint64_t> slotPlayers[2]; // (shard, hueco) → dirección de cada lado
+    uint32_t nextMatchId;
+    int capacity;
+    int waitingShard, waitingSlot;   // Partida con un solo jugador esperando rival
+    uint32_t waitingMatchId;
+    uint64_t rejected;
+    uint64_t bytesIn, packetsIn, intervalBytesIn;
+    int peakMatches;
+    std::vector<ShardStats> shardTotals;
+    std::vector<int> released;
+    std::chrono::steady_clock::time_point startTime, lastReport;
+
+    static uint64_t slotKey(int shard, int slot) {
+        return ((uint64_t)shard << 32) | (uint32_t)slot;
+    }
+
+    void handlePacket(const uint8_t* data, size_t size, const sockaddr_in& from) {
+        if (size < 3) return;
+        const uint8_t* in = data;
+        if (getU16(in) != SERVER_MAGIC) return;
+        uint8_t type = *in++;
+        uint64_t key = addressKey(from);
+        std::unordered_map<uint64_t, Session>::iterator found = sessions.find(key);
+
+        if (type == SRV_JOIN) {
+            if (size < 4 || *in != SERVER_VERSION) return;
+            if (found != sessions.end()) {
+                // Quien acaba de recibir SRV_END vuelve a pedir partida enseguida: se recogen
+                // antes las partidas terminadas para no reenviarle el ASSIGN de la que acabó
+                releaseFinished();
+                found = sessions.find(key);
+            }
+            if (found != sessions.end()) {
+                // JOIN repetido: el ASSIGN se perdió o sigue esperando rival
+                sendAssign(from, found->second);
+                pushCommand(found->second, ServerShard::CMD_TOUCH, 0);
+                return;
+            }
+            matchmake(from, key);
+        } else if (type == SRV_INPUT && size >= 3 + 4 + 2 && found != sessions.end()) {
+            getU32(in); // Último tick visto por el cliente (sin uso por ahora)
+            pushCommand(found->second, ServerShard::CMD_INPUT, getU16(in));
+        } else if (type == SRV_LEAVE && found != sessions.end()) {
+            pushCommand(found->second, ServerShard::CMD_LEAVE, 0);
+        }
+    }
+
+    // Completa la partida que espera rival o abre una en el shard menos cargado
+    void matchmake(const sockaddr_in& from, uint64_t key) {
+        Session session;
+        ServerShard::Command command;
+        memset(&command, 0, sizeof(command));
+        command.address = from;
+        if (waitingShard >= 0) {
+            session.shard = waitingShard;
+            session.slot = waitingSlot;
+            session.side = 1;
+            session.matchId = waitingMatchId;
+            command.type = ServerShard::CMD_JOIN;
+            waitingShard = -1;
+        } else {
+            int best = -1;
+            for (size_t i = 0; i < shards.size(); i++) {
+                if (freeSlots[i].empty() || shards[i]->isSaturated()) continue;
+                if (best < 0 || freeSlots[i].size() > freeSlots[best].size()) best = (int)i;
+            }
+            if (best < 0) {
+                rejected++;
+                uint8_t packet[3];
+                uint8_t* out = packet;
+                putU16(out, SERVER_MAGIC);
+                *out++ = SRV_FULL;
+                sendto(fd, packet, sizeof(packet), 0, (const sockaddr*)&from, sizeof(from));
+                return;
+            }
+            session.shard = best;
+            session.slot = freeSlots[best].back();
+            freeSlots[best].pop_back();
+            session.side = 0;
+            session.matchId = nextMatchId++;
+            command.type = ServerShard::CMD_OPEN;
+            waitingShard = session.shard;
+            waitingSlot = session.slot;
+            waitingMatchId = session.matchId;
+        }
+        command.slot = session.slot;
+        command.side = session.side;
+        command.matchId = session.matchId;
+        shards[session.shard]->push(command);
+        sessions[key] = session;
+        slotPlayers[session.side][slotKey(session.shard, session.slot)] = key;
+        sendAssign(from, session);
+    }
+
+    void pushCommand(const Session& session, uint8_t type, uint16_t input) {
+        ServerShard::Command command;
+        memset(&command, 0, sizeof(command));
+        command.type = type;
+        command.slot = session.slot;
+        command.side = session.side;
+        command.matchId = session.matchId;
+        command.input = input;
+        shards[session.shard]->push(command);
+    }
+
+    void sendAssign(const sockaddr_in& to, const Session& session) {
+        uint8_t packet[3 + 4 + 1 + 2 + 1];
+        uint8_t* out = packet;
+        putU16(out, SERVER_MAGIC);
+        *out++ = SRV_ASSIGN;
+        putU32(out, session.matchId);
+        *out++ = session.side;
+        putU16(out, (uint16_t)config.tickRate);
+        *out++ = (uint8_t)config.sendEvery;
+        sendto(fd, packet, sizeof(packet), 0, (const sockaddr*)&to, sizeof(to));
+    }
+
+    // Devuelve al matchmaking los huecos de las partidas terminadas
+    void releaseFinished() {
+        int active = 0;
+        for (size_t shard = 0; shard < shards.size(); shard++) {
+            released.clear();
+            shards[shard]->takeFinished(released);
+            for (size_t i = 0; i < released.size(); i++) {
+                int slot = released[i];
+                uint64_t slotId = slotKey((int)shard, slot);
+                for (int side = 0; side < 2; side++) {
+                    std::unordered_map<uint64_t, uint64_t>::iterator player = slotPlayers[side].find(slotId);
+                    if (player != slotPlayers[side].end()) {
+                        sessions.erase(player->second);
+                        slotPlayers[side].erase(player);
+                    }
+                }
+                if (waitingShard == (int)shard && waitingSlot == slot) waitingShard = -1;
+                freeSlots[shard].push_back(slot);
+            }
+            active += shards[shard]->getActiveMatches();
+        }
+        peakMatches = std::max(peakMatches, active);
+    }
+
+    void printInterval() {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        lastReport = now;
+        shardTotals.resize(shards.size());
+        ShardStats interval;
+        int active = 0;
+        for (size_t i = 0; i < shards.size(); i++) {
+            ShardStats stats;
+            shards[i]->takeStats(stats);
+            shardTotals[i].merge(stats);
+            interval.merge(stats);
+            active += shards[i]->getActiveMatches();
+        }
+        char line[200];
+        double matchSeconds = (double)interval.matchTickCount / config.tickRate;
+        snprintf(line, sizeof(line), "[%5.0f s] %4d partidas (%.1f por núcleo) | tick p50 %.2f p99 %.2f máx %.1f us | %.0f B/s salida, %.0f B/s entrada por partida",
+                 std::chrono::duration<double>(now - startTime).count(), active, (double)active / shards.size(),
+                 interval.matchTicks.percentileUs(0.5), interval.matchTicks.percentileUs(0.99), interval.matchTicks.maxUs(),
+                 matchSeconds > 0 ? interval.bytesOut / matchSeconds : 0.0,
+                 matchSeconds > 0 ? intervalBytesIn / matchSeconds : 0.0);
+        std::cout << line << std::endl;
+        intervalBytesIn = 0;
+    }
+
+    void printTickLine(const ShardStats& total) const {
+        char line[200];
+        snprintf(line, sizeof(line), "Tick por partida (us): p50 %.2f  p99 %.2f  p99.9 %.2f  máx %.1f  (presupuesto %.0f, %llu excedidos)",
+                 total.matchTicks.percentileUs(0.5), total.matchTicks.percentileUs(0.99),
+                 total.matchTicks.percentileUs(0.999), total.matchTicks.maxUs(), config.budgetUs,
+                 (unsigned long long)total.overruns);
+        std::cout << line << std::endl;
+        snprintf(line, sizeof(line), "Tick de shard (us): p50 %.1f  p99 %.1f  máx %.1f  de %.0f  (%llu tardíos)",
+                 total.shardTicks.percentileUs(0.5), total.shardTicks.percentileUs(0.99), total.shardTicks.maxUs(),
+                 1e6 / config.tickRate, (unsigned long long)total.lateTicks);
+        std::cout << line << std::endl;
+    }
+
+    void printBandwidthLine(const ShardStats& total, uint64_t totalBytesIn) const {
+        double matchSeconds = (double)total.matchTickCount / config.tickRate;
+        if (matchSeconds <= 0.0) return;
+        char line[200];
+        snprintf(line, sizeof(line), "Ancho de banda por partida: salida %.2f KB/s (%.0f paquetes/s), entrada %.2f KB/s",
+                 total.bytesOut / matchSeconds / 1024.0, total.packetsOut / matchSeconds,
+                 totalBytesIn / matchSeconds / 1024.0);
+        std::cout << line << std::endl;
+    }
+};
+
+#endif
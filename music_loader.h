@@ -0,0 +1,126 @@
+#ifndef MUSIC_LOADER_H
+#define MUSIC_LOADER_H
+
+// Carga de la música en segundo plano.
+// Mix_LoadMUS abre el archivo y prepara el decodificador (con MP3, recorre el archivo para
+// situar los frames), lo que bloqueaba el arranque antes de crear la ventana. Aquí un hilo
+// aparte abre el archivo y crea la música; el juego sigue y consulta el estado cada frame.
+// SDL_mixer decodifica la música mientras suena leyendo del archivo (streaming), así que
+// no hace falta tenerla entera en memoria.
+//
+// La ruta se busca tal cual (relativa al directorio actual) y, si no está, junto al
+// ejecutable; si falla se informan las rutas probadas en lugar de fallar en silencio.
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum MusicLoadState {
+    MUSIC_IDLE,
+    MUSIC_LOADING,
+    MUSIC_READY,
+    MUSIC_FAILED
+};
+
+class MusicLoader {
+public:
+    MusicLoader() : state(MUSIC_IDLE), music(nullptr), loadMs(0.0) {}
+
+    ~MusicLoader() {
+        wait();
+    }
+
+    // Empieza a cargar path en un hilo; el mezclador ya debe estar abierto
+    void start(const std::string& path) {
+        wait();
+        requestedPath = path;
+        state = MUSIC_LOADING;
+        worker = std::thread(&MusicLoader::load, this);
+    }
+
+    MusicLoadState getState() const {
+        return (MusicLoadState)state.load();
+    }
+
+    // Solo válida en MUSIC_READY
+    Mix_Music* getMusic() const {
+        return music;
+    }
+
+    double getLoadMs() const {
+        return loadMs;
+    }
+
+    // Inicio y fin de la carga (para la traza de arranque); válidos al terminar
+    std::chrono::steady_clock::time_point getStartTime() const {
+        return startTime;
+    }
+
+    std::chrono::steady_clock::time_point getEndTime() const {
+        return endTime;
+    }
+
+    const std::string& getError() const {
+        return error;
+    }
+
+    // Espera a que termine la carga en curso (al salir)
+    void wait() {
+        if (worker.joinable()) worker.join();
+    }
+
+    void free() {
+        wait();
+        if (music) {
+            Mix_FreeMusic(music);
+            music = nullptr;
+        }
+        state = MUSIC_IDLE;
+    }
+
+private:
+    std::atomic<int> state;
+    std::thread worker;
+    std::string requestedPath;
+    Mix_Music* music;       // Lo escribe el hilo antes de publicar MUSIC_READY
+    double loadMs;
+    std::chrono::steady_clock::time_point startTime, endTime;
+    std::string error;
+
+    void load() {
+        startTime = std::chrono::steady_clock::now();
+        std::vector<std::string> candidates;
+        candidates.push_back(requestedPath);
+        char* basePath = SDL_GetBasePath();
+        if (basePath) {
+            if (!requestedPath.empty() && requestedPath[0] != '/') {
+                candidates.push_back(std::string(basePath) + requestedPath);
+            }
+            SDL_free(basePath);
+        }
+
+        for (size_t i = 0; i < candidates.size() && !music; i++) {
+            SDL_RWops* file = SDL_RWFromFile(candidates[i].c_str(), "rb");
+            if (!file) {
+                error += (error.empty() ? "" : "; ") + candidates[i] + ": no existe";
+                continue;
+            }
+            // La música se queda con el archivo y lo lee mientras suena
+            music = Mix_LoadMUS_RW(file, 1);
+            if (!music) {
+                error += (error.empty() ? "" : "; ") + candidates[i] + ": " + Mix_GetError();
+            }
+        }
+
+        endTime = std::chrono::steady_clock::now();
+        loadMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        state = music ? MUSIC_READY : MUSIC_FAILED;
+    }
+};
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef NET_H
+#define NET_H
+
+// Socket UDP no bloqueante para el juego en red.
+// Incluye un simulador de red (shim) para probar en localhost: cada paquete enviado puede
+// perderse con cierta probabilidad o retrasarse una latencia fija más un jitter aleatorio
+// antes de salir por el socket. Los paquetes retrasados se envían desde poll().
+// Solo sockets POSIX (Linux, macOS).
+
+#include "pong_core.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iostream>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+const size_t NET_MAX_PACKET = 512;
+
+// Condiciones de red simuladas para los paquetes que envía este proceso
+struct NetConditions {
+    int latencyMs;     // Retraso fijo en un sentido
+    int jitterMs;      // Retraso adicional aleatorio en [0, jitterMs]
+    float lossPercent; // Paquetes descartados (0-100)
+
+    NetConditions() : latencyMs(0), jitterMs(0), lossPercent(0.0f) {}
+
+    bool active() const {
+        return latencyMs > 0 || jitterMs > 0 || lossPercent > 0.0f;
+    }
+};
+
+// Milisegundos de un reloj monótono (no depende de SDL_Init, sirve también sin ventana)
+inline uint32_t netTimeMs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class UdpSocket {
+public:
+    UdpSocket() : fd(-1), hasPeer(false), random(0x5EED1234u) {
+        memset(&peer, 0, sizeof(peer));
+    }
+
+    ~UdpSocket() {
+        close();
+    }
+
+    // Abre el socket en el puerto indicado (0 = cualquiera)
+    bool open(uint16_t port) {
+        close();
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            std::cout << "Error creando el socket UDP: " << strerror(errno) << std::endl;
+            return false;
+        }
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            std::cout << "Error abriendo el puerto UDP " << port << ": " << strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        return true;
+    }
+
+    // Fija el destino; sin llamarla, el primer remitente pasa a ser el destino (anfitrión)
+    bool setPeer(const std::string& host, uint16_t port) {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+            std::cout << "No se pudo resolver " << host << std::endl;
+            return false;
+        }
+        memcpy(&peer, result->ai_addr, sizeof(peer));
+        peer.sin_port = htons(port);
+        freeaddrinfo(result);
+        hasPeer = true;
+        return true;
+    }
+
+    bool hasDestination() const {
+        return hasPeer;
+    }
+
+    void setConditions(const NetConditions& netConditions) {
+        conditions = netConditions;
+    }
+
+    void send(const uint8_t* data, size_t size) {
+        if (fd < 0 || !hasPeer || size > NET_MAX_PACKET) return;
+        if (!conditions.active()) {
+            sendNow(data, size);
+            return;
+        }
+        if (conditions.lossPercent > 0.0f && (random.next() % 10000) < conditions.lossPercent * 100.0f) {
+            return; // Perdido
+        }
+        DelayedPacket packet;
+        memcpy(packet.data, data, size);
+        packet.size = size;
+        packet.sendAt = netTimeMs() + conditions.latencyMs +
+                        (conditions.jitterMs > 0 ? random.next() % (conditions.jitterMs + 1) : 0);
+        delayed.push_back(packet);
+    }
+
+    // Sin pasar por el simulador: para el último paquete antes de close(), que descartaría
+    // los retrasados
+    void sendImmediate(const uint8_t* data, size_t size) {
+        if (fd < 0 || !hasPeer || size > NET_MAX_PACKET) return;
+        sendNow(data, size);
+    }
+
+    // Envía los paquetes retrasados que ya toca enviar (el jitter puede reordenarlos)
+    void poll() {
+        if (delayed.empty()) return;
+        uint32_t now = netTimeMs();
+        for (size_t i = 0; i < delayed.size();) {
+            if ((int32_t)(now - delayed[i].sendAt) >= 0) {
+                sendNow(delayed[i].data, delayed[i].size);
+                delayed.erase(delayed.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    // Lee un paquete si hay alguno; devuelve su tamaño o 0
+    size_t receive(uint8_t* buffer, size_t capacity) {
+        if (fd < 0) return 0;
+        while (true) {
+            sockaddr_in from;
+            socklen_t fromSize = sizeof(from);
+            ssize_t size = recvfrom(fd, buffer, capacity, 0, (sockaddr*)&from, &fromSize);
+            if (size <= 0) return 0;
+            if (!hasPeer) {
+                peer = from;
+                hasPeer = true;
+            } else if (from.sin_addr.s_addr != peer.sin_addr.s_addr || from.sin_port != peer.sin_port) {
+                continue; // Paquete de un tercero
+            }
+            return (size_t)size;
+        }
+    }
+
+    void close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        delayed.clear();
+        hasPeer = false;
+    }
+
+private:
+    struct DelayedPacket {
+        uint8_t data[NET_MAX_PACKET];
+        size_t size;
+        uint32_t sendAt;
+    };
+
+    int fd;
+    sockaddr_in peer;
+    bool hasPeer;
+    NetConditions conditions;
+    XorShift32 random;
+    std::deque<DelayedPacket> delayed;
+
+    void sendNow(const uint8_t* data, size_t size) {
+        sendto(fd, data, size, 0, (const sockaddr*)&peer, sizeof(peer));
+    }
+};
+
+#endif
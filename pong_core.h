@@ -0,0 +1,582 @@
+#ifndef PONG_CORE_H
+#define PONG_CORE_H
+
+// Núcleo de la simulación: constantes del campo, paletas, pelota y un tick de partida.
+// No depende de ventana, renderer ni audio, así que se comparte entre el juego y el modo headless.
+
+#include "fixed_point.h"
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <stdint.h>
+
+const int WINDOW_WIDTH = 800;
+const int WINDOW_HEIGHT = 600;
+const int GAME_MARGIN_TOP = 80;
+const int GAME_MARGIN_BOTTOM = 60;
+const int GAME_MARGIN_SIDES = 40;
+const int GAME_WIDTH = WINDOW_WIDTH - (GAME_MARGIN_SIDES * 2);
+const int GAME_HEIGHT = WINDOW_HEIGHT - GAME_MARGIN_TOP - GAME_MARGIN_BOTTOM;
+const int PADDLE_WIDTH = 20;
+const int PADDLE_HEIGHT = 80; // Más pequeño para el área reducida
+const int BALL_SIZE = 12; // Más pequeño
+const float PADDLE_SPEED = 250.0f;
+const float BALL_SPEED = 200.0f;
+const int DEFAULT_TICK_RATE = 120;   // Ticks de simulación por segundo
+const int MIN_TICK_RATE = 10;
+const int MAX_TICK_RATE = 1000;
+const float MAX_FRAME_TIME = 0.25f;  // Límite por frame para evitar la "espiral de la muerte"
+
+const int MAX_CONTACTS_PER_STEP = 16; // Colisión continua: contactos resueltos como máximo en un paso
+
+inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+// Generador pseudoaleatorio xorshift32: barato y determinista entre plataformas
+struct XorShift32 {
+    uint32_t state;
+    
+    explicit XorShift32(uint32_t seed = 2463534242u) : state(seed ? seed : 2463534242u) {}
+    
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    
+    // Valor uniforme en [-1, 1]
+    float nextSigned() {
+        return (float)(next() >> 8) / (float)(1 << 23) - 1.0f;
+    }
+};
+
+enum AIMode {
+    AI_CHASE,   // Persigue la altura actual de la pelota (IA original)
+    AI_PREDICT  // Calcula dónde cruzará la pelota y va hacia allí
+};
+
+// Parámetros ajustables de la IA
+struct AIParams {
+    AIMode mode;
+    float difficulty;    // 0.0 = muy fácil, 1.0 = perfecto (fracción de la velocidad de la paleta)
+    float deadZone;      // Zona muerta en píxeles para evitar temblores (solo AI_CHASE)
+    float reactionDelay; // Segundos hasta reaccionar a un cambio de trayectoria (solo AI_PREDICT)
+    float aimError;      // Error máximo en píxeles del punto previsto (solo AI_PREDICT)
+    
+    AIParams() : mode(AI_CHASE), difficulty(0.8f), deadZone(10.0f), reactionDelay(0.15f), aimError(20.0f) {}
+    AIParams(float diff, float dz) : mode(AI_CHASE), difficulty(diff), deadZone(dz),
+                                     reactionDelay(0.15f), aimError(20.0f) {}
+};
+
+// El stick se cuantiza a pasos de 1/127 para que una repetición pueda guardarlo en un byte
+// y reproducir exactamente el mismo valor
+const int AXIS_STEPS = 127;
+
+inline int axisToSteps(float axis) {
+    return (int)std::lround(axis * AXIS_STEPS);
+}
+
+inline float axisFromSteps(int steps) {
+    return (float)steps / AXIS_STEPS;
+}
+
+// Eje del stick en el tipo de la física. Ya viene cuantizado, así que en coma fija se toma
+// el paso entero y no el float
+template <typename Real>
+inline Real axisValue(float axis) {
+    return axis;
+}
+
+template <>
+inline Fixed16 axisValue<Fixed16>(float axis) {
+    return Fixed16::fromRatio(axisToSteps(axis), AXIS_STEPS);
+}
+
+// Valor uniforme en [-1, 1] en el tipo de la física: en coma fija sale de los mismos bits del
+// generador sin pasar por float
+template <typename Real>
+inline Real randomSigned(XorShift32& random) {
+    return random.nextSigned();
+}
+
+template <>
+inline Fixed16 randomSigned<Fixed16>(XorShift32& random) {
+    return Fixed16::fromRaw((int32_t)(random.next() >> 15) - Fixed16::ONE);
+}
+
+// Altura a la que la pelota (esquina superior) llegará a faceX, plegando los rebotes en las
+// paredes de forma analítica: la trayectoria sin paredes se refleja en un periodo de 2 * alto.
+template <typename Real>
+inline Real predictBallY(Real ballX, Real ballY, Real velocityX, Real velocityY, Real faceX) {
+    const Real minY = GAME_MARGIN_TOP;
+    const Real span = GAME_HEIGHT - BALL_SIZE;
+    Real time = (faceX - ballX) / velocityX;
+    Real unfolded = ballY - minY + velocityY * time;
+    Real folded = realMod(unfolded, Real(2) * span);
+    if (folded < Real(0)) folded += Real(2) * span;
+    if (folded > span) folded = Real(2) * span - folded;
+    return minY + folded;
+}
+
+// Paleta, pelota y partida son plantillas sobre el tipo numérico de la física, como
+// BasicBatchPhysics: con float son Paddle, Ball y Match de siempre y con Fixed16 dan los
+// mismos bits en cualquier máquina y compilación (ver PhysicsReal más abajo)
+template <typename Real>
+class BasicPaddle {
+public:
+    Real x, y;
+    Real speed;
+    bool isAI;
+    AIParams ai;
+    
+    // Caché de la IA predictiva: solo se recalcula cuando cambia la velocidad de la pelota
+    Real cachedVelocityX, cachedVelocityY;
+    Real targetY;         // Objetivo que sigue la paleta ahora
+    Real pendingTargetY;  // Nuevo objetivo, efectivo cuando pasa el tiempo de reacción
+    Real reactionTimer;
+    XorShift32 aiRandom;
+    
+    BasicPaddle(Real startX, Real startY, bool aiControlled = false) : 
+        x(startX), y(startY), speed(Real(PADDLE_SPEED)), isAI(aiControlled),
+        cachedVelocityX(0), cachedVelocityY(0), targetY(startY), pendingTargetY(startY),
+        reactionTimer(0), aiRandom(0x9E3779B9u ^ (uint32_t)(int)startX) {}
+    
+    void resetAI() {
+        cachedVelocityX = Real(0);
+        cachedVelocityY = Real(0);
+        targetY = pendingTargetY = Real(GAME_MARGIN_TOP + GAME_HEIGHT / 2 - PADDLE_HEIGHT / 2);
+        reactionTimer = Real(0);
+        aiRandom = XorShift32(0x9E3779B9u ^ (uint32_t)(int)x);
+    }
+    
+    void update(Real deltaTime, bool upPressed, bool downPressed) {
+        if (upPressed && y > Real(GAME_MARGIN_TOP)) {
+            y -= speed * deltaTime;
+        }
+        if (downPressed && y < Real(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT)) {
+            y += speed * deltaTime;
+        }
+    }
+    
+    // Control analógico: velocidad proporcional al stick, limitada al área de juego
+    void updateAnalog(Real deltaTime, float axis) {
+        y += speed * axisValue<Real>(axis) * deltaTime;
+        y = realMax(Real(GAME_MARGIN_TOP), realMin(y, Real(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT)));
+    }
+    
+    void updateAI(Real deltaTime, Real ballY, Real ballVelocityX) {
+        if (!isAI) return;
+        
+        // Solo reacciona si la pelota se acerca (hacia la derecha o la izquierda según el lado)
+        bool approaching = (x > Real(WINDOW_WIDTH / 2)) ? (ballVelocityX > Real(0)) : (ballVelocityX < Real(0));
+        if (approaching) {
+            Real paddleCenter = y + Real(PADDLE_HEIGHT / 2);
+            
+            // Agregar algo de imprecisión para hacer la IA más realista
+            Real aiSpeed = speed * Real(ai.difficulty);
+            
+            // Zona muerta para evitar temblores
+            Real deadZone = Real(ai.deadZone);
+            
+            if (paddleCenter < ballY - deadZone) {
+                // Mover hacia abajo
+                if (y < Real(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT)) {
+                    y += aiSpeed * deltaTime;
+                }
+            } else if (paddleCenter > ballY + deadZone) {
+                // Mover hacia arriba
+                if (y > Real(GAME_MARGIN_TOP)) {
+                    y -= aiSpeed * deltaTime;
+                }
+            }
+        }
+    }
+    
+    // IA predictiva: el punto de cruce se resuelve una vez por cambio de trayectoria
+    // (golpe, rebote en pared o saque) y se guarda; cada tick solo avanza hacia el objetivo,
+    // sin comparar la posición de la pelota.
+    void updatePredictiveAI(Real deltaTime, Real ballX, Real ballY, Real ballVelocityX, Real ballVelocityY) {
+        if (!isAI) return;
+        
+        if (ballVelocityX != cachedVelocityX || ballVelocityY != cachedVelocityY) {
+            cachedVelocityX = ballVelocityX;
+            cachedVelocityY = ballVelocityY;
+            pendingTargetY = computeTarget(ballX, ballY, ballVelocityX, ballVelocityY);
+            reactionTimer = Real(ai.reactionDelay);
+        }
+        
+        reactionTimer -= deltaTime;
+        if (reactionTimer <= Real(0)) {
+            targetY = pendingTargetY;
+        }
+        
+        // Paso acotado por la velocidad de la IA, sin ramas sobre la posición
+        Real maxStep = speed * Real(ai.difficulty) * deltaTime;
+        Real delta = realMin(realMax(targetY - y, -maxStep), maxStep);
+        y += delta;
+    }
+    
+    SDL_Rect getRect() const {
+        return {(int)x, (int)y, PADDLE_WIDTH, PADDLE_HEIGHT};
+    }
+    
+    // Rectángulo interpolado entre el estado del tick anterior y el actual
+    SDL_Rect getInterpolatedRect(const BasicPaddle& previous, float alpha) const {
+        return {(int)lerp(realToFloat(previous.x), realToFloat(x), alpha),
+                (int)lerp(realToFloat(previous.y), realToFloat(y), alpha),
+                PADDLE_WIDTH, PADDLE_HEIGHT};
+    }
+    
+private:
+    Real computeTarget(Real ballX, Real ballY, Real ballVelocityX, Real ballVelocityY) {
+        const Real centerY = GAME_MARGIN_TOP + GAME_HEIGHT / 2 - PADDLE_HEIGHT / 2;
+        bool isRight = x > Real(WINDOW_WIDTH / 2);
+        bool approaching = isRight ? (ballVelocityX > Real(0)) : (ballVelocityX < Real(0));
+        if (!approaching) {
+            return centerY; // Volver al centro mientras la pelota se aleja
+        }
+        
+        Real faceX = isRight ? x - Real(BALL_SIZE) : x + Real(PADDLE_WIDTH);
+        Real impactY = predictBallY(ballX, ballY, ballVelocityX, ballVelocityY, faceX);
+        Real target = impactY + Real(BALL_SIZE / 2) - Real(PADDLE_HEIGHT / 2) +
+                      randomSigned<Real>(aiRandom) * Real(ai.aimError);
+        return realMin(realMax(target, Real(GAME_MARGIN_TOP)),
+                       Real(GAME_MARGIN_TOP + GAME_HEIGHT - PADDLE_HEIGHT));
+    }
+};
+
+template <typename Real>
+class BasicBall {
+public:
+    typedef BasicPaddle<Real> Paddle;
+    
+    Real x, y;
+    Real velocityX, velocityY;
+    
+    BasicBall() : x(WINDOW_WIDTH / 2), y(GAME_MARGIN_TOP + GAME_HEIGHT / 2), 
+                  velocityX(Real(BALL_SPEED)), velocityY(Real(BALL_SPEED)) {}
+    
+    // Devuelve true si rebota en una pared
+    bool update(Real deltaTime) {
+        x += velocityX * deltaTime;
+        y += velocityY * deltaTime;
+        
+        // Rebote en paredes superior e inferior (dentro del área de juego)
+        if (y <= Real(GAME_MARGIN_TOP) || y >= Real(GAME_MARGIN_TOP + GAME_HEIGHT - BALL_SIZE)) {
+            velocityY = -velocityY;
+            return true;
+        }
+        return false;
+    }
+    
+    void reset() {
+        x = Real(WINDOW_WIDTH / 2);
+        y = Real(GAME_MARGIN_TOP + GAME_HEIGHT / 2);
+        velocityX = (velocityX > Real(0)) ? -Real(BALL_SPEED) : Real(BALL_SPEED);
+        velocityY = Real(BALL_SPEED);
+    }
+    
+    bool checkCollision(const Paddle& paddle) {
+        SDL_Rect ballRect = {(int)x, (int)y, BALL_SIZE, BALL_SIZE};
+        SDL_Rect paddleRect = paddle.getRect();
+        
+        if (SDL_HasIntersection(&ballRect, &paddleRect)) {
+            velocityX = -velocityX;
+            
+            // Añadir efecto según donde golpee la pelota
+            Real paddleCenter = paddle.y + Real(PADDLE_HEIGHT / 2);
+            Real ballCenter = y + Real(BALL_SIZE / 2);
+            Real hitPos = (ballCenter - paddleCenter) / Real(PADDLE_HEIGHT / 2);
+            velocityY = hitPos * Real(BALL_SPEED);
+            
+            return true;
+        }
+        return false;
+    }
+    
+    // Colisión continua (swept AABB): avanza deltaTime buscando el primer instante de
+    // contacto con las paredes o las paletas, lo resuelve y continúa con el tiempo que
+    // queda, así que varios rebotes en un mismo paso se resuelven en orden y la pelota
+    // no atraviesa las paletas aunque el paso sea grande. Devuelve los golpes de paleta;
+    // si wallHits no es nulo, suma en él los rebotes en paredes.
+    int advance(Real deltaTime, const Paddle& left, const Paddle& right, int* wallHits = nullptr) {
+        const Real minY = GAME_MARGIN_TOP;
+        const Real maxY = GAME_MARGIN_TOP + GAME_HEIGHT - BALL_SIZE;
+        Real remaining = deltaTime;
+        int paddleHits = 0;
+        
+        for (int contact = 0; contact < MAX_CONTACTS_PER_STEP && remaining > Real(0); contact++) {
+            // Paredes: solo cuentan si la pelota se mueve hacia ellas (nunca queda atrapada)
+            Real hitTime = remaining;
+            int hitKind = CONTACT_NONE;
+            if (velocityY < Real(0)) {
+                Real t = (y <= minY) ? Real(0) : (minY - y) / velocityY;
+                if (t <= hitTime) { hitTime = t; hitKind = CONTACT_WALL_TOP; }
+            } else if (velocityY > Real(0)) {
+                Real t = (y >= maxY) ? Real(0) : (maxY - y) / velocityY;
+                if (t <= hitTime) { hitTime = t; hitKind = CONTACT_WALL_BOTTOM; }
+            }
+            
+            bool xAxis = true;
+            Real t;
+            bool axis;
+            if (sweepPaddle(left, true, hitTime, t, axis) && t <= hitTime) {
+                hitTime = t; hitKind = CONTACT_LEFT_PADDLE; xAxis = axis;
+            }
+            if (sweepPaddle(right, false, hitTime, t, axis) && t <= hitTime) {
+                hitTime = t; hitKind = CONTACT_RIGHT_PADDLE; xAxis = axis;
+            }
+            
+            x += velocityX * hitTime;
+            y += velocityY * hitTime;
+            remaining -= hitTime;
+            
+            if (hitKind == CONTACT_NONE) {
+                break;
+            } else if (hitKind == CONTACT_WALL_TOP) {
+                y = minY;
+                velocityY = -velocityY;
+                if (wallHits) (*wallHits)++;
+            } else if (hitKind == CONTACT_WALL_BOTTOM) {
+                y = maxY;
+                velocityY = -velocityY;
+                if (wallHits) (*wallHits)++;
+            } else {
+                const Paddle& paddle = (hitKind == CONTACT_LEFT_PADDLE) ? left : right;
+                if (xAxis) {
+                    // Cara frontal: devolver con efecto según el punto de impacto
+                    x = (hitKind == CONTACT_LEFT_PADDLE) ? paddle.x + Real(PADDLE_WIDTH) : paddle.x - Real(BALL_SIZE);
+                    velocityX = -velocityX;
+                    Real paddleCenter = paddle.y + Real(PADDLE_HEIGHT / 2);
+                    Real ballCenter = y + Real(BALL_SIZE / 2);
+                    Real hitPos = (ballCenter - paddleCenter) / Real(PADDLE_HEIGHT / 2);
+                    velocityY = hitPos * Real(BALL_SPEED);
+                    paddleHits++;
+                } else {
+                    // Canto superior o inferior: la pelota se desvía pero sigue hacia la portería
+                    y = (velocityY > Real(0)) ? paddle.y - Real(BALL_SIZE) : paddle.y + Real(PADDLE_HEIGHT);
+                    velocityY = -velocityY;
+                }
+            }
+        }
+        
+        // Tras demasiados contactos en un paso, se consume el resto sin más colisiones
+        if (remaining > Real(0)) {
+            x += velocityX * remaining;
+            y += velocityY * remaining;
+        }
+        if (y < minY) y = minY;
+        if (y > maxY) y = maxY;
+        return paddleHits;
+    }
+    
+    SDL_Rect getRect() const {
+        return {(int)x, (int)y, BALL_SIZE, BALL_SIZE};
+    }
+    
+    SDL_Rect getInterpolatedRect(const BasicBall& previous, float alpha) const {
+        return {(int)lerp(realToFloat(previous.x), realToFloat(x), alpha),
+                (int)lerp(realToFloat(previous.y), realToFloat(y), alpha),
+                BALL_SIZE, BALL_SIZE};
+    }
+    
+private:
+    enum ContactKind {
+        CONTACT_NONE,
+        CONTACT_WALL_TOP,
+        CONTACT_WALL_BOTTOM,
+        CONTACT_LEFT_PADDLE,
+        CONTACT_RIGHT_PADDLE
+    };
+    
+    // Tiempo de impacto contra una paleta: la esquina superior izquierda de la pelota como
+    // rayo contra la paleta ensanchada por el tamaño de la pelota (suma de Minkowski).
+    // xAxis indica si el contacto es con una cara vertical (frontal o trasera).
+    bool sweepPaddle(const Paddle& paddle, bool isLeft, Real maxTime, Real& hitTime, bool& xAxis) const {
+        const Real minX = paddle.x - Real(BALL_SIZE), maxX = paddle.x + Real(PADDLE_WIDTH);
+        const Real minY = paddle.y - Real(BALL_SIZE), maxY = paddle.y + Real(PADDLE_HEIGHT);
+        const Real infinity = realHuge<Real>();
+        
+        Real enterX, exitX, enterY, exitY;
+        if (velocityX == Real(0)) {
+            if (x <= minX || x >= maxX) return false;
+            enterX = -infinity; exitX = infinity;
+        } else {
+            Real t1 = (minX - x) / velocityX, t2 = (maxX - x) / velocityX;
+            enterX = t1 < t2 ? t1 : t2; exitX = t1 < t2 ? t2 : t1;
+        }
+        if (velocityY == Real(0)) {
+            if (y <= minY || y >= maxY) return false;
+            enterY = -infinity; exitY = infinity;
+        } else {
+            Real t1 = (minY - y) / velocityY, t2 = (maxY - y) / velocityY;
+            enterY = t1 < t2 ? t1 : t2; exitY = t1 < t2 ? t2 : t1;
+        }
+        
+        Real enter = enterX > enterY ? enterX : enterY;
+        Real exit = exitX < exitY ? exitX : exitY;
+        if (enter >= exit || exit <= Real(0) || enter > maxTime) return false;
+        
+        if (enter < Real(0)) {
+            // Ya solapadas (la paleta se movió sobre la pelota): se devuelve solo si la
+            // pelota va hacia la paleta, para no rebotar una y otra vez dentro de ella
+            bool towards = isLeft ? (velocityX < Real(0)) : (velocityX > Real(0));
+            if (!towards) return false;
+            hitTime = Real(0);
+            xAxis = true;
+            return true;
+        }
+        
+        hitTime = enter;
+        xAxis = enterX >= enterY;
+        return true;
+    }
+};
+
+// Entrada de una paleta para un tick
+struct PaddleInput {
+    bool up;
+    bool down;
+    float axis;  // Stick analógico en [-1, 1] (negativo = arriba); solo se usa sin up/down
+    
+    PaddleInput() : up(false), down(false), axis(0.0f) {}
+    PaddleInput(bool upPressed, bool downPressed) : up(upPressed), down(downPressed), axis(0.0f) {}
+};
+
+// Modelo de colisión de Match::step()
+enum CollisionMode {
+    COLLISION_SWEPT,    // Colisión continua con Ball::advance() (por defecto)
+    COLLISION_DISCRETE  // Modelo original: mover y comprobar solapamiento al final del paso
+};
+
+// Resultado de un tick de partida
+enum PointScored {
+    NO_POINT = 0,
+    POINT_PLAYER1 = 1,
+    POINT_PLAYER2 = 2
+};
+
+// Sucesos de un tick (Match::events), para los efectos de sonido. No forman parte del
+// estado: se recalculan en cada step() y no se guardan en repeticiones ni instantáneas.
+enum MatchEvent {
+    EVENT_PADDLE_HIT = 1,
+    EVENT_WALL_BOUNCE = 2,
+    EVENT_POINT = 4
+};
+
+// Estado completo de una partida y la lógica de un tick de simulación
+template <typename Real>
+class BasicMatch {
+public:
+    typedef BasicPaddle<Real> Paddle;
+    typedef BasicBall<Real> Ball;
+    
+    Paddle player1, player2;
+    Ball ball;
+    int score1, score2;
+    int rallyHits;        // Golpes de paleta en el punto actual
+    int lastRallyLength;  // Golpes de paleta del último punto terminado
+    CollisionMode collisionMode;
+    uint8_t events;       // MatchEvent del último step()
+    
+    BasicMatch() : player1(GAME_MARGIN_SIDES + 20, GAME_MARGIN_TOP + GAME_HEIGHT / 2 - PADDLE_HEIGHT / 2, false),
+                   player2(WINDOW_WIDTH - GAME_MARGIN_SIDES - 20 - PADDLE_WIDTH, GAME_MARGIN_TOP + GAME_HEIGHT / 2 - PADDLE_HEIGHT / 2, true),
+                   score1(0), score2(0), rallyHits(0), lastRallyLength(0), collisionMode(COLLISION_SWEPT), events(0) {}
+    
+    void reset() {
+        score1 = 0;
+        score2 = 0;
+        player1.x = Real(GAME_MARGIN_SIDES + 20);
+        player1.y = Real(GAME_MARGIN_TOP + GAME_HEIGHT / 2 - PADDLE_HEIGHT / 2);
+        player2.x = Real(WINDOW_WIDTH - GAME_MARGIN_SIDES - 20 - PADDLE_WIDTH);
+        player2.y = Real(GAME_MARGIN_TOP + GAME_HEIGHT / 2 - PADDLE_HEIGHT / 2);
+        ball.reset();
+        player1.resetAI();
+        player2.resetAI();
+        rallyHits = 0;
+        lastRallyLength = 0;
+        events = 0;
+    }
+    
+    // Avanza un tick. Las paletas con isAI ignoran su entrada y usan updateAI().
+    PointScored step(Real deltaTime, const PaddleInput& input1, const PaddleInput& input2) {
+        updatePaddle(player1, deltaTime, input1);
+        updatePaddle(player2, deltaTime, input2);
+        
+        int hitsBefore = rallyHits;
+        int wallHits = 0;
+        if (collisionMode == COLLISION_SWEPT) {
+            // Pelota, paredes y paletas resueltas de forma continua dentro del paso
+            rallyHits += ball.advance(deltaTime, player1, player2, &wallHits);
+        } else {
+            // Actualizar pelota
+            if (ball.update(deltaTime)) wallHits++;
+            
+            // Colisiones con paletas
+            if (ball.checkCollision(player1)) rallyHits++;
+            if (ball.checkCollision(player2)) rallyHits++;
+        }
+        events = 0;
+        if (rallyHits != hitsBefore) events |= EVENT_PADDLE_HIT;
+        if (wallHits > 0) events |= EVENT_WALL_BOUNCE;
+        
+        // Verificar puntuación (cuando la pelota sale del área de juego)
+        if (ball.x < Real(GAME_MARGIN_SIDES)) {
+            score2++;
+            endRally();
+            events |= EVENT_POINT;
+            return POINT_PLAYER2;
+        }
+        if (ball.x > Real(WINDOW_WIDTH - GAME_MARGIN_SIDES)) {
+            score1++;
+            endRally();
+            events |= EVENT_POINT;
+            return POINT_PLAYER1;
+        }
+        return NO_POINT;
+    }
+    
+private:
+    void endRally() {
+        lastRallyLength = rallyHits;
+        rallyHits = 0;
+        ball.reset();
+    }
+    
+    void updatePaddle(Paddle& paddle, Real deltaTime, const PaddleInput& input) {
+        if (paddle.isAI && paddle.ai.mode == AI_PREDICT) {
+            paddle.updatePredictiveAI(deltaTime, ball.x, ball.y, ball.velocityX, ball.velocityY);
+        } else if (paddle.isAI) {
+            paddle.updateAI(deltaTime, ball.y + Real(BALL_SIZE / 2), ball.velocityX);
+        } else if (input.axis != 0.0f && !input.up && !input.down) {
+            paddle.updateAnalog(deltaTime, input.axis);
+        } else {
+            paddle.update(deltaTime, input.up, input.down);
+        }
+    }
+};
+
+// Tipo numérico de Paddle, Ball y Match: float por defecto. Compilando con
+// -DPONG_FIXED_PHYSICS todo lo que simula partidas (juego, repeticiones, red con rollback,
+// servidor y entorno) usa Fixed16 y una partida da los mismos bits en cualquier máquina.
+// BasicMatch<Fixed16> y BasicMatch<float> existen siempre (--check-determinism usa las dos).
+#ifdef PONG_FIXED_PHYSICS
+typedef Fixed16 PhysicsReal;
+#else
+typedef float PhysicsReal;
+#endif
+
+typedef BasicPaddle<PhysicsReal> Paddle;
+typedef BasicBall<PhysicsReal> Ball;
+typedef BasicMatch<PhysicsReal> Match;
+typedef BasicMatch<float> FloatMatch;
+typedef BasicMatch<Fixed16> FixedMatch;
+
+// Paso de la física para tickRate ticks por segundo: 1.0f / tickRate en float y la fracción
+// entera en coma fija (sin pasar por float)
+inline PhysicsReal physicsDelta(int tickRate) {
+    return realFromRatio<PhysicsReal>(1, tickRate);
+}
+
+#endif
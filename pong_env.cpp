@@ -0,0 +1,126 @@
+// Biblioteca del entorno de aprendizaje por refuerzo (make env-lib): la API en C de
+// pong_env.h sobre VectorEnv y SharedEnvClient.
+
+#include "pong_env.h"
+#include "shared_env.h"
+#include "vector_env.h"
+
+struct PongEnv {
+    VectorEnv env;
+
+    explicit PongEnv(const EnvConfig& config) : env(config) {}
+};
+
+struct PongSharedEnv {
+    SharedEnvClient client;
+};
+
+static EnvBuffers makeBuffers(float* observations, uint8_t* frames, float* rewards, uint8_t* dones) {
+    EnvBuffers buffers;
+    buffers.observations = observations;
+    buffers.frames = frames;
+    buffers.rewards = rewards;
+    buffers.dones = dones;
+    return buffers;
+}
+
+extern "C" {
+
+PongEnv* pong_env_create(int num_envs, int ticks_per_step, int points_per_episode, int frame_scale,
+                         int threads, uint32_t seed) {
+    EnvConfig config;
+    config.numEnvs = num_envs;
+    config.ticksPerStep = ticks_per_step;
+    config.pointsPerEpisode = points_per_episode;
+    config.frameScale = frame_scale;
+    config.threads = threads > 0 ? (unsigned)threads : 0;
+    config.seed = seed;
+    return new PongEnv(config);
+}
+
+void pong_env_destroy(PongEnv* env) {
+    delete env;
+}
+
+int pong_env_observation_size(void) {
+    return ENV_OBSERVATION_SIZE;
+}
+
+int pong_env_num_envs(const PongEnv* env) {
+    return env->env.getNumEnvs();
+}
+
+int pong_env_frame_width(const PongEnv* env) {
+    return env->env.getFrameWidth();
+}
+
+int pong_env_frame_height(const PongEnv* env) {
+    return env->env.getFrameHeight();
+}
+
+void pong_env_reset(PongEnv* env, float* observations, uint8_t* frames) {
+    env->env.reset(makeBuffers(observations, frames, nullptr, nullptr));
+}
+
+void pong_env_step(PongEnv* env, const uint8_t* actions, float* observations, uint8_t* frames,
+                   float* rewards, uint8_t* dones) {
+    env->env.step(actions, makeBuffers(observations, frames, rewards, dones));
+}
+
+PongSharedEnv* pong_env_attach(const char* name) {
+    PongSharedEnv* env = new PongSharedEnv();
+    if (!env->client.attach(name)) {
+        delete env;
+        return nullptr;
+    }
+    return env;
+}
+
+void pong_env_detach(PongSharedEnv* env, int close_server) {
+    if (!env) return;
+    if (close_server) env->client.close();
+    env->client.detach();
+    delete env;
+}
+
+int pong_env_shared_num_envs(const PongSharedEnv* env) {
+    return env->client.getNumEnvs();
+}
+
+int pong_env_shared_frame_width(const PongSharedEnv* env) {
+    return env->client.getFrameWidth();
+}
+
+int pong_env_shared_frame_height(const PongSharedEnv* env) {
+    return env->client.getFrameHeight();
+}
+
+uint8_t* pong_env_shared_actions(PongSharedEnv* env) {
+    return env->client.getActions();
+}
+
+const float* pong_env_shared_observations(const PongSharedEnv* env) {
+    return env->client.getObservations();
+}
+
+const uint8_t* pong_env_shared_frames(const PongSharedEnv* env) {
+    return env->client.getFrames();
+}
+
+const float* pong_env_shared_rewards(const PongSharedEnv* env) {
+    return env->client.getRewards();
+}
+
+const uint8_t* pong_env_shared_dones(const PongSharedEnv* env) {
+    return env->client.getDones();
+}
+
+int pong_env_shared_reset(PongSharedEnv* env, int timeout_ms) {
+    return env->client.reset(timeout_ms) ? 1 : 0;
+}
+
+int pong_env_shared_step(PongSharedEnv* env, int timeout_ms) {
+    return env->client.step(timeout_ms) ? 1 : 0;
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef PONG_ENV_H
+#define PONG_ENV_H
+
+/*
+ * API en C del entorno vectorizado (libpong_env.so), para entrenadores en otros lenguajes
+ * (ctypes, cffi...). Envuelve VectorEnv (vector_env.h) y el cliente de memoria compartida
+ * (shared_env.h). Los buffers son del llamador y contiguos:
+ *   observations: num_envs * pong_env_observation_size() floats
+ *   frames:       num_envs * ancho * alto bytes, o NULL sin imagen
+ *   rewards:      num_envs floats;  dones: num_envs bytes (0 sigue, 1 terminado, 2 truncado)
+ *   actions:      num_envs bytes (0 quieto, 1 arriba, 2 abajo)
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PongEnv PongEnv;
+typedef struct PongSharedEnv PongSharedEnv;
+
+/* Entorno en el mismo proceso; frame_scale 0 = sin imagen, threads 0 = todos los núcleos */
+PongEnv* pong_env_create(int num_envs, int ticks_per_step, int points_per_episode, int frame_scale,
+                         int threads, uint32_t seed);
+void pong_env_destroy(PongEnv* env);
+int pong_env_observation_size(void);
+int pong_env_num_envs(const PongEnv* env);
+int pong_env_frame_width(const PongEnv* env);
+int pong_env_frame_height(const PongEnv* env);
+void pong_env_reset(PongEnv* env, float* observations, uint8_t* frames);
+void pong_env_step(PongEnv* env, const uint8_t* actions, float* observations, uint8_t* frames,
+                   float* rewards, uint8_t* dones);
+
+/* Cliente de un servidor pong-env --shm NOMBRE en otro proceso. Los punteros apuntan a la
+ * memoria compartida: se escriben las acciones y tras reset/step se leen los resultados en
+ * el sitio. attach espera hasta 5 s a que el servidor cree el segmento. timeout_ms < 0 espera
+ * sin límite; reset y step devuelven 0 si no hay respuesta. */
+PongSharedEnv* pong_env_attach(const char* name);
+void pong_env_detach(PongSharedEnv* env, int close_server);
+int pong_env_shared_num_envs(const PongSharedEnv* env);
+int pong_env_shared_frame_width(const PongSharedEnv* env);
+int pong_env_shared_frame_height(const PongSharedEnv* env);
+uint8_t* pong_env_shared_actions(PongSharedEnv* env);
+const float* pong_env_shared_observations(const PongSharedEnv* env);
+const uint8_t* pong_env_shared_frames(const PongSharedEnv* env);
+const float* pong_env_shared_rewards(const PongSharedEnv* env);
+const uint8_t* pong_env_shared_dones(const PongSharedEnv* env);
+int pong_env_shared_reset(PongSharedEnv* env, int timeout_ms);
+int pong_env_shared_step(PongSharedEnv* env, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
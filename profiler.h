@@ -0,0 +1,152 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Perfilador de frames por fases.
+// Cada frame se divide en fases (eventos, update, render, present y espera) que se miden
+// con SDL_GetPerformanceCounter marcando el final de cada una. Se guardan los últimos
+// WINDOW frames para calcular p50/p95/p99/máx (el overlay de F3) y, si se pide, todos los
+// frames para volcarlos a CSV al salir. Desactivado, cada marca es solo una comprobación.
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+enum ProfilePhase {
+    PHASE_EVENTS,
+    PHASE_UPDATE,
+    PHASE_RENDER,
+    PHASE_PRESENT,
+    PHASE_WAIT,
+    PHASE_COUNT
+};
+
+inline const char* profilePhaseName(int phase) {
+    static const char* names[] = {"eventos", "update", "render", "present", "espera", "total"};
+    return names[phase];
+}
+
+struct PhaseStats {
+    float p50, p95, p99, max; // Milisegundos
+
+    PhaseStats() : p50(0), p95(0), p99(0), max(0) {}
+};
+
+class FrameProfiler {
+public:
+    static const int WINDOW = 240;           // Frames de la ventana deslizante (~4 s a 60 Hz)
+    static const int TOTAL = PHASE_COUNT;    // Índice de la suma de todas las fases
+
+    FrameProfiler() : enabled(false), overlayVisible(false), recordFrames(false),
+                      msPerCount(0.0), lastMark(0), windowFill(0), windowPos(0) {
+        for (int p = 0; p <= TOTAL; p++) current[p] = 0.0f;
+    }
+
+    // Con CSV se mide siempre; sin él, solo mientras el overlay está visible
+    void setRecordFrames(bool record) {
+        recordFrames = record;
+        updateEnabled();
+    }
+
+    void toggleOverlay() {
+        overlayVisible = !overlayVisible;
+        updateEnabled();
+    }
+
+    bool isOverlayVisible() const {
+        return overlayVisible;
+    }
+
+    void beginFrame() {
+        if (!enabled) return;
+        for (int p = 0; p <= TOTAL; p++) current[p] = 0.0f;
+        lastMark = SDL_GetPerformanceCounter();
+    }
+
+    // Cierra la fase en curso: el tiempo desde la marca anterior se suma a phase
+    // (una fase puede aparecer varias veces en el frame, como la espera)
+    void endPhase(ProfilePhase phase) {
+        if (!enabled) return;
+        Uint64 now = SDL_GetPerformanceCounter();
+        current[phase] += (float)((now - lastMark) * msPerCount);
+        lastMark = now;
+    }
+
+    void endFrame() {
+        if (!enabled) return;
+        current[TOTAL] = 0.0f;
+        for (int p = 0; p < PHASE_COUNT; p++) current[TOTAL] += current[p];
+
+        for (int p = 0; p <= TOTAL; p++) {
+            history[p][windowPos] = current[p];
+        }
+        windowPos = (windowPos + 1) % WINDOW;
+        if (windowFill < WINDOW) windowFill++;
+
+        if (recordFrames) {
+            frames.insert(frames.end(), current, current + TOTAL + 1);
+        }
+    }
+
+    // Percentiles de la ventana deslizante; phase puede ser TOTAL
+    PhaseStats getStats(int phase) const {
+        PhaseStats stats;
+        if (windowFill == 0) return stats;
+        float sorted[WINDOW];
+        std::copy(history[phase], history[phase] + windowFill, sorted);
+        std::sort(sorted, sorted + windowFill);
+        stats.p50 = sorted[percentileIndex(0.50)];
+        stats.p95 = sorted[percentileIndex(0.95)];
+        stats.p99 = sorted[percentileIndex(0.99)];
+        stats.max = sorted[windowFill - 1];
+        return stats;
+    }
+
+    bool writeCSV(const std::string& path) const {
+        std::ofstream out(path.c_str());
+        if (!out) {
+            std::cout << "Error escribiendo " << path << std::endl;
+            return false;
+        }
+        out << std::fixed << std::setprecision(4);
+        out << "frame,events_ms,update_ms,render_ms,present_ms,wait_ms,total_ms\n";
+        size_t frameCount = frames.size() / (TOTAL + 1);
+        for (size_t f = 0; f < frameCount; f++) {
+            out << f;
+            for (int p = 0; p <= TOTAL; p++) {
+                out << ',' << frames[f * (TOTAL + 1) + p];
+            }
+            out << '\n';
+        }
+        std::cout << "Perfil de " << frameCount << " frames guardado en " << path << std::endl;
+        return true;
+    }
+
+private:
+    bool enabled;
+    bool overlayVisible;
+    bool recordFrames;
+    double msPerCount;
+    Uint64 lastMark;
+    float current[TOTAL + 1];
+    float history[TOTAL + 1][WINDOW];
+    int windowFill;
+    int windowPos;
+    std::vector<float> frames; // TOTAL + 1 valores por frame
+
+    void updateEnabled() {
+        enabled = overlayVisible || recordFrames;
+        msPerCount = 1000.0 / SDL_GetPerformanceFrequency();
+        lastMark = SDL_GetPerformanceCounter();
+    }
+
+    int percentileIndex(double fraction) const {
+        int index = (int)(fraction * windowFill);
+        return index < windowFill ? index : windowFill - 1;
+    }
+};
+
+#endif
@@ -0,0 +1,773 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Grabación y reproducción determinista de partidas.
+// Una repetición guarda el estado inicial completo de Match, la frecuencia de ticks y la
+// entrada de las dos paletas en cada tick; como Match::step() es determinista, volver a
+// simular con la misma entrada reproduce la partida bit a bit. Cada tick lleva además
+// una suma de comprobación del estado, que detecta en qué tick se separa la reproducción
+// (desync) si cambia la física o el compilador.
+//
+// Formato (little-endian):
+//   cabecera: "PONGRPL" + versión, ticks/s (u16), modo de colisión (u8), paletas con IA
+//             (u8, bit 0 = jugador 1, bit 1 = jugador 2, bit 2 = física en coma fija),
+//             AIParams de cada paleta, número de ticks (u32, 0 si la grabación no se
+//             cerró) y estado inicial
+//   por tick: byte de entrada (REPLAY_*), eje de cada stick activo (i8) y suma (u16)
+//   keyframe: REPLAY_KEYFRAME, tick (u32) y estado completo tras ese tick; cada
+//             REPLAY_KEYFRAME_SECONDS segundos de partida
+//   índice:   tick (u32) y posición en el archivo (u64) de cada keyframe
+//   pie:      posición del índice (u64), keyframes (u32), intervalo (u32), ticks (u32),
+//             marcador final (u32 x 2) y "RPLINDEX"
+//
+// El índice y el pie se escriben al cerrar la grabación; sin ellos (grabación cortada o
+// versión 1) el archivo se sigue pudiendo reproducir desde el principio.
+// El estado se guarda con los bits del tipo de la física: float IEEE o el entero de Fixed16.
+// Una repetición en coma fija se reproduce igual en cualquier máquina; la de float, solo
+// con la misma compilación.
+// El juego escribe en bloques preasignados que un hilo vuelca al disco: grabar un tick no
+// reserva memoria ni hace E/S en el hilo del juego.
+// Para leer, el archivo se proyecta en memoria (mmap): saltar a un tick restaura el
+// keyframe anterior y simula solo lo que falta, y consultar el resumen de miles de
+// archivos solo toca la cabecera y el pie de cada uno.
+
+#include "pong_core.h"
+#include "mapped_file.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char REPLAY_MAGIC[7] = {'P', 'O', 'N', 'G', 'R', 'P', 'L'};
+const uint8_t REPLAY_VERSION = 3;  // 2: keyframes e índice; 3: física en coma fija
+const uint8_t REPLAY_FIXED_POINT = 4;  // Bit del byte de paletas con IA
+const char REPLAY_INDEX_MAGIC[8] = {'R', 'P', 'L', 'I', 'N', 'D', 'E', 'X'};
+const size_t REPLAY_AI_PARAMS_SIZE = 17;
+const size_t MATCH_STATE_SIZE = 2 * 8 * 4 + 4 * 4 + 4 * 4;
+const size_t REPLAY_TICK_COUNT_OFFSET = 8 + 2 + 1 + 1 + 2 * REPLAY_AI_PARAMS_SIZE;
+const size_t REPLAY_HEADER_SIZE = REPLAY_TICK_COUNT_OFFSET + 4 + MATCH_STATE_SIZE;
+const size_t REPLAY_MAX_TICK_SIZE = 1 + 2 + 2;
+const size_t REPLAY_KEYFRAME_SIZE = 1 + 4 + MATCH_STATE_SIZE;
+const size_t REPLAY_INDEX_ENTRY_SIZE = 4 + 8;
+const size_t REPLAY_FOOTER_SIZE = 8 + 4 * 5 + sizeof(REPLAY_INDEX_MAGIC);
+const int REPLAY_KEYFRAME_SECONDS = 5;  // Saltar a un tick simula como mucho este tiempo
+
+// Bits del byte de entrada de cada tick
+enum ReplayInputBits {
+    REPLAY_P1_UP = 1,
+    REPLAY_P1_DOWN = 2,
+    REPLAY_P2_UP = 4,
+    REPLAY_P2_DOWN = 8,
+    REPLAY_P1_AXIS = 16,  // Sigue un byte con el eje del jugador 1
+    REPLAY_P2_AXIS = 32,  // Sigue un byte con el eje del jugador 2
+    REPLAY_KEYFRAME = 128 // No es un tick: empieza un keyframe
+};
+
+// Lectura y escritura de enteros y floats little-endian sobre un puntero que avanza
+inline void putU16(uint8_t*& out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out += 2;
+}
+
+inline void putU32(uint8_t*& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (8 * i));
+    out += 4;
+}
+
+inline void putF32(uint8_t*& out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU32(out, bits);
+}
+
+inline void putU64(uint8_t*& out, uint64_t value) {
+    putU32(out, (uint32_t)value);
+    putU32(out, (uint32_t)(value >> 32));
+}
+
+inline uint16_t getU16(const uint8_t*& in) {
+    uint16_t value = (uint16_t)(in[0] | (in[1] << 8));
+    in += 2;
+    return value;
+}
+
+inline uint32_t getU32(const uint8_t*& in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) value |= (uint32_t)in[i] << (8 * i);
+    in += 4;
+    return value;
+}
+
+inline uint64_t getU64(const uint8_t*& in) {
+    uint64_t low = getU32(in);
+    return low | ((uint64_t)getU32(in) << 32);
+}
+
+inline float getF32(const uint8_t*& in) {
+    uint32_t bits = getU32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Un valor de la física con sus bits: float IEEE o el entero de Fixed16
+inline void putReal(uint8_t*& out, float value) {
+    putF32(out, value);
+}
+
+inline void putReal(uint8_t*& out, Fixed16 value) {
+    putU32(out, (uint32_t)value.raw);
+}
+
+inline void getReal(const uint8_t*& in, float& value) {
+    value = getF32(in);
+}
+
+inline void getReal(const uint8_t*& in, Fixed16& value) {
+    value = Fixed16::fromRaw((int32_t)getU32(in));
+}
+
+// Estado dinámico de una paleta: posición y memoria de la IA (no su configuración)
+template <typename Real>
+inline void putPaddleState(uint8_t*& out, const BasicPaddle<Real>& paddle) {
+    putReal(out, paddle.x);
+    putReal(out, paddle.y);
+    putReal(out, paddle.cachedVelocityX);
+    putReal(out, paddle.cachedVelocityY);
+    putReal(out, paddle.targetY);
+    putReal(out, paddle.pendingTargetY);
+    putReal(out, paddle.reactionTimer);
+    putU32(out, paddle.aiRandom.state);
+}
+
+template <typename Real>
+inline void getPaddleState(const uint8_t*& in, BasicPaddle<Real>& paddle) {
+    getReal(in, paddle.x);
+    getReal(in, paddle.y);
+    getReal(in, paddle.cachedVelocityX);
+    getReal(in, paddle.cachedVelocityY);
+    getReal(in, paddle.targetY);
+    getReal(in, paddle.pendingTargetY);
+    getReal(in, paddle.reactionTimer);
+    paddle.aiRandom.state = getU32(in);
+}
+
+// Escribe MATCH_STATE_SIZE bytes con todo lo que cambia al simular
+template <typename Real>
+inline void writeMatchState(uint8_t* out, const BasicMatch<Real>& match) {
+    putPaddleState(out, match.player1);
+    putPaddleState(out, match.player2);
+    putReal(out, match.ball.x);
+    putReal(out, match.ball.y);
+    putReal(out, match.ball.velocityX);
+    putReal(out, match.ball.velocityY);
+    putU32(out, (uint32_t)match.score1);
+    putU32(out, (uint32_t)match.score2);
+    putU32(out, (uint32_t)match.rallyHits);
+    putU32(out, (uint32_t)match.lastRallyLength);
+}
+
+template <typename Real>
+inline void readMatchState(const uint8_t* in, BasicMatch<Real>& match) {
+    getPaddleState(in, match.player1);
+    getPaddleState(in, match.player2);
+    getReal(in, match.ball.x);
+    getReal(in, match.ball.y);
+    getReal(in, match.ball.velocityX);
+    getReal(in, match.ball.velocityY);
+    match.score1 = (int)getU32(in);
+    match.score2 = (int)getU32(in);
+    match.rallyHits = (int)getU32(in);
+    match.lastRallyLength = (int)getU32(in);
+}
+
+// FNV-1a del estado serializado: cualquier bit distinto cambia la suma
+template <typename Real>
+inline uint32_t matchChecksum(const BasicMatch<Real>& match) {
+    uint8_t state[MATCH_STATE_SIZE];
+    writeMatchState(state, match);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < MATCH_STATE_SIZE; i++) {
+        hash = (hash ^ state[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Suma de 16 bits por tick: un desync persiste, así que se detecta en uno o dos ticks
+template <typename Real>
+inline uint16_t tickChecksum(const BasicMatch<Real>& match) {
+    uint32_t hash = matchChecksum(match);
+    return (uint16_t)(hash ^ (hash >> 16));
+}
+
+inline void putAIParams(uint8_t*& out, const AIParams& params) {
+    *out++ = (uint8_t)params.mode;
+    putF32(out, params.difficulty);
+    putF32(out, params.deadZone);
+    putF32(out, params.reactionDelay);
+    putF32(out, params.aimError);
+}
+
+inline void getAIParams(const uint8_t*& in, AIParams& params) {
+    params.mode = (AIMode)*in++;
+    params.difficulty = getF32(in);
+    params.deadZone = getF32(in);
+    params.reactionDelay = getF32(in);
+    params.aimError = getF32(in);
+}
+
+// Codifica la entrada de un tick; devuelve los bytes escritos (como mucho 3)
+inline size_t encodeTickInput(uint8_t* out, const PaddleInput& input1, const PaddleInput& input2) {
+    uint8_t bits = 0;
+    if (input1.up) bits |= REPLAY_P1_UP;
+    if (input1.down) bits |= REPLAY_P1_DOWN;
+    if (input2.up) bits |= REPLAY_P2_UP;
+    if (input2.down) bits |= REPLAY_P2_DOWN;
+    size_t size = 1;
+    if (input1.axis != 0.0f) {
+        bits |= REPLAY_P1_AXIS;
+        out[size++] = (uint8_t)(int8_t)axisToSteps(input1.axis);
+    }
+    if (input2.axis != 0.0f) {
+        bits |= REPLAY_P2_AXIS;
+        out[size++] = (uint8_t)(int8_t)axisToSteps(input2.axis);
+    }
+    out[0] = bits;
+    return size;
+}
+
+inline void decodeTickInput(const uint8_t*& in, PaddleInput& input1, PaddleInput& input2) {
+    uint8_t bits = *in++;
+    input1 = PaddleInput((bits & REPLAY_P1_UP) != 0, (bits & REPLAY_P1_DOWN) != 0);
+    input2 = PaddleInput((bits & REPLAY_P2_UP) != 0, (bits & REPLAY_P2_DOWN) != 0);
+    if (bits & REPLAY_P1_AXIS) input1.axis = axisFromSteps((int8_t)*in++);
+    if (bits & REPLAY_P2_AXIS) input2.axis = axisFromSteps((int8_t)*in++);
+}
+
+// partida.rpl, partida-2.rpl, partida-3.rpl... para grabar varias partidas por sesión
+inline std::string numberedReplayPath(const std::string& path, int index) {
+    if (index <= 1) return path;
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = path.size();
+    return path.substr(0, dot) + "-" + std::to_string(index) + path.substr(dot);
+}
+
+class ReplayRecorder {
+public:
+    static const size_t CHUNK_SIZE = 16384;  // ~27 s a 120 ticks/s
+    static const int CHUNK_COUNT = 4;
+
+    ReplayRecorder() : recording(false), stopping(false), failed(false), current(0),
+                       writeIndex(0), tickCount(0), keyframeInterval(1), streamOffset(0),
+                       finalScore1(0), finalScore2(0) {
+        for (int i = 0; i < CHUNK_COUNT; i++) {
+            chunkSize[i] = 0;
+            chunkFull[i] = false;
+        }
+    }
+
+    ~ReplayRecorder() {
+        finish();
+    }
+
+    // Abre el archivo y escribe la cabecera; se llama al empezar la partida, no por frame
+    template <typename Real>
+    bool start(const std::string& filePath, const BasicMatch<Real>& match, int tickRate) {
+        finish();
+        file.open(filePath.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cout << "Error abriendo " << filePath << " para grabar" << std::endl;
+            return false;
+        }
+
+        uint8_t header[REPLAY_HEADER_SIZE];
+        uint8_t* out = header;
+        memcpy(out, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+        out += sizeof(REPLAY_MAGIC);
+        *out++ = REPLAY_VERSION;
+        putU16(out, (uint16_t)tickRate);
+        *out++ = (uint8_t)match.collisionMode;
+        *out++ = (uint8_t)((match.player1.isAI ? 1 : 0) | (match.player2.isAI ? 2 : 0) |
+                           (realIsFixed<Real>() ? REPLAY_FIXED_POINT : 0));
+        putAIParams(out, match.player1.ai);
+        putAIParams(out, match.player2.ai);
+        putU32(out, 0); // Número de ticks: se completa en finish()
+        writeMatchState(out, match);
+        file.write((const char*)header, sizeof(header));
+
+        if (storage.empty()) {
+            storage.resize(CHUNK_SIZE * CHUNK_COUNT);
+        }
+        index.clear();
+        index.reserve(1024); // ~85 min de partida sin volver a reservar
+        path = filePath;
+        current = 0;
+        writeIndex = 0;
+        tickCount = 0;
+        keyframeInterval = (uint32_t)(tickRate * REPLAY_KEYFRAME_SECONDS);
+        streamOffset = REPLAY_HEADER_SIZE;
+        finalScore1 = match.score1;
+        finalScore2 = match.score2;
+        failed = false;
+        stopping = false;
+        for (int i = 0; i < CHUNK_COUNT; i++) {
+            chunkSize[i] = 0;
+            chunkFull[i] = false;
+        }
+        recording = true;
+        writer = std::thread(&ReplayRecorder::writerLoop, this);
+        return true;
+    }
+
+    bool isRecording() const {
+        return recording;
+    }
+
+    // Llamar tras cada Match::step() con la entrada que se le pasó
+    template <typename Real>
+    void recordTick(const PaddleInput& input1, const PaddleInput& input2, const BasicMatch<Real>& match) {
+        if (!recording) return;
+        if (CHUNK_SIZE - chunkSize[current] < REPLAY_MAX_TICK_SIZE + REPLAY_KEYFRAME_SIZE) {
+            submitChunk();
+        }
+        uint8_t* out = &storage[current * CHUNK_SIZE + chunkSize[current]];
+        size_t size = encodeTickInput(out, input1, input2);
+        out += size;
+        putU16(out, tickChecksum(match));
+        chunkSize[current] += size + 2;
+        tickCount++;
+        finalScore1 = match.score1;
+        finalScore2 = match.score2;
+
+        if (tickCount % keyframeInterval == 0) {
+            IndexEntry entry = {tickCount, streamOffset + chunkSize[current]};
+            index.push_back(entry);
+            *out++ = REPLAY_KEYFRAME;
+            putU32(out, tickCount);
+            writeMatchState(out, match);
+            chunkSize[current] += REPLAY_KEYFRAME_SIZE;
+        }
+    }
+
+    // Vuelca lo pendiente, espera al hilo de escritura y escribe el índice y la cabecera
+    void finish() {
+        if (!recording) return;
+        if (chunkSize[current] > 0) {
+            submitChunk();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        chunkReady.notify_one();
+        writer.join();
+        recording = false;
+
+        // El hilo ya terminó: el índice y el pie van al final desde este hilo
+        std::vector<uint8_t> tail(index.size() * REPLAY_INDEX_ENTRY_SIZE + REPLAY_FOOTER_SIZE);
+        uint8_t* out = &tail[0];
+        for (size_t i = 0; i < index.size(); i++) {
+            putU32(out, index[i].tick);
+            putU64(out, index[i].offset);
+        }
+        putU64(out, streamOffset);
+        putU32(out, (uint32_t)index.size());
+        putU32(out, keyframeInterval);
+        putU32(out, tickCount);
+        putU32(out, (uint32_t)finalScore1);
+        putU32(out, (uint32_t)finalScore2);
+        memcpy(out, REPLAY_INDEX_MAGIC, sizeof(REPLAY_INDEX_MAGIC));
+        file.write((const char*)&tail[0], tail.size());
+
+        uint8_t count[4];
+        out = count;
+        putU32(out, tickCount);
+        file.seekp(REPLAY_TICK_COUNT_OFFSET);
+        file.write((const char*)count, sizeof(count));
+        file.close();
+        if (failed || !file) {
+            std::cout << "Error escribiendo la repetición " << path << std::endl;
+        } else {
+            std::cout << "Repetición guardada en " << path << " (" << tickCount << " ticks, "
+                      << index.size() << " keyframes)" << std::endl;
+        }
+    }
+
+private:
+    struct IndexEntry {
+        uint32_t tick;
+        uint64_t offset;
+    };
+
+    std::ofstream file;
+    std::string path;
+    std::vector<uint8_t> storage;      // CHUNK_COUNT bloques de CHUNK_SIZE bytes
+    size_t chunkSize[CHUNK_COUNT];
+    bool chunkFull[CHUNK_COUNT];       // Lleno y pendiente de escribir (protegido por mutex)
+    bool recording;
+    bool stopping;
+    bool failed;
+    int current;                       // Bloque que está llenando el juego
+    int writeIndex;                    // Siguiente bloque que escribe el hilo
+    uint32_t tickCount;
+    uint32_t keyframeInterval;         // Ticks entre keyframes
+    uint64_t streamOffset;             // Posición en el archivo del bloque actual
+    std::vector<IndexEntry> index;
+    int finalScore1, finalScore2;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable chunkReady;
+    std::condition_variable chunkFree;
+
+    // Entrega el bloque actual al hilo de escritura y pasa al siguiente
+    void submitChunk() {
+        std::unique_lock<std::mutex> lock(mutex);
+        streamOffset += chunkSize[current];
+        chunkFull[current] = true;
+        chunkReady.notify_one();
+        current = (current + 1) % CHUNK_COUNT;
+        // Solo espera si el disco va más de CHUNK_COUNT - 1 bloques por detrás
+        chunkFree.wait(lock, [this]() { return !chunkFull[current]; });
+        chunkSize[current] = 0;
+    }
+
+    void writerLoop() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            chunkReady.wait(lock, [this]() { return chunkFull[writeIndex] || stopping; });
+            if (!chunkFull[writeIndex]) return; // Parando y sin nada pendiente
+            lock.unlock();
+
+            file.write((const char*)&storage[writeIndex * CHUNK_SIZE], chunkSize[writeIndex]);
+            if (!file) failed = true;
+
+            lock.lock();
+            chunkFull[writeIndex] = false;
+            writeIndex = (writeIndex + 1) % CHUNK_COUNT;
+            chunkFree.notify_one();
+        }
+    }
+};
+
+struct ReplayHeader {
+    int version;
+    int tickRate;
+    CollisionMode collisionMode;
+    bool ai1, ai2;
+    bool fixedPoint;     // Grabada con BasicMatch<Fixed16>
+    AIParams params1, params2;
+    uint32_t tickCount;  // 0 si la grabación no se cerró: se lee hasta el final
+};
+
+// Datos del pie: solo existen si la grabación se cerró bien
+struct ReplayIndexInfo {
+    bool present;
+    size_t offset;            // Inicio del índice (y fin de los ticks)
+    uint32_t keyframes;
+    uint32_t keyframeInterval;
+    int finalScore1, finalScore2;
+};
+
+class ReplayReader {
+public:
+    ReplayReader() : streamEnd(0), cursor(0), ticksRead(0), expectedChecksum(0), desyncTick(-1) {
+        indexInfo.present = false;
+    }
+
+    // Proyecta el archivo y lee la cabecera y el pie; los ticks no se tocan hasta usarlos
+    bool open(const std::string& path) {
+        if (!file.open(path)) {
+            std::cout << "Error abriendo la repetición " << path << std::endl;
+            return false;
+        }
+        const uint8_t* data = file.data();
+        size_t size = file.size();
+        if (size < REPLAY_HEADER_SIZE || memcmp(data, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 ||
+            data[sizeof(REPLAY_MAGIC)] == 0 || data[sizeof(REPLAY_MAGIC)] > REPLAY_VERSION) {
+            std::cout << "Archivo de repetición no válido: " << path << std::endl;
+            return false;
+        }
+
+        const uint8_t* in = data + sizeof(REPLAY_MAGIC);
+        header.version = *in++;
+        header.tickRate = getU16(in);
+        header.collisionMode = (CollisionMode)*in++;
+        uint8_t aiBits = *in++;
+        header.ai1 = (aiBits & 1) != 0;
+        header.ai2 = (aiBits & 2) != 0;
+        header.fixedPoint = header.version >= 3 && (aiBits & REPLAY_FIXED_POINT) != 0;
+        getAIParams(in, header.params1);
+        getAIParams(in, header.params2);
+        header.tickCount = getU32(in);
+        if (header.tickRate < MIN_TICK_RATE || header.tickRate > MAX_TICK_RATE) {
+            std::cout << "Frecuencia de ticks no válida en " << path << ": " << header.tickRate << std::endl;
+            return false;
+        }
+
+        streamEnd = size;
+        indexInfo.present = false;
+        if (size >= REPLAY_HEADER_SIZE + REPLAY_FOOTER_SIZE &&
+            memcmp(data + size - sizeof(REPLAY_INDEX_MAGIC), REPLAY_INDEX_MAGIC, sizeof(REPLAY_INDEX_MAGIC)) == 0) {
+            in = data + size - REPLAY_FOOTER_SIZE;
+            uint64_t offset = getU64(in);
+            uint32_t keyframes = getU32(in);
+            uint32_t interval = getU32(in);
+            uint32_t ticks = getU32(in);
+            int score1 = (int)getU32(in);
+            int score2 = (int)getU32(in);
+            // El índice debe ocupar exactamente el hueco entre los ticks y el pie
+            if (offset >= REPLAY_HEADER_SIZE && offset <= size - REPLAY_FOOTER_SIZE &&
+                (size - REPLAY_FOOTER_SIZE - offset) == (uint64_t)keyframes * REPLAY_INDEX_ENTRY_SIZE) {
+                indexInfo.present = true;
+                indexInfo.offset = (size_t)offset;
+                indexInfo.keyframes = keyframes;
+                indexInfo.keyframeInterval = interval;
+                indexInfo.finalScore1 = score1;
+                indexInfo.finalScore2 = score2;
+                streamEnd = (size_t)offset;
+                if (header.tickCount == 0) header.tickCount = ticks;
+            }
+        }
+        cursor = REPLAY_HEADER_SIZE;
+        ticksRead = 0;
+        desyncTick = -1;
+        return true;
+    }
+
+    const ReplayHeader& getHeader() const {
+        return header;
+    }
+
+    const ReplayIndexInfo& getIndexInfo() const {
+        return indexInfo;
+    }
+
+    size_t getFileSize() const {
+        return file.size();
+    }
+
+    // Si la repetición se grabó con el tipo de física Real; si no, no se puede reproducir con él
+    template <typename Real>
+    bool usesPhysics() const {
+        return header.fixedPoint == realIsFixed<Real>();
+    }
+
+    // Configura las paletas y pone el estado inicial grabado
+    template <typename Real>
+    void restoreInitialState(BasicMatch<Real>& match) {
+        applyConfig(match);
+        readMatchState(file.data() + REPLAY_TICK_COUNT_OFFSET + 4, match);
+        cursor = REPLAY_HEADER_SIZE;
+        ticksRead = 0;
+    }
+
+    // Entrada del siguiente tick; false al terminar la grabación
+    bool nextInputs(PaddleInput& input1, PaddleInput& input2) {
+        if (header.tickCount != 0 && ticksRead >= (long)header.tickCount) return false;
+        const uint8_t* data = file.data();
+        while (cursor < streamEnd && (data[cursor] & REPLAY_KEYFRAME)) {
+            cursor += REPLAY_KEYFRAME_SIZE; // Los keyframes solo sirven para saltar
+        }
+        if (cursor >= streamEnd || streamEnd - cursor < 3) return false;
+        const uint8_t* in = data + cursor;
+        size_t size = 1 + ((*in & REPLAY_P1_AXIS) ? 1 : 0) + ((*in & REPLAY_P2_AXIS) ? 1 : 0) + 2;
+        if (streamEnd - cursor < size) return false; // Tick incompleto al final
+        decodeTickInput(in, input1, input2);
+        expectedChecksum = getU16(in);
+        cursor += size;
+        ticksRead++;
+        return true;
+    }
+
+    // Compara el estado tras simular el tick leído con la suma grabada
+    template <typename Real>
+    bool verify(const BasicMatch<Real>& match) {
+        if (tickChecksum(match) == expectedChecksum) return true;
+        if (desyncTick < 0) desyncTick = ticksRead - 1;
+        return false;
+    }
+
+    // Deja match en el estado tras `tick` ticks: restaura el keyframe anterior más cercano
+    // (o sigue desde la posición actual si está más cerca) y simula solo lo que falta.
+    // match debe ser el estado tras getTicksRead() ticks. Devuelve false si la
+    // grabación termina antes.
+    template <typename Real>
+    bool seek(BasicMatch<Real>& match, long tick) {
+        if (tick < 0) tick = 0;
+        long keyframeTick = 0;
+        size_t keyframeOffset = 0;
+        if (indexInfo.present) {
+            findKeyframe(tick, keyframeTick, keyframeOffset);
+        }
+
+        if (ticksRead > tick || ticksRead < keyframeTick) {
+            if (keyframeOffset != 0) {
+                applyConfig(match);
+                readMatchState(file.data() + keyframeOffset + 1 + 4, match);
+                cursor = keyframeOffset + REPLAY_KEYFRAME_SIZE;
+                ticksRead = keyframeTick;
+            } else {
+                restoreInitialState(match);
+            }
+        }
+
+        Real deltaTime = realFromRatio<Real>(1, header.tickRate);
+        PaddleInput input1, input2;
+        while (ticksRead < tick && nextInputs(input1, input2)) {
+            match.step(deltaTime, input1, input2);
+            verify(match);
+        }
+        return ticksRead == tick;
+    }
+
+    long getTicksRead() const {
+        return ticksRead;
+    }
+
+    long getDesyncTick() const {
+        return desyncTick;
+    }
+
+private:
+    MappedFile file;
+    ReplayHeader header;
+    ReplayIndexInfo indexInfo;
+    size_t streamEnd;     // Fin de los ticks (inicio del índice si lo hay)
+    size_t cursor;
+    long ticksRead;
+    uint16_t expectedChecksum;
+    long desyncTick;      // Primer tick cuya suma no coincide (-1 si ninguno)
+
+    template <typename Real>
+    void applyConfig(BasicMatch<Real>& match) const {
+        match.collisionMode = header.collisionMode;
+        match.player1.isAI = header.ai1;
+        match.player2.isAI = header.ai2;
+        match.player1.ai = header.params1;
+        match.player2.ai = header.params2;
+    }
+
+    // Búsqueda binaria del último keyframe con tick <= target, directamente en el índice
+    // proyectado; offset = 0 si no hay ninguno
+    void findKeyframe(long target, long& keyframeTick, size_t& offset) const {
+        const uint8_t* entries = file.data() + indexInfo.offset;
+        size_t low = 0, high = indexInfo.keyframes;
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            const uint8_t* in = entries + mid * REPLAY_INDEX_ENTRY_SIZE;
+            if ((long)getU32(in) <= target) low = mid + 1; else high = mid;
+        }
+        keyframeTick = 0;
+        offset = 0;
+        if (low == 0) return;
+
+        const uint8_t* in = entries + (low - 1) * REPLAY_INDEX_ENTRY_SIZE;
+        long entryTick = (long)getU32(in);
+        uint64_t entryOffset = getU64(in);
+        // Un índice corrupto no debe llevar fuera de los ticks
+        if (entryOffset < REPLAY_HEADER_SIZE || entryOffset + REPLAY_KEYFRAME_SIZE > streamEnd) return;
+        const uint8_t* record = file.data() + entryOffset;
+        if (record[0] != REPLAY_KEYFRAME) return;
+        const uint8_t* recordTick = record + 1;
+        if ((long)getU32(recordTick) != entryTick) return;
+        keyframeTick = entryTick;
+        offset = (size_t)entryOffset;
+    }
+};
+
+// Reproduce una repetición sin ventana tan rápido como se pueda y comprueba cada tick.
+// Con startTick > 0 salta primero a ese tick (keyframe más cercano + simulación).
+// Usa la física con la que se grabó, sea cual sea la de esta compilación.
+template <typename Real>
+inline bool runReplayHeadlessWith(ReplayReader& reader, const std::string& path, long startTick) {
+    BasicMatch<Real> match;
+    reader.restoreInitialState(match);
+    Real deltaTime = realFromRatio<Real>(1, reader.getHeader().tickRate);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (startTick > 0) {
+        bool reached = reader.seek(match, startTick);
+        double seekSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Salto al tick " << reader.getTicksRead() << " en " << seekSeconds * 1000.0 << " ms"
+                  << " (marcador " << match.score1 << " - " << match.score2 << ")" << '\n';
+        if (!reached) {
+            std::cout << "Advertencia: la repetición termina antes del tick " << startTick << '\n';
+        }
+        start = std::chrono::steady_clock::now();
+    }
+    long firstTick = reader.getTicksRead();
+
+    PaddleInput input1, input2;
+    while (reader.nextInputs(input1, input2)) {
+        match.step(deltaTime, input1, input2);
+        reader.verify(match);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long ticks = reader.getTicksRead();
+    double simulated = (double)(ticks - firstTick) / reader.getHeader().tickRate;
+    std::cout << "=== REPETICIÓN " << path << " ===" << '\n';
+    std::cout << "Ticks: " << ticks << " (" << reader.getHeader().tickRate << " ticks/s, "
+              << (reader.getHeader().fixedPoint ? "coma fija, " : "")
+              << (double)ticks / reader.getHeader().tickRate << " s de partida)" << '\n';
+    std::cout << "Resultado: " << match.score1 << " - " << match.score2 << '\n';
+    std::cout << "Tiempo real: " << seconds << " s";
+    if (seconds > 0.0) std::cout << " (" << (long long)(simulated / seconds) << "x tiempo real)";
+    std::cout << '\n';
+    if (reader.getHeader().tickCount != 0 && ticks != (long)reader.getHeader().tickCount) {
+        std::cout << "Advertencia: la cabecera indica " << reader.getHeader().tickCount << " ticks" << '\n';
+    }
+    if (reader.getDesyncTick() >= 0) {
+        std::cout << "DESYNC en el tick " << reader.getDesyncTick() << std::endl;
+        return false;
+    }
+    std::cout << "Sin desync: todos los ticks coinciden" << std::endl;
+    return true;
+}
+
+inline bool runReplayHeadless(const std::string& path, long startTick = 0) {
+    ReplayReader reader;
+    if (!reader.open(path)) return false;
+    if (reader.getHeader().fixedPoint) {
+        return runReplayHeadlessWith<Fixed16>(reader, path, startTick);
+    }
+    return runReplayHeadlessWith<float>(reader, path, startTick);
+}
+
+// Resumen de muchas repeticiones leyendo solo la cabecera y el pie de cada una
+inline bool scanReplays(const std::vector<std::string>& paths) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    long long totalTicks = 0;
+    int valid = 0, indexed = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        ReplayReader reader;
+        if (!reader.open(paths[i])) continue;
+        valid++;
+        const ReplayHeader& header = reader.getHeader();
+        const ReplayIndexInfo& info = reader.getIndexInfo();
+        totalTicks += header.tickCount;
+        printf("%-32s v%d %4d ticks/s %9u ticks %8.1f s", paths[i].c_str(), header.version,
+               header.tickRate, header.tickCount, (double)header.tickCount / header.tickRate);
+        if (info.present) {
+            indexed++;
+            printf("  %3d - %-3d %5u keyframes\n", info.finalScore1, info.finalScore2, info.keyframes);
+        } else {
+            printf("  sin índice\n");
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "=== " << valid << " de " << paths.size() << " repeticiones (" << indexed << " con índice), "
+              << totalTicks << " ticks en total; leídas en " << seconds * 1000.0 << " ms ===" << std::endl;
+    return valid == (int)paths.size();
+}
+
+#endif
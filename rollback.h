@@ -0,0 +1,582 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+// Juego en red para dos con rollback (al estilo GGPO) sobre UDP.
+// Cada lado simula la partida completa. La entrada local se aplica con unos ticks de
+// retraso (inputDelay) y se envía al rival; la del rival, que llega tarde, se predice
+// repitiendo la última conocida. Antes de cada tick se guarda una copia de Match (el
+// estado completo de la simulación cabe en unos cientos de bytes), y cuando llega una
+// entrada del rival distinta de la predicha se restaura la copia de ese tick y se vuelve
+// a simular hasta el presente. Como Match::step() es determinista, los dos lados acaban
+// en el mismo estado; una suma de comprobación de los ticks ya confirmados viaja en cada
+// paquete para detectarlo si no es así.
+//
+// Cada paquete repite toda la entrada local que el rival aún no ha confirmado, así que
+// un paquete perdido se recupera con el siguiente. Si el rival se retrasa demasiado
+// (más de maxRollback ticks sin su entrada) el juego espera en vez de predecir más, y si
+// un lado va por delante del otro cede un tick de vez en cuando para igualarse.
+
+#include "pong_core.h"
+#include "net.h"
+#include "replay.h"
+#include "headless.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const uint16_t NET_MAGIC = 0x504E;
+const uint8_t NET_VERSION = 1;
+const int ROLLBACK_HISTORY = 256;          // Ticks de historia (entradas y copias de estado)
+const int MAX_ROLLBACK_TICKS = 64;
+const int MAX_NET_INPUT_DELAY = 16;
+const int NET_MAX_INPUTS_PER_PACKET = 64;
+const uint32_t NET_TIMEOUT_MS = 5000;
+const uint32_t NET_HELLO_INTERVAL_MS = 100;
+const uint32_t NO_SYNC_TICK = 0xFFFFFFFFu;
+
+enum NetPacketType {
+    NET_HELLO = 1,    // Invitado → anfitrión: quiero jugar
+    NET_WELCOME = 2,  // Anfitrión → invitado: ticks/s, retraso de entrada y rollback máximo
+    NET_INPUT = 3,    // Entrada sin confirmar, confirmación y sincronía
+    NET_BYE = 4       // Fin de la partida
+};
+
+struct NetConfig {
+    bool host;
+    std::string address;   // Solo al unirse
+    uint16_t port;
+    int inputDelay;        // Ticks de retraso de la entrada local (lo fija el anfitrión)
+    int maxRollback;       // Ticks que se puede predecir sin entrada del rival
+    NetConditions conditions;
+
+    NetConfig() : host(true), port(7777), inputDelay(2), maxRollback(16) {}
+};
+
+// "host:puerto"
+inline bool parseNetAddress(const char* text, std::string& host, uint16_t& port) {
+    std::string value(text);
+    size_t colon = value.find_last_of(':');
+    if (colon == std::string::npos || colon == 0) return false;
+    int number = atoi(value.c_str() + colon + 1);
+    if (number <= 0 || number > 65535) return false;
+    host = value.substr(0, colon);
+    port = (uint16_t)number;
+    return true;
+}
+
+// Entrada de una paleta en 16 bits: arriba/abajo en el byte bajo y el eje (i8) en el alto
+inline uint16_t encodeNetInput(const PaddleInput& input) {
+    uint16_t bits = (input.up ? 1 : 0) | (input.down ? 2 : 0);
+    return (uint16_t)(bits | ((uint16_t)(uint8_t)(int8_t)axisToSteps(input.axis) << 8));
+}
+
+inline PaddleInput decodeNetInput(uint16_t value) {
+    PaddleInput input((value & 1) != 0, (value & 2) != 0);
+    input.axis = axisFromSteps((int8_t)(uint8_t)(value >> 8));
+    return input;
+}
+
+class RollbackSession {
+public:
+    RollbackSession() : state(NET_IDLE), started(false), localPlayer(0), tickRate(DEFAULT_TICK_RATE),
+                        inputDelay(2), maxRollback(16), snapshots(ROLLBACK_HISTORY) {
+        resetTimeline();
+    }
+
+    ~RollbackSession() {
+        stop();
+    }
+
+    // Anfitrión: espera en el puerto. Invitado: empieza a enviar HELLO a la dirección.
+    bool start(const NetConfig& config, int hostTickRate) {
+        stop();
+        isHost = config.host;
+        localPlayer = isHost ? 0 : 1;
+        tickRate = hostTickRate;
+        inputDelay = std::max(0, std::min(config.inputDelay, MAX_NET_INPUT_DELAY));
+        maxRollback = std::max(1, std::min(config.maxRollback, MAX_ROLLBACK_TICKS));
+        if (!socket.open(isHost ? config.port : 0)) return false;
+        if (!isHost && !socket.setPeer(config.address, config.port)) return false;
+        socket.setConditions(config.conditions);
+        state = NET_CONNECTING;
+        started = true;
+        lastHelloMs = 0;
+        lastReceiveMs = netTimeMs();
+        return true;
+    }
+
+    bool isConnected() const {
+        return state == NET_CONNECTED;
+    }
+
+    bool isFinished() const {
+        return state == NET_DISCONNECTED;
+    }
+
+    int getLocalPlayer() const {
+        return localPlayer;
+    }
+
+    // Al unirse, la del anfitrión
+    int getTickRate() const {
+        return tickRate;
+    }
+
+    long getCurrentTick() const {
+        return currentTick;
+    }
+
+    float getRttMs() const {
+        return rttMs;
+    }
+
+    int getLastDepth() const {
+        return lastDepth;
+    }
+
+    float getLastCostUs() const {
+        return lastCostUs;
+    }
+
+    // Recibe y procesa paquetes, reintenta el saludo y detecta la desconexión
+    void poll() {
+        if (state == NET_IDLE || state == NET_DISCONNECTED) return;
+        socket.poll();
+        uint32_t now = netTimeMs();
+        if (state == NET_CONNECTING && !isHost && now - lastHelloMs >= NET_HELLO_INTERVAL_MS) {
+            uint8_t packet[4];
+            uint8_t* out = packet;
+            putU16(out, NET_MAGIC);
+            *out++ = NET_HELLO;
+            *out++ = NET_VERSION;
+            socket.send(packet, sizeof(packet));
+            lastHelloMs = now;
+        }
+
+        uint8_t buffer[NET_MAX_PACKET];
+        size_t size;
+        while ((size = socket.receive(buffer, sizeof(buffer))) > 0) {
+            handlePacket(buffer, size, now);
+        }
+        if (state == NET_CONNECTED && now - lastReceiveMs > NET_TIMEOUT_MS) {
+            std::cout << "Conexión perdida con el rival" << std::endl;
+            state = NET_DISCONNECTED;
+        }
+    }
+
+    // Avanza un tick con la entrada local. Devuelve false si hay que esperar al rival
+    // (demasiados ticks sin su entrada, o vamos por delante).
+    bool advance(Match& match, const PaddleInput& localInput) {
+        if (state != NET_CONNECTED) return false;
+        resolve(match);
+
+        if (currentTick - lastRemoteTick > maxRollback) {
+            stalls++;
+            sendInputs();
+            return false;
+        }
+        // Sincronía: la ventaja de cada lado se mide con el tick que informa el otro, que
+        // llega con la misma latencia en los dos sentidos; la mitad de la diferencia es
+        // cuánto vamos por delante de verdad. Se promedia para no reaccionar al jitter.
+        ticksSinceWait++;
+        localAdvantage += ((float)(currentTick - remoteTick) - localAdvantage) * 0.05f;
+        averageRemoteAdvantage += ((float)remoteAdvantage - averageRemoteAdvantage) * 0.05f;
+        if (localAdvantage - averageRemoteAdvantage >= 2.0f && ticksSinceWait >= 4) {
+            ticksSinceWait = 0;
+            timeSyncWaits++;
+            sendInputs();
+            return false;
+        }
+
+        long inputTick = currentTick + inputDelay;
+        inputs[slot(inputTick)][localPlayer] = encodeNetInput(localInput);
+        sendTimeMs[slot(inputTick)] = netTimeMs();
+        lastLocalTick = inputTick;
+
+        simulateTick(match, currentTick);
+        currentTick++;
+        sendInputs();
+        return true;
+    }
+
+    // Sin avanzar: aplica los rollbacks pendientes y mantiene viva la conexión. Devuelve
+    // true cuando se tiene toda la entrada del rival hasta endTick y él tiene la nuestra.
+    bool settle(Match& match, long endTick, bool& remoteComplete) {
+        if (state != NET_CONNECTED) return false;
+        resolve(match);
+        sendInputs();
+        remoteComplete = lastRemoteTick >= endTick - 1;
+        return remoteComplete && remoteAck >= endTick - 1;
+    }
+
+    // Estadísticas por frame de render (o por paso en modo headless)
+    void beginFrame() {
+        frameDepth = 0;
+        frameResimTicks = 0;
+        frameCostUs = 0.0f;
+    }
+
+    void endFrame() {
+        if (state != NET_CONNECTED) return;
+        frames++;
+        lastDepth = frameDepth;
+        lastCostUs = frameCostUs;
+        if (frameResimTicks == 0) return;
+        rollbackFrames++;
+        totalDepth += frameDepth;
+        maxDepth = std::max(maxDepth, frameDepth);
+        totalResimTicks += frameResimTicks;
+        if (rollbackCosts.size() < (size_t)(1 << 20)) {
+            rollbackCosts.push_back(frameCostUs);
+        }
+    }
+
+    // Avisa al rival y cierra el socket
+    void stop() {
+        if (state == NET_CONNECTED || state == NET_CONNECTING) {
+            uint8_t packet[3];
+            uint8_t* out = packet;
+            putU16(out, NET_MAGIC);
+            *out++ = NET_BYE;
+            socket.sendImmediate(packet, sizeof(packet)); // Con latencia simulada se perdería al cerrar
+        }
+        if (state != NET_IDLE) {
+            state = NET_DISCONNECTED;
+        }
+        socket.close();
+    }
+
+    void printReport() const {
+        if (!started) return;
+        std::cout << "=== Red (rollback, jugador " << localPlayer + 1 << ") ===" << std::endl;
+        std::cout << "Ticks: " << currentTick << "  RTT medio: " << rttMs << " ms  Retraso de entrada: "
+                  << inputDelay << " ticks  Esperas: " << stalls << " por el rival, "
+                  << timeSyncWaits << " de sincronía" << std::endl;
+        if (frames == 0) return;
+        std::cout << "Frames con rollback: " << rollbackFrames << " de " << frames << " ("
+                  << 100.0 * rollbackFrames / frames << "%)";
+        if (rollbackFrames > 0) {
+            std::cout << "  profundidad media " << (double)totalDepth / rollbackFrames << " ticks, máx "
+                      << maxDepth << "  ticks resimulados " << totalResimTicks;
+        }
+        std::cout << std::endl;
+        if (!rollbackCosts.empty()) {
+            std::vector<float> sorted(rollbackCosts);
+            std::sort(sorted.begin(), sorted.end());
+            std::cout << "Coste de re-simulación por frame (us): p50 " << sorted[sorted.size() / 2]
+                      << "  p99 " << sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)]
+                      << "  máx " << sorted.back() << std::endl;
+        }
+        if (desyncTick >= 0) {
+            std::cout << "DESYNC: el estado del tick " << desyncTick << " no coincide con el del rival" << std::endl;
+        } else {
+            std::cout << "Sincronía: " << syncChecks << " comprobaciones sin diferencias" << std::endl;
+        }
+    }
+
+private:
+    enum NetState { NET_IDLE, NET_CONNECTING, NET_CONNECTED, NET_DISCONNECTED };
+
+    UdpSocket socket;
+    NetState state;
+    bool started;
+    bool isHost;
+    int localPlayer;
+    int tickRate;
+    int inputDelay;
+    int maxRollback;
+    uint32_t lastHelloMs, lastReceiveMs;
+
+    // Línea temporal: índices con slot(tick)
+    uint16_t inputs[ROLLBACK_HISTORY][2];
+    uint16_t remoteUsed[ROLLBACK_HISTORY];   // Entrada del rival con la que se simuló cada tick
+    uint32_t sendTimeMs[ROLLBACK_HISTORY];   // Cuándo se envió por primera vez la entrada local
+    std::vector<Match> snapshots;            // Estado antes de simular cada tick
+    long currentTick;        // Siguiente tick a simular
+    long lastLocalTick;      // Último tick con entrada local
+    long lastRemoteTick;     // Último tick con entrada del rival (sin huecos)
+    long remoteAck;          // Último tick de nuestra entrada que el rival tiene
+    long rollbackTo;         // Primer tick a re-simular (-1 si ninguno)
+    long remoteTick;         // Tick del rival según su último paquete
+    int remoteAdvantage;
+    float localAdvantage, averageRemoteAdvantage;
+    int ticksSinceWait;
+    long pendingSyncTick;    // Suma del rival pendiente de comparar
+    uint32_t pendingSyncChecksum;
+    long desyncTick;
+    float rttMs;
+
+    // Estadísticas
+    int frameDepth, frameResimTicks;
+    float frameCostUs;
+    int lastDepth;
+    float lastCostUs;
+    long frames, rollbackFrames, totalDepth, totalResimTicks, stalls, timeSyncWaits, syncChecks;
+    int maxDepth;
+    std::vector<float> rollbackCosts;
+
+    static int slot(long tick) {
+        return (int)(tick & (ROLLBACK_HISTORY - 1));
+    }
+
+    void resetTimeline() {
+        memset(inputs, 0, sizeof(inputs));
+        memset(remoteUsed, 0, sizeof(remoteUsed));
+        memset(sendTimeMs, 0, sizeof(sendTimeMs));
+        currentTick = 0;
+        // Los primeros inputDelay ticks no tienen entrada en ningún lado: quietos
+        lastLocalTick = lastRemoteTick = remoteAck = inputDelay - 1;
+        rollbackTo = -1;
+        remoteTick = 0;
+        remoteAdvantage = 0;
+        localAdvantage = averageRemoteAdvantage = 0.0f;
+        ticksSinceWait = 0;
+        pendingSyncTick = -1;
+        pendingSyncChecksum = 0;
+        desyncTick = -1;
+        rttMs = 0.0f;
+        frameDepth = frameResimTicks = 0;
+        frameCostUs = 0.0f;
+        lastDepth = 0;
+        lastCostUs = 0.0f;
+        frames = rollbackFrames = totalDepth = totalResimTicks = stalls = timeSyncWaits = syncChecks = 0;
+        maxDepth = 0;
+        rollbackCosts.clear();
+    }
+
+    uint16_t remoteInputFor(long tick) const {
+        int remote = 1 - localPlayer;
+        if (tick <= lastRemoteTick) return inputs[slot(tick)][remote];
+        return lastRemoteTick >= 0 ? inputs[slot(lastRemoteTick)][remote] : 0; // Predicción
+    }
+
+    void simulateTick(Match& match, long tick) {
+        snapshots[slot(tick)] = match;
+        uint16_t remote = remoteInputFor(tick);
+        remoteUsed[slot(tick)] = remote;
+        PaddleInput playerInputs[2];
+        playerInputs[localPlayer] = decodeNetInput(inputs[slot(tick)][localPlayer]);
+        playerInputs[1 - localPlayer] = decodeNetInput(remote);
+        match.step(physicsDelta(tickRate), playerInputs[0], playerInputs[1]);
+    }
+
+    // Re-simula desde el primer tick mal predicho hasta el presente
+    void resolve(Match& match) {
+        if (rollbackTo >= 0 && rollbackTo < currentTick) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            match = snapshots[slot(rollbackTo)];
+            for (long t = rollbackTo; t < currentTick; t++) {
+                simulateTick(match, t);
+            }
+            int depth = (int)(currentTick - rollbackTo);
+            frameDepth = std::max(frameDepth, depth);
+            frameResimTicks += depth;
+            frameCostUs += std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+        rollbackTo = -1;
+        checkPendingSync();
+    }
+
+    // Tick más reciente cuyo estado ya es definitivo (toda la entrada anterior confirmada)
+    long confirmedSnapshotTick() const {
+        return std::min(lastRemoteTick + 1, currentTick - 1);
+    }
+
+    void checkPendingSync() {
+        if (pendingSyncTick < 0) return;
+        long tick = pendingSyncTick;
+        if (tick > confirmedSnapshotTick()) return; // Aún no lo tenemos confirmado
+        pendingSyncTick = -1;
+        if (tick <= currentTick - ROLLBACK_HISTORY + maxRollback) return; // Demasiado antiguo
+        syncChecks++;
+        if (matchChecksum(snapshots[slot(tick)]) != pendingSyncChecksum && desyncTick < 0) {
+            desyncTick = tick;
+            std::cout << "DESYNC en el tick " << tick << std::endl;
+        }
+    }
+
+    void sendInputs() {
+        uint8_t packet[NET_MAX_PACKET];
+        uint8_t* out = packet;
+        putU16(out, NET_MAGIC);
+        *out++ = NET_INPUT;
+        putU32(out, (uint32_t)currentTick);
+        putU16(out, (uint16_t)(int16_t)std::max(-32768L, std::min(32767L, currentTick - remoteTick)));
+        putU32(out, (uint32_t)lastRemoteTick);
+        long syncTick = confirmedSnapshotTick();
+        putU32(out, syncTick >= 0 ? (uint32_t)syncTick : NO_SYNC_TICK);
+        putU32(out, syncTick >= 0 ? matchChecksum(snapshots[slot(syncTick)]) : 0);
+        long first = remoteAck + 1;
+        int count = (int)std::max(0L, std::min((long)NET_MAX_INPUTS_PER_PACKET, lastLocalTick - first + 1));
+        putU32(out, (uint32_t)first);
+        *out++ = (uint8_t)count;
+        for (int i = 0; i < count; i++) {
+            putU16(out, inputs[slot(first + i)][localPlayer]);
+        }
+        socket.send(packet, out - packet);
+    }
+
+    void handlePacket(const uint8_t* data, size_t size, uint32_t now) {
+        if (size < 3) return;
+        const uint8_t* in = data;
+        if (getU16(in) != NET_MAGIC) return;
+        uint8_t type = *in++;
+        lastReceiveMs = now;
+
+        if (type == NET_HELLO && isHost && size >= 4) {
+            if (*in != NET_VERSION) {
+                std::cout << "El rival usa otra versión del protocolo" << std::endl;
+                return;
+            }
+            uint8_t packet[7];
+            uint8_t* out = packet;
+            putU16(out, NET_MAGIC);
+            *out++ = NET_WELCOME;
+            putU16(out, (uint16_t)tickRate);
+            *out++ = (uint8_t)inputDelay;
+            *out++ = (uint8_t)maxRollback;
+            socket.send(packet, sizeof(packet));
+            if (state == NET_CONNECTING) {
+                resetTimeline();
+                state = NET_CONNECTED;
+                std::cout << "Rival conectado" << std::endl;
+            }
+        } else if (type == NET_WELCOME && !isHost && size >= 7) {
+            if (state != NET_CONNECTING) return;
+            tickRate = getU16(in);
+            inputDelay = std::min((int)*in++, MAX_NET_INPUT_DELAY);
+            maxRollback = std::max(1, std::min((int)*in++, MAX_ROLLBACK_TICKS));
+            if (tickRate < MIN_TICK_RATE || tickRate > MAX_TICK_RATE) tickRate = DEFAULT_TICK_RATE;
+            resetTimeline();
+            state = NET_CONNECTED;
+            std::cout << "Conectado al anfitrión (" << tickRate << " ticks/s, retraso " << inputDelay << ")" << std::endl;
+        } else if (type == NET_INPUT && state == NET_CONNECTED && size >= 3 + 4 + 2 + 4 + 4 + 4 + 4 + 1) {
+            handleInputPacket(in, size - 3, now);
+        } else if (type == NET_BYE && state == NET_CONNECTED) {
+            std::cout << "El rival ha salido" << std::endl;
+            state = NET_DISCONNECTED;
+        }
+    }
+
+    void handleInputPacket(const uint8_t* in, size_t size, uint32_t now) {
+        remoteTick = std::max(remoteTick, (long)getU32(in));
+        remoteAdvantage = (int16_t)getU16(in);
+        long ack = (long)(int32_t)getU32(in);
+        if (ack > remoteAck && ack <= lastLocalTick) {
+            float sample = (float)(now - sendTimeMs[slot(ack)]);
+            rttMs = rttMs == 0.0f ? sample : rttMs + (sample - rttMs) * 0.1f;
+            remoteAck = ack;
+        }
+        uint32_t syncTick = getU32(in);
+        uint32_t syncChecksum = getU32(in);
+        if (syncTick != NO_SYNC_TICK && (long)syncTick > pendingSyncTick) {
+            pendingSyncTick = syncTick;
+            pendingSyncChecksum = syncChecksum;
+        }
+
+        long first = (long)getU32(in);
+        int count = *in++;
+        if (size < 4 + 2 + 4 + 4 + 4 + 4 + 1 + (size_t)count * 2) return;
+        int remote = 1 - localPlayer;
+        for (int i = 0; i < count; i++) {
+            long tick = first + i;
+            uint16_t value = getU16(in);
+            if (tick <= lastRemoteTick) continue;      // Repetida
+            if (tick != lastRemoteTick + 1) break;      // Hueco: llegará en otro paquete
+            if (tick >= currentTick + ROLLBACK_HISTORY - MAX_ROLLBACK_TICKS) break;
+            inputs[slot(tick)][remote] = value;
+            lastRemoteTick = tick;
+            // Ya simulado con otra predicción: hay que volver atrás
+            if (tick < currentTick && remoteUsed[slot(tick)] != value) {
+                if (rollbackTo < 0 || tick < rollbackTo) rollbackTo = tick;
+            }
+        }
+    }
+};
+
+// Partida en red sin ventana entre dos procesos, con entrada por script, a tiempo real.
+// Al terminar imprime la suma del estado final: debe coincidir en los dos procesos.
+inline bool runNetHeadless(const NetConfig& config, const HeadlessConfig& headlessConfig) {
+    PaddleController controller = config.host ? headlessConfig.left : headlessConfig.right;
+    if (controller == CONTROL_AI) {
+        std::cout << "En red, la paleta local necesita un control por script (idle, sweep o random)" << std::endl;
+        return false;
+    }
+
+    RollbackSession session;
+    if (!session.start(config, headlessConfig.tickRate)) return false;
+    if (config.host) {
+        std::cout << "Esperando al rival en el puerto " << config.port << "..." << std::endl;
+    } else {
+        std::cout << "Conectando con " << config.address << ":" << config.port << "..." << std::endl;
+    }
+
+    uint32_t waitStart = netTimeMs();
+    while (!session.isConnected()) {
+        session.poll();
+        if (netTimeMs() - waitStart > 30000) {
+            std::cout << "No se pudo conectar con el rival" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    Match match;
+    match.player1.isAI = false;
+    match.player2.isAI = false;
+    match.reset();
+    int localPlayer = session.getLocalPlayer();
+    ScriptedInput script(controller, headlessConfig.seed * 2 + 1 + localPlayer);
+    long endTick = headlessConfig.ticksPerMatch;
+
+    // Un paso por tick a la frecuencia del anfitrión
+    std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / session.getTickRate()));
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while (session.getCurrentTick() < endTick && session.isConnected()) {
+        session.beginFrame();
+        session.poll();
+        session.advance(match, script.next(localPlayer == 0 ? match.player1 : match.player2));
+        session.endFrame();
+        next += period;
+        std::this_thread::sleep_until(next);
+    }
+
+    // Esperar la entrada que falta del rival y que él confirme la nuestra; después se
+    // sigue enviando un momento para que le lleguen nuestras confirmaciones
+    bool remoteComplete = false;
+    uint32_t completeSince = 0;
+    uint32_t settleStart = netTimeMs();
+    while (session.isConnected()) {
+        session.beginFrame();
+        session.poll();
+        bool done = session.settle(match, endTick, remoteComplete);
+        session.endFrame();
+        uint32_t now = netTimeMs();
+        if (remoteComplete && completeSince == 0) completeSince = now;
+        if ((done && now - completeSince > 200) || (remoteComplete && now - completeSince > 1000) ||
+            now - settleStart > NET_TIMEOUT_MS) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    session.stop();
+
+    session.printReport();
+    if (!remoteComplete) {
+        std::cout << "Falta entrada del rival: el estado final no está confirmado" << std::endl;
+        return false;
+    }
+    char checksum[16];
+    snprintf(checksum, sizeof(checksum), "%08x", matchChecksum(match));
+    std::cout << "Estado final (tick " << endTick << "): suma " << checksum
+              << ", marcador " << match.score1 << " - " << match.score2 << std::endl;
+    return true;
+}
+
+#endif
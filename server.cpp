@@ -0,0 +1,116 @@
+// Servidor dedicado de partidas (make server).
+// Aloja cientos de partidas a la vez con la física de pong_core.h y puede lanzar bots
+// locales contra sí mismo para medir la carga sin servicios externos.
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "match_server.h"
+#include "server_bots.h"
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void onInterrupt(int) {
+    interrupted = 1;
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    int botCount = 0;
+    int botThreads = 2;
+    int duration = 0;
+    std::string connectHost;
+    uint16_t connectPort = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            config.port = (uint16_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            config.shards = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--slots") == 0 && i + 1 < argc) {
+            config.slotsPerShard = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            config.tickRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--send-every") == 0 && i + 1 < argc) {
+            config.sendEvery = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            config.pointsToWin = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget-us") == 0 && i + 1 < argc) {
+            config.budgetUs = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--no-pin") == 0) {
+            config.pinThreads = false;
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            config.reportSeconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            duration = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bots") == 0 && i + 1 < argc) {
+            botCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bot-threads") == 0 && i + 1 < argc) {
+            botThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc) {
+            if (!parseNetAddress(argv[++i], connectHost, connectPort)) {
+                std::cout << "Dirección inválida: " << argv[i] << " (usa host:puerto)" << std::endl;
+                return -1;
+            }
+        } else {
+            std::cout << "Opción desconocida: " << argv[i] << std::endl;
+            std::cout << "Uso: pong-server [--port P] [--shards N] [--slots N] [--tick-rate N] [--send-every N]" << std::endl;
+            std::cout << "                 [--points N] [--budget-us X] [--no-pin] [--report S] [--duration S]" << std::endl;
+            std::cout << "                 [--bots N [--bot-threads N] [--connect host:puerto]]" << std::endl;
+            return -1;
+        }
+    }
+
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::seconds(duration);
+    struct KeepRunning {
+        bool timed;
+        std::chrono::steady_clock::time_point end;
+        bool operator()() const {
+            return !interrupted && (!timed || std::chrono::steady_clock::now() < end);
+        }
+    };
+    KeepRunning keepRunning = {duration > 0, end};
+
+    // Solo bots contra otro servidor
+    if (!connectHost.empty()) {
+        BotSwarm swarm;
+        if (botCount <= 0 || !swarm.start(connectHost, connectPort, botCount, botThreads)) {
+            std::cout << "Con --connect hace falta --bots N" << std::endl;
+            return -1;
+        }
+        while (keepRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        swarm.stop();
+        swarm.printReport();
+        return 0;
+    }
+
+    MatchServer server(config);
+    if (!server.start()) {
+        return -1;
+    }
+    BotSwarm swarm;
+    if (botCount > 0 && !swarm.start("127.0.0.1", config.port, botCount, botThreads)) {
+        server.stop();
+        return -1;
+    }
+    if (duration <= 0) {
+        std::cout << "Ctrl+C para terminar" << std::endl;
+    }
+    server.run(keepRunning);
+
+    swarm.stop();
+    server.stop();
+    server.printReport();
+    if (botCount > 0) {
+        swarm.printReport();
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+#ifndef SERVER_BOTS_H
+#define SERVER_BOTS_H
+
+// Bots para probar la carga de pong-server sin servicios externos.
+// Cada bot es un cliente UDP con su propio socket: pide partida, y con cada estado que
+// recibe mueve una copia de su paleta con Paddle::updateAI() y envía la dirección
+// resultante como entrada. Al terminar una partida vuelve a pedir otra, así que el
+// servidor se mantiene lleno. Unos pocos hilos atienden a todos los bots con epoll.
+
+#include "match_server.h"
+#include <netdb.h>
+
+const uint32_t BOT_MISS_PERCENT = 20; // Pelotas que un bot deja pasar sin moverse, para que los puntos acaben
+
+class BotSwarm {
+public:
+    BotSwarm() : stopping(false), statesReceived(0), statesMissed(0), inputsSent(0), matchesFinished(0),
+                 fullReplies(0), playing(0) {}
+
+    ~BotSwarm() {
+        stop();
+    }
+
+    bool start(const std::string& host, uint16_t port, int count, int threadCount) {
+        sockaddr_in server;
+        memset(&server, 0, sizeof(server));
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+            std::cout << "No se pudo resolver " << host << std::endl;
+            return false;
+        }
+        memcpy(&server, result->ai_addr, sizeof(server));
+        server.sin_port = htons(port);
+        freeaddrinfo(result);
+
+        if (threadCount < 1) threadCount = 1;
+        XorShift32 random(0xB075u + count);
+        for (int i = 0; i < count; i++) {
+            Bot bot;
+            bot.fd = socket(AF_INET, SOCK_DGRAM, 0);
+            if (bot.fd < 0 || connect(bot.fd, (const sockaddr*)&server, sizeof(server)) != 0) {
+                std::cout << "Error creando el socket del bot " << i << ": " << strerror(errno)
+                          << " (¿límite de descriptores? prueba ulimit -n)" << std::endl;
+                if (bot.fd >= 0) close(bot.fd);
+                break;
+            }
+            fcntl(bot.fd, F_SETFL, fcntl(bot.fd, F_GETFL, 0) | O_NONBLOCK);
+            // Bots de distinto nivel
+            bot.paddle.isAI = true;
+            bot.paddle.ai.difficulty = 0.5f + 0.5f * (random.next() % 1000) / 1000.0f;
+            bot.random = XorShift32(random.next());
+            bots.push_back(bot);
+        }
+        if (bots.empty()) return false;
+
+        for (int t = 0; t < threadCount; t++) {
+            threads.push_back(std::thread(&BotSwarm::loop, this, t, threadCount));
+        }
+        std::cout << bots.size() << " bots contra " << host << ":" << port << " en " << threadCount << " hilos" << std::endl;
+        return true;
+    }
+
+    void stop() {
+        if (threads.empty()) return;
+        stopping = true;
+        for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+        threads.clear();
+        for (size_t i = 0; i < bots.size(); i++) {
+            if (bots[i].state == BOT_PLAYING || bots[i].state == BOT_WAITING) {
+                sendLeave(bots[i]);
+            }
+            close(bots[i].fd);
+        }
+        bots.clear();
+    }
+
+    int getPlaying() const {
+        return playing.load();
+    }
+
+    void printReport() const {
+        uint64_t received = statesReceived.load(), missed = statesMissed.load();
+        std::cout << "=== Bots ===" << std::endl;
+        std::cout << "Partidas terminadas: " << matchesFinished.load() << "  Respuestas de servidor lleno: "
+                  << fullReplies.load() << std::endl;
+        std::cout << "Estados recibidos: " << received << "  perdidos: " << missed;
+        if (received + missed > 0) std::cout << " (" << 100.0 * missed / (received + missed) << "%)";
+        std::cout << "  Entradas enviadas: " << inputsSent.load() << std::endl;
+    }
+
+private:
+    enum BotState { BOT_JOINING, BOT_WAITING, BOT_PLAYING };
+
+    struct Bot {
+        int fd;
+        BotState state;
+        uint32_t matchId;
+        int side;
+        int tickRate, sendEvery;
+        uint32_t lastTick;
+        uint32_t nextJoinMs;
+        BasicPaddle<float> paddle;  // Los bots siguen el estado en float que manda el servidor
+        XorShift32 random;
+        bool distracted;  // Esta pelota no la sigue
+        float lastVelocityX;
+
+        Bot() : fd(-1), state(BOT_JOINING), matchId(0), side(0), tickRate(DEFAULT_TICK_RATE), sendEvery(1),
+                lastTick(0), nextJoinMs(0), paddle(0.0f, 0.0f, true),
+                distracted(false), lastVelocityX(0.0f) {}
+    };
+
+    std::vector<Bot> bots;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> statesReceived, statesMissed, inputsSent, matchesFinished, fullReplies;
+    std::atomic<int> playing;
+
+    // Cada hilo atiende los bots i con i % threadCount == thread
+    void loop(int thread, int threadCount) {
+        int epollFd = epoll_create1(0);
+        for (size_t i = thread; i < bots.size(); i += threadCount) {
+            epoll_event event;
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.u64 = i;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, bots[i].fd, &event);
+        }
+
+        epoll_event events[64];
+        uint8_t buffer[NET_MAX_PACKET];
+        uint32_t lastRetry = 0;
+        while (!stopping) {
+            int ready = epoll_wait(epollFd, events, 64, 5);
+            for (int e = 0; e < ready; e++) {
+                Bot& bot = bots[events[e].data.u64];
+                ssize_t size;
+                while ((size = recv(bot.fd, buffer, sizeof(buffer), 0)) > 0) {
+                    handlePacket(bot, buffer, (size_t)size);
+                }
+            }
+            // Reintentar JOIN (perdido, sin hueco o esperando rival)
+            uint32_t now = netTimeMs();
+            if (now - lastRetry >= 100) {
+                lastRetry = now;
+                for (size_t i = thread; i < bots.size(); i += threadCount) {
+                    Bot& bot = bots[i];
+                    if (bot.state != BOT_PLAYING && (int32_t)(now - bot.nextJoinMs) >= 0) {
+                        sendJoin(bot);
+                    }
+                }
+            }
+        }
+        close(epollFd);
+    }
+
+    void handlePacket(Bot& bot, const uint8_t* data, size_t size) {
+        if (size < 3) return;
+        const uint8_t* in = data;
+        if (getU16(in) != SERVER_MAGIC) return;
+        uint8_t type = *in++;
+        if (type == SRV_ASSIGN && size >= 11) {
+            // Un ASSIGN de otra partida también vale: la que se esperaba ya no existe en el servidor
+            uint32_t matchId = getU32(in);
+            if (bot.state != BOT_JOINING && matchId == bot.matchId) return;
+            if (bot.state == BOT_PLAYING) playing--;
+            bot.matchId = matchId;
+            bot.side = *in++;
+            bot.tickRate = getU16(in);
+            bot.sendEvery = std::max(1, (int)*in++);
+            bot.lastTick = 0;
+            bot.state = BOT_WAITING;
+            bot.paddle.x = bot.side == 0 ? GAME_MARGIN_SIDES + 20 : WINDOW_WIDTH - GAME_MARGIN_SIDES - 20 - PADDLE_WIDTH;
+        } else if (type == SRV_FULL) {
+            fullReplies++;
+            bot.nextJoinMs = netTimeMs() + 1000; // Esperar un poco más antes de reintentar
+        } else if (type == SRV_STATE && size >= SERVER_STATE_SIZE && bot.state != BOT_JOINING) {
+            ServerState state;
+            decodeServerState(in, state);
+            if (state.matchId != bot.matchId || state.tick <= bot.lastTick) return;
+            if (bot.state == BOT_WAITING) {
+                bot.state = BOT_PLAYING;
+                playing++;
+            } else {
+                statesMissed += (state.tick - bot.lastTick) / bot.sendEvery - 1;
+            }
+            statesReceived++;
+            bot.lastTick = state.tick;
+            respond(bot, state);
+        } else if (type == SRV_END && size >= 7 && getU32(in) == bot.matchId && bot.state != BOT_JOINING) {
+            if (bot.state == BOT_PLAYING) {
+                playing--;
+                matchesFinished++;
+            }
+            bot.state = BOT_JOINING;
+            sendJoin(bot);
+        }
+    }
+
+    // La IA de la paleta decide hacia dónde moverse desde el estado recibido
+    void respond(Bot& bot, const ServerState& state) {
+        if ((state.ballVelocityX > 0) != (bot.lastVelocityX > 0)) {
+            bot.distracted = bot.random.next() % 100 < BOT_MISS_PERCENT;
+        }
+        bot.lastVelocityX = state.ballVelocityX;
+
+        float before = bot.side == 0 ? state.paddle1Y : state.paddle2Y;
+        bot.paddle.y = before;
+        if (!bot.distracted) {
+            bot.paddle.updateAI((float)bot.sendEvery / bot.tickRate, state.ballY + BALL_SIZE / 2, state.ballVelocityX);
+        }
+        PaddleInput input(bot.paddle.y < before, bot.paddle.y > before);
+
+        uint8_t packet[3 + 4 + 2];
+        uint8_t* out = packet;
+        putU16(out, SERVER_MAGIC);
+        *out++ = SRV_INPUT;
+        putU32(out, state.tick);
+        putU16(out, encodeNetInput(input));
+        if (send(bot.fd, packet, sizeof(packet), 0) == (ssize_t)sizeof(packet)) inputsSent++;
+    }
+
+    void sendJoin(Bot& bot) {
+        uint8_t packet[4];
+        uint8_t* out = packet;
+        putU16(out, SERVER_MAGIC);
+        *out++ = SRV_JOIN;
+        *out++ = SERVER_VERSION;
+        send(bot.fd, packet, sizeof(packet), 0);
+        bot.nextJoinMs = netTimeMs() + 500;
+    }
+
+    void sendLeave(Bot& bot) {
+        uint8_t packet[3];
+        uint8_t* out = packet;
+        putU16(out, SERVER_MAGIC);
+        *out++ = SRV_LEAVE;
+        send(bot.fd, packet, sizeof(packet), 0);
+    }
+};
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef SHARED_ENV_H
+#define SHARED_ENV_H
+
+// Transporte del entorno vectorizado por memoria compartida POSIX (shm_open + mmap).
+// El servidor (pong-env --shm) crea un segmento con una cabecera y los arrays de acciones,
+// observaciones, imágenes, recompensas y fines, y VectorEnv escribe directamente en él: el
+// entrenador, en otro proceso, lee los mismos bytes sin copias ni sockets.
+//
+// Protocolo (un paso cada vez): el cliente escribe las acciones y el comando y publica
+// request = n + 1; el servidor lo ejecuta y publica response = n + 1. Las dos esperas giran
+// un momento y luego ceden el procesador o duermen, así que un paso apenas añade latencia si
+// el otro lado responde enseguida y no gasta CPU si tarda. Solo POSIX.
+
+#include "vector_env.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+const uint32_t SHARED_ENV_MAGIC = 0x564E4550;  // "PENV"
+const uint32_t SHARED_ENV_VERSION = 1;
+const size_t SHARED_ENV_ALIGN = 64;            // Cada array empieza en su propia línea de caché
+
+enum SharedEnvCommand {
+    SHARED_ENV_NONE,
+    SHARED_ENV_RESET,
+    SHARED_ENV_STEP,
+    SHARED_ENV_CLOSE   // El servidor termina tras responder
+};
+
+// Cabecera al principio del segmento; los desplazamientos son en bytes desde el principio
+struct SharedEnvHeader {
+    std::atomic<uint32_t> magic;   // Se publica la última: el segmento está listo
+    uint32_t version;
+    uint32_t numEnvs;
+    uint32_t observationSize;      // Floats por partida
+    uint32_t frameWidth, frameHeight;  // 0 sin imagen
+    uint64_t actionsOffset, observationsOffset, framesOffset, rewardsOffset, donesOffset;
+    uint64_t totalSize;
+    std::atomic<uint32_t> command;     // SharedEnvCommand
+    std::atomic<uint32_t> request;     // Peticiones enviadas por el cliente
+    std::atomic<uint32_t> response;    // Peticiones respondidas por el servidor
+};
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "la memoria compartida necesita atómicos sin bloqueo");
+
+// Espera a que value valga target (o, con notEqual, a que deje de valerlo)
+inline bool sharedEnvWait(const std::atomic<uint32_t>& value, uint32_t target, bool notEqual,
+                          int timeoutMs, const volatile sig_atomic_t* stop = nullptr) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (long spin = 0; ; spin++) {
+        uint32_t current = value.load(std::memory_order_acquire);
+        if (notEqual ? current != target : current == target) return true;
+        if (spin < 2000) continue;
+        if (stop && *stop) return false;
+        if (spin < 4000) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        if (timeoutMs >= 0 && (spin & 63) == 0 &&
+            std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeoutMs)) {
+            return false;
+        }
+    }
+}
+
+inline uint64_t sharedEnvAlign(uint64_t offset) {
+    return (offset + SHARED_ENV_ALIGN - 1) / SHARED_ENV_ALIGN * SHARED_ENV_ALIGN;
+}
+
+// Proyección del segmento, común a servidor y cliente
+class SharedEnvMapping {
+public:
+    SharedEnvMapping() : header(nullptr), size(0), owner(false) {}
+
+    ~SharedEnvMapping() {
+        close();
+    }
+
+    SharedEnvHeader* getHeader() const {
+        return header;
+    }
+
+    uint8_t* at(uint64_t offset) const {
+        return (uint8_t*)header + offset;
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    // Si caben count elementos de elementSize bytes a partir de offset, sin desbordar
+    bool holds(uint64_t offset, uint64_t count, uint64_t elementSize) const {
+        if (offset > size) return false;
+        return elementSize == 0 || count <= (size - offset) / elementSize;
+    }
+
+    // Con force borra antes un segmento con el mismo nombre (el de un servidor que murió sin
+    // poder borrarlo, por ejemplo con SIGKILL)
+    bool create(const std::string& segmentName, size_t bytes, bool force = false) {
+        close();
+        if (force && shm_unlink(segmentName.c_str()) != 0 && errno != ENOENT) {
+            std::cout << "Error borrando la memoria compartida " << segmentName << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            std::cout << "Error creando la memoria compartida " << segmentName << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        name = segmentName;
+        owner = true;
+        if (ftruncate(fd, (off_t)bytes) != 0) {
+            std::cout << "Error dimensionando la memoria compartida: " << strerror(errno) << std::endl;
+            ::close(fd);
+            close();
+            return false;
+        }
+        return map(fd, bytes);
+    }
+
+    // Si el segmento aún no existe, o aún no tiene tamaño (el servidor lo crea y luego hace
+    // ftruncate), lo reintenta durante waitMs
+    bool attach(const std::string& segmentName, int waitMs = 0) {
+        close();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (true) {
+            int fd = shm_open(segmentName.c_str(), O_RDWR, 0);
+            if (fd < 0 && errno != ENOENT) {
+                std::cout << "Error abriendo la memoria compartida " << segmentName << ": " << strerror(errno) << std::endl;
+                return false;
+            }
+            if (fd >= 0) {
+                struct stat info;
+                if (fstat(fd, &info) != 0) {
+                    std::cout << "Error consultando la memoria compartida " << segmentName << ": " << strerror(errno) << std::endl;
+                    ::close(fd);
+                    return false;
+                }
+                if ((size_t)info.st_size >= sizeof(SharedEnvHeader)) {
+                    name = segmentName;
+                    return map(fd, (size_t)info.st_size);
+                }
+                ::close(fd);
+            }
+            if (std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(waitMs)) {
+                std::cout << (fd < 0 ? "No existe la memoria compartida " : "Memoria compartida no válida: ")
+                          << segmentName << std::endl;
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // El creador además borra el nombre (los procesos que lo tengan abierto siguen con él)
+    void close() {
+        if (header) {
+            munmap(header, size);
+            header = nullptr;
+        }
+        if (owner) {
+            shm_unlink(name.c_str());
+            owner = false;
+        }
+        size = 0;
+    }
+
+private:
+    SharedEnvHeader* header;
+    size_t size;
+    bool owner;
+    std::string name;
+
+    bool map(int fd, size_t bytes) {
+        void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd); // La proyección sigue siendo válida sin el descriptor
+        if (address == MAP_FAILED) {
+            std::cout << "Error proyectando la memoria compartida: " << strerror(errno) << std::endl;
+            close();
+            return false;
+        }
+        header = (SharedEnvHeader*)address;
+        size = bytes;
+        return true;
+    }
+};
+
+class SharedEnvServer {
+public:
+    explicit SharedEnvServer(VectorEnv& vectorEnv) : env(vectorEnv), actions(nullptr), steps(0) {}
+
+    // Crea el segmento con el tamaño del entorno y lo deja listo para el cliente; force como en
+    // SharedEnvMapping::create()
+    bool create(const std::string& name, bool force = false) {
+        uint64_t offset = sharedEnvAlign(sizeof(SharedEnvHeader));
+        uint64_t n = (uint64_t)env.getNumEnvs();
+        uint64_t actionsOffset = offset;
+        offset = sharedEnvAlign(offset + n);
+        uint64_t observationsOffset = offset;
+        offset = sharedEnvAlign(offset + n * ENV_OBSERVATION_SIZE * sizeof(float));
+        uint64_t framesOffset = offset;
+        offset = sharedEnvAlign(offset + n * env.getFrameSize());
+        uint64_t rewardsOffset = offset;
+        offset = sharedEnvAlign(offset + n * sizeof(float));
+        uint64_t donesOffset = offset;
+        offset = sharedEnvAlign(offset + n);
+
+        if (!mapping.create(name, (size_t)offset, force)) return false;
+        // ftruncate deja el segmento a cero: los atómicos empiezan en 0
+        SharedEnvHeader* header = mapping.getHeader();
+        header->version = SHARED_ENV_VERSION;
+        header->numEnvs = (uint32_t)n;
+        header->observationSize = ENV_OBSERVATION_SIZE;
+        header->frameWidth = (uint32_t)env.getFrameWidth();
+        header->frameHeight = (uint32_t)env.getFrameHeight();
+        header->actionsOffset = actionsOffset;
+        header->observationsOffset = observationsOffset;
+        header->framesOffset = framesOffset;
+        header->rewardsOffset = rewardsOffset;
+        header->donesOffset = donesOffset;
+        header->totalSize = offset;
+
+        buffers.observations = (float*)mapping.at(observationsOffset);
+        buffers.frames = env.getFrameSize() > 0 ? mapping.at(framesOffset) : nullptr;
+        buffers.rewards = (float*)mapping.at(rewardsOffset);
+        buffers.dones = mapping.at(donesOffset);
+        actions = mapping.at(actionsOffset);
+
+        env.reset(buffers); // Observaciones válidas antes del primer paso
+        header->magic.store(SHARED_ENV_MAGIC, std::memory_order_release);
+        return true;
+    }
+
+    // Atiende peticiones hasta SHARED_ENV_CLOSE o hasta que *stop se active
+    void serve(const volatile sig_atomic_t* stop) {
+        SharedEnvHeader* header = mapping.getHeader();
+        uint32_t handled = header->request.load(std::memory_order_acquire);
+        while (!*stop) {
+            if (!sharedEnvWait(header->request, handled, true, -1, stop)) break;
+            uint32_t request = header->request.load(std::memory_order_acquire);
+            SharedEnvCommand command = (SharedEnvCommand)header->command.load(std::memory_order_relaxed);
+            if (command == SHARED_ENV_STEP) {
+                env.step(actions, buffers);
+                steps++;
+            } else if (command == SHARED_ENV_RESET) {
+                env.reset(buffers);
+            }
+            handled = request;
+            header->response.store(request, std::memory_order_release);
+            if (command == SHARED_ENV_CLOSE) break;
+        }
+    }
+
+    long getSteps() const {
+        return steps;
+    }
+
+private:
+    VectorEnv& env;
+    SharedEnvMapping mapping;
+    EnvBuffers buffers;
+    uint8_t* actions;
+    long steps;
+};
+
+class SharedEnvClient {
+public:
+    SharedEnvClient() : header(nullptr) {}
+
+    // Se une al segmento del servidor; waitMs es lo que espera a que exista y esté listo
+    bool attach(const std::string& name, int waitMs = 5000) {
+        if (!mapping.attach(name, waitMs)) return false;
+        header = mapping.getHeader();
+        if (!sharedEnvWait(header->magic, SHARED_ENV_MAGIC, false, waitMs) || header->version != SHARED_ENV_VERSION) {
+            std::cout << "La memoria compartida " << name << " no es de un entorno compatible" << std::endl;
+            detach();
+            return false;
+        }
+        // Los desplazamientos vienen de otro proceso: todos los arrays tienen que caber en lo
+        // proyectado antes de dar punteros a ellos
+        uint64_t n = header->numEnvs;
+        if (header->totalSize > mapping.getSize() ||
+            !mapping.holds(header->actionsOffset, n, 1) ||
+            !mapping.holds(header->observationsOffset, n, (uint64_t)header->observationSize * sizeof(float)) ||
+            !mapping.holds(header->framesOffset, n, (uint64_t)header->frameWidth * header->frameHeight) ||
+            !mapping.holds(header->rewardsOffset, n, sizeof(float)) ||
+            !mapping.holds(header->donesOffset, n, 1)) {
+            std::cout << "La memoria compartida " << name << " no es válida: los arrays no caben en el segmento" << std::endl;
+            detach();
+            return false;
+        }
+        return true;
+    }
+
+    void detach() {
+        mapping.close();
+        header = nullptr;
+    }
+
+    int getNumEnvs() const { return (int)header->numEnvs; }
+    int getFrameWidth() const { return (int)header->frameWidth; }
+    int getFrameHeight() const { return (int)header->frameHeight; }
+
+    // Punteros al segmento: se escriben las acciones y, tras reset() o step(), se leen los
+    // resultados en el sitio (válidos hasta la siguiente petición)
+    uint8_t* getActions() const { return mapping.at(header->actionsOffset); }
+    const float* getObservations() const { return (const float*)mapping.at(header->observationsOffset); }
+    const uint8_t* getFrames() const { return header->frameWidth > 0 ? mapping.at(header->framesOffset) : nullptr; }
+    const float* getRewards() const { return (const float*)mapping.at(header->rewardsOffset); }
+    const uint8_t* getDones() const { return mapping.at(header->donesOffset); }
+
+    bool reset(int timeoutMs = -1) {
+        return send(SHARED_ENV_RESET, timeoutMs);
+    }
+
+    bool step(int timeoutMs = -1) {
+        return send(SHARED_ENV_STEP, timeoutMs);
+    }
+
+    // Pide al servidor que termine
+    bool close(int timeoutMs = 1000) {
+        return send(SHARED_ENV_CLOSE, timeoutMs);
+    }
+
+private:
+    SharedEnvMapping mapping;
+    SharedEnvHeader* header;
+
+    bool send(SharedEnvCommand command, int timeoutMs) {
+        if (!header) return false;
+        uint32_t request = header->request.load(std::memory_order_relaxed) + 1;
+        header->command.store(command, std::memory_order_relaxed);
+        header->request.store(request, std::memory_order_release);
+        return sharedEnvWait(header->response, request, false, timeoutMs);
+    }
+};
+
+#endif
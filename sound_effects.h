@@ -0,0 +1,185 @@
+#ifndef SOUND_EFFECTS_H
+#define SOUND_EFFECTS_H
+
+// Efectos de sonido sintetizados al arrancar.
+// Los golpes de paleta, los rebotes en pared y los puntos se generan como PCM en el formato
+// del dispositivo (tras Mix_OpenAudio) y se envuelven con Mix_QuickLoad_RAW, así que
+// reproducirlos no decodifica ni reserva memoria. Suenan en canales reservados para ellos
+// (Mix_ReserveChannels) agrupados en SFX_GROUP; si están todos ocupados se corta el más
+// antiguo en vez de perder el golpe nuevo.
+//
+// Latencia: al disparar un efecto se apunta el instante y se registra en su canal un efecto
+// de mezcla que apunta cuándo el hilo de audio lo mezcla por primera vez. A eso se suma la
+// duración del buffer del dispositivo, que es lo que tarda en sonar lo ya mezclado.
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <stdint.h>
+#include <vector>
+
+enum SoundEffect {
+    SFX_PADDLE_HIT,
+    SFX_WALL_BOUNCE,
+    SFX_SCORE,
+    SFX_COUNT
+};
+
+const int SFX_CHANNELS = 4;            // Canales reservados (0..SFX_CHANNELS-1)
+const int SFX_GROUP = 1;               // Grupo de SDL_mixer de esos canales
+const int SFX_LATENCY_SAMPLES = 512;   // Medidas de latencia guardadas (las más recientes)
+
+class SoundEffects {
+public:
+    SoundEffects() : ready(false), frequency(0), outputChannels(0), bufferSamples(0),
+                     msPerCount(0.0), played(0), stolen(0), latencyCount(0) {
+        for (int i = 0; i < SFX_COUNT; i++) chunks[i] = nullptr;
+        for (int i = 0; i < SFX_CHANNELS; i++) triggerCounts[i] = 0;
+        for (int i = 0; i < SFX_LATENCY_SAMPLES; i++) latencies[i] = 0.0f; // Un hueco contado puede leerse antes de escribirse
+    }
+
+    // Llamar con el mezclador ya abierto; bufferSize es el que se pidió a Mix_OpenAudio
+    bool init(int bufferSize) {
+        Uint16 format = 0;
+        if (!Mix_QuerySpec(&frequency, &format, &outputChannels)) {
+            std::cout << "Error consultando el formato de audio: " << Mix_GetError() << std::endl;
+            return false;
+        }
+        if (format != AUDIO_S16SYS) {
+            std::cout << "Efectos de sonido desactivados: formato de audio no soportado" << std::endl;
+            return false;
+        }
+        bufferSamples = bufferSize;
+        msPerCount = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+        if (Mix_AllocateChannels(-1) < SFX_CHANNELS) {
+            Mix_AllocateChannels(SFX_CHANNELS);
+        }
+        Mix_ReserveChannels(SFX_CHANNELS);
+        Mix_GroupChannels(0, SFX_CHANNELS - 1, SFX_GROUP);
+
+        // Tonos cortos con caída exponencial; el punto baja de tono para distinguirse
+        synthesize(pcm[SFX_PADDLE_HIT], 0.06f, 660.0f, 660.0f, 0.020f, 0.45f);
+        synthesize(pcm[SFX_WALL_BOUNCE], 0.04f, 330.0f, 330.0f, 0.015f, 0.35f);
+        synthesize(pcm[SFX_SCORE], 0.25f, 880.0f, 220.0f, 0.120f, 0.40f);
+        for (int i = 0; i < SFX_COUNT; i++) {
+            chunks[i] = Mix_QuickLoad_RAW((Uint8*)pcm[i].data(), (Uint32)(pcm[i].size() * sizeof(int16_t)));
+            if (!chunks[i]) {
+                std::cout << "Error preparando los efectos de sonido: " << Mix_GetError() << std::endl;
+                cleanup();
+                return false;
+            }
+        }
+        ready = true;
+        return true;
+    }
+
+    void play(SoundEffect effect) {
+        if (!ready) return;
+        int channel = Mix_GroupAvailable(SFX_GROUP);
+        if (channel < 0) {
+            channel = Mix_GroupOldest(SFX_GROUP);
+            if (channel < 0) return;
+            Mix_HaltChannel(channel); // También quita el efecto de medida del canal
+            stolen++;
+        }
+        // El efecto se registra antes de empezar para no perder la primera mezcla
+        triggerCounts[channel] = SDL_GetPerformanceCounter();
+        Mix_RegisterEffect(channel, onMix, nullptr, this);
+        if (Mix_PlayChannel(channel, chunks[effect], 0) < 0) {
+            triggerCounts[channel] = 0;
+            return;
+        }
+        played++;
+    }
+
+    // Duración del buffer del dispositivo: retardo entre mezclar y oír
+    double getBufferMs() const {
+        return frequency > 0 ? 1000.0 * bufferSamples / frequency : 0.0;
+    }
+
+    void printReport() const {
+        if (!ready || played == 0) return;
+        unsigned count = std::min(latencyCount.load(), (unsigned)SFX_LATENCY_SAMPLES);
+        // Copia hueco a hueco: el hilo de audio puede seguir escribiendo mientras tanto
+        std::vector<float> sorted(count);
+        for (unsigned i = 0; i < count; i++) {
+            sorted[i] = latencies[i].load(std::memory_order_relaxed);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        std::cout << "=== Efectos de sonido ===" << std::endl;
+        std::cout << "Reproducidos: " << played << "  Cortados por falta de canal: " << stolen << std::endl;
+        std::cout << "Buffer de audio: " << bufferSamples << " muestras (" << getBufferMs() << " ms a "
+                  << frequency << " Hz)" << std::endl;
+        if (!sorted.empty()) {
+            float p50 = sorted[sorted.size() / 2];
+            float p95 = sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)];
+            std::cout << "Disparo -> mezcla: p50 " << p50 << " ms  p95 " << p95 << " ms  máx "
+                      << sorted.back() << " ms (" << sorted.size() << " medidas)" << std::endl;
+            std::cout << "Disparo -> salida estimada: p50 " << p50 + getBufferMs() << " ms  p95 "
+                      << p95 + getBufferMs() << " ms" << std::endl;
+        }
+    }
+
+    void cleanup() {
+        ready = false;
+        Mix_HaltGroup(SFX_GROUP);
+        for (int i = 0; i < SFX_COUNT; i++) {
+            if (chunks[i]) {
+                Mix_FreeChunk(chunks[i]); // QuickLoad: no libera pcm, que es nuestro
+                chunks[i] = nullptr;
+            }
+        }
+    }
+
+private:
+    bool ready;
+    int frequency, outputChannels, bufferSamples;
+    double msPerCount;
+    std::vector<int16_t> pcm[SFX_COUNT];
+    Mix_Chunk* chunks[SFX_COUNT];
+    int played, stolen;
+
+    // Los escribe el hilo de audio
+    std::atomic<Uint64> triggerCounts[SFX_CHANNELS];
+    std::atomic<unsigned> latencyCount;
+    std::atomic<float> latencies[SFX_LATENCY_SAMPLES];
+
+    // Tono de frecuencia startHz -> endHz con ataque corto y caída exponencial, intercalado
+    // para todos los canales de salida
+    void synthesize(std::vector<int16_t>& out, float seconds, float startHz, float endHz,
+                    float decaySeconds, float volume) const {
+        const float twoPi = 6.2831853f;
+        const float attack = 0.002f;
+        int frames = (int)(seconds * frequency);
+        out.assign((size_t)frames * outputChannels, 0);
+        float phase = 0.0f;
+        for (int i = 0; i < frames; i++) {
+            float t = (float)i / frequency;
+            float hz = startHz + (endHz - startHz) * t / seconds;
+            phase += twoPi * hz / frequency;
+            if (phase > twoPi) phase -= twoPi;
+            float envelope = std::exp(-t / decaySeconds) * std::min(1.0f, t / attack);
+            int16_t sample = (int16_t)(std::sin(phase) * envelope * volume * 32767.0f);
+            for (int c = 0; c < outputChannels; c++) {
+                out[(size_t)i * outputChannels + c] = sample;
+            }
+        }
+    }
+
+    // Efecto de SDL_mixer: no toca el audio, solo apunta la primera mezcla tras el disparo
+    static void onMix(int channel, void*, int, void* userData) {
+        SoundEffects* self = (SoundEffects*)userData;
+        if (channel < 0 || channel >= SFX_CHANNELS) return;
+        Uint64 trigger = self->triggerCounts[channel].exchange(0);
+        if (trigger == 0) return;
+        float ms = (float)((SDL_GetPerformanceCounter() - trigger) * self->msPerCount);
+        unsigned index = self->latencyCount++;
+        self->latencies[index % SFX_LATENCY_SAMPLES].store(ms, std::memory_order_relaxed);
+    }
+};
+
+#endif
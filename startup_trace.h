@@ -0,0 +1,117 @@
+#ifndef STARTUP_TRACE_H
+#define STARTUP_TRACE_H
+
+// Etapas del arranque con su instante de inicio y su duración (--startup-trace).
+// Se apuntan siempre (son unas pocas); con la traza activada se imprime la tabla al mostrar
+// el primer frame y, después, una línea por cada etapa diferida (mandos, audio, música)
+// según termina. Las etapas de otros hilos se apuntan desde ese hilo.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class StartupTrace {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    StartupTrace() : enabled(false), reported(false), origin(Clock::now()) {}
+
+    void setEnabled(bool enable) {
+        enabled = enable;
+    }
+
+    // Marca el inicio del arranque (todas las etapas se miden desde aquí)
+    void restart() {
+        std::lock_guard<std::mutex> lock(mutex);
+        origin = Clock::now();
+        stages.clear();
+        reported = false;
+    }
+
+    static Clock::time_point now() {
+        return Clock::now();
+    }
+
+    double elapsedMs() const {
+        return toMs(Clock::now() - origin);
+    }
+
+    // Etapa que empezó en start y termina ahora; worker indica que corrió en otro hilo
+    void record(const std::string& name, Clock::time_point start, bool worker = false) {
+        record(name, start, Clock::now(), worker);
+    }
+
+    void record(const std::string& name, Clock::time_point start, Clock::time_point end, bool worker) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stage stage;
+        stage.name = name;
+        stage.startMs = toMs(start - origin);
+        stage.durationMs = toMs(end - start);
+        stage.worker = worker;
+        stages.push_back(stage);
+        if (enabled && reported) {
+            printStage(stage);
+        }
+    }
+
+    // Tabla de las etapas hasta el primer frame; las siguientes se imprimen al apuntarse
+    void reportFirstFrame(double firstFrameMs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reported = true;
+        if (!enabled) return;
+        // Formato en un ostringstream para no dejar std::fixed puesto en std::cout
+        std::ostringstream out;
+        out << "=== Arranque (ms desde el inicio) ===\n";
+        out << padded("etapa") << std::setw(9) << "inicio" << std::setw(10) << "duración" << "  hilo\n";
+        for (size_t i = 0; i < stages.size(); i++) {
+            formatStage(out, stages[i]);
+        }
+        out << padded("primer frame") << std::fixed << std::setprecision(1) << std::setw(9) << firstFrameMs << '\n';
+        out << "(las etapas diferidas aparecen al terminar)\n";
+        std::cout << out.str() << std::flush;
+    }
+
+private:
+    struct Stage {
+        std::string name;
+        double startMs, durationMs;
+        bool worker;
+    };
+
+    bool enabled;
+    bool reported;
+    Clock::time_point origin;
+    std::vector<Stage> stages;
+    std::mutex mutex;
+
+    static double toMs(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    // Nombre rellenado a 28 columnas contando caracteres UTF-8, no bytes (setw cuenta bytes)
+    static std::string padded(const std::string& name) {
+        size_t columns = 0;
+        for (size_t i = 0; i < name.size(); i++) {
+            if ((name[i] & 0xC0) != 0x80) columns++;
+        }
+        return name + std::string(columns < 28 ? 28 - columns : 1, ' ');
+    }
+
+    static void formatStage(std::ostringstream& out, const Stage& stage) {
+        out << padded(stage.name) << std::fixed << std::setprecision(1)
+            << std::setw(9) << stage.startMs << std::setw(9) << stage.durationMs
+            << (stage.worker ? "  trabajo\n" : "  principal\n");
+    }
+
+    static void printStage(const Stage& stage) {
+        std::ostringstream out;
+        formatStage(out, stage);
+        std::cout << out.str() << std::flush;
+    }
+};
+
+#endif
@@ -0,0 +1,288 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+// Texto con fuente de mapa de bits.
+// Al arrancar se genera un atlas con los glifos 5x7 de todo el ASCII imprimible (32-126).
+// drawText() coloca un quad por carácter en el DrawBatch: todos los glifos del atlas van al
+// mismo lote y el texto de un frame se emite con una sola llamada de geometría.
+// Las cadenas que se repiten cada frame se pueden cachear enteras en una textura.
+
+#include "draw_batch.h"
+#include <SDL2/SDL.h>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Fuente 5x7 clásica: 5 columnas por glifo, bit 0 = fila superior
+static const unsigned char FONT_5X7[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // '!'
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // '"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // '#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // '$'
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // '%'
+    {0x36, 0x49, 0x55, 0x22, 0x50}, // '&'
+    {0x00, 0x05, 0x03, 0x00, 0x00}, // '''
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // '('
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // ')'
+    {0x14, 0x08, 0x3E, 0x08, 0x14}, // '*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // '+'
+    {0x00, 0x50, 0x30, 0x00, 0x00}, // ','
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // '-'
+    {0x00, 0x60, 0x60, 0x00, 0x00}, // '.'
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // '/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // '0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // '1'
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // '2'
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, // '3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // '4'
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // '5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // '6'
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // '7'
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // '8'
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // '9'
+    {0x00, 0x36, 0x36, 0x00, 0x00}, // ':'
+    {0x00, 0x56, 0x36, 0x00, 0x00}, // ';'
+    {0x08, 0x14, 0x22, 0x41, 0x00}, // '<'
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // '='
+    {0x00, 0x41, 0x22, 0x14, 0x08}, // '>'
+    {0x02, 0x01, 0x51, 0x09, 0x06}, // '?'
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, // '@'
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // 'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // 'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // 'C'
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // 'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // 'E'
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, // 'F'
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, // 'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // 'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // 'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // 'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // 'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // 'L'
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // 'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // 'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // 'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // 'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // 'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // 'R'
+    {0x46, 0x49, 0x49, 0x49, 0x31}, // 'S'
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, // 'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // 'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // 'V'
+    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // 'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // 'X'
+    {0x07, 0x08, 0x70, 0x08, 0x07}, // 'Y'
+    {0x61, 0x51, 0x49, 0x45, 0x43}, // 'Z'
+    {0x00, 0x7F, 0x41, 0x41, 0x00}, // '['
+    {0x02, 0x04, 0x08, 0x10, 0x20}, // '\'
+    {0x00, 0x41, 0x41, 0x7F, 0x00}, // ']'
+    {0x04, 0x02, 0x01, 0x02, 0x04}, // '^'
+    {0x40, 0x40, 0x40, 0x40, 0x40}, // '_'
+    {0x00, 0x01, 0x02, 0x04, 0x00}, // '`'
+    {0x20, 0x54, 0x54, 0x54, 0x78}, // 'a'
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, // 'b'
+    {0x38, 0x44, 0x44, 0x44, 0x20}, // 'c'
+    {0x38, 0x44, 0x44, 0x48, 0x7F}, // 'd'
+    {0x38, 0x54, 0x54, 0x54, 0x18}, // 'e'
+    {0x08, 0x7E, 0x09, 0x01, 0x02}, // 'f'
+    {0x0C, 0x52, 0x52, 0x52, 0x3E}, // 'g'
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, // 'h'
+    {0x00, 0x44, 0x7D, 0x40, 0x00}, // 'i'
+    {0x20, 0x40, 0x44, 0x3D, 0x00}, // 'j'
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, // 'k'
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, // 'l'
+    {0x7C, 0x04, 0x18, 0x04, 0x78}, // 'm'
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, // 'n'
+    {0x38, 0x44, 0x44, 0x44, 0x38}, // 'o'
+    {0x7C, 0x14, 0x14, 0x14, 0x08}, // 'p'
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, // 'q'
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, // 'r'
+    {0x48, 0x54, 0x54, 0x54, 0x20}, // 's'
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, // 't'
+    {0x3C, 0x40, 0x40, 0x20, 0x7C}, // 'u'
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, // 'v'
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, // 'w'
+    {0x44, 0x28, 0x10, 0x28, 0x44}, // 'x'
+    {0x0C, 0x50, 0x50, 0x50, 0x3C}, // 'y'
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, // 'z'
+    {0x00, 0x08, 0x36, 0x41, 0x00}, // '{'
+    {0x00, 0x00, 0x7F, 0x00, 0x00}, // '|'
+    {0x00, 0x41, 0x36, 0x08, 0x00}, // '}'
+    {0x08, 0x04, 0x08, 0x10, 0x08}  // '~'
+};
+
+class TextRenderer {
+public:
+    static const int GLYPH_WIDTH = 5;
+    static const int GLYPH_HEIGHT = 7;
+    static const int ADVANCE = 6;          // Ancho del glifo más una columna de separación
+    static const int FIRST_CHAR = 32;
+    static const int LAST_CHAR = 126;
+    static const int ATLAS_COLUMNS = 16;
+
+    TextRenderer() : renderer(nullptr), atlas(nullptr), canCache(false) {}
+
+    // Genera el atlas. Si falla, drawText() dibuja los píxeles de los glifos como rectángulos
+    bool init(SDL_Renderer* target) {
+        renderer = target;
+
+        const int cellW = ADVANCE;
+        const int cellH = GLYPH_HEIGHT + 1;
+        const int glyphCount = LAST_CHAR - FIRST_CHAR + 1;
+        const int atlasW = ATLAS_COLUMNS * cellW;
+        const int atlasH = ((glyphCount + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS) * cellH;
+
+        // Glifos en blanco sobre transparente: el color lo pone el tinte de cada vértice
+        std::vector<Uint32> pixels(atlasW * atlasH, 0x00FFFFFF);
+        for (int g = 0; g < glyphCount; g++) {
+            int cellX = (g % ATLAS_COLUMNS) * cellW;
+            int cellY = (g / ATLAS_COLUMNS) * cellH;
+            for (int col = 0; col < GLYPH_WIDTH; col++) {
+                for (int row = 0; row < GLYPH_HEIGHT; row++) {
+                    if (FONT_5X7[g][col] & (1 << row)) {
+                        pixels[(cellY + row) * atlasW + cellX + col] = 0xFFFFFFFF;
+                    }
+                }
+            }
+        }
+
+        atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, atlasW, atlasH);
+        if (!atlas) {
+            std::cout << "Advertencia: no se pudo crear el atlas de glifos: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        SDL_UpdateTexture(atlas, nullptr, &pixels[0], atlasW * (int)sizeof(Uint32));
+        SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+
+        SDL_RendererInfo info;
+        canCache = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_TARGETTEXTURE);
+        return true;
+    }
+
+    // Ancho en píxeles de la cadena a la escala dada (sin la separación final)
+    static int measure(const char* text, int scale) {
+        int length = (int)strlen(text);
+        return length > 0 ? (length * ADVANCE - 1) * scale : 0;
+    }
+
+    static int lineHeight(int scale) {
+        return GLYPH_HEIGHT * scale;
+    }
+
+    // Añade la cadena al lote con el color actual del DrawBatch
+    void drawText(DrawBatch& batch, const char* text, int x, int y, int scale) {
+        for (int i = 0; text[i] != '\0'; i++) {
+            int glyph = glyphIndex(text[i]);
+            int penX = x + i * ADVANCE * scale;
+            if (glyph == 0) continue; // Espacio
+
+            if (atlas) {
+                SDL_Rect src = glyphSource(glyph);
+                SDL_Rect dst = {penX, y, GLYPH_WIDTH * scale, GLYPH_HEIGHT * scale};
+                batch.drawTexture(atlas, src, dst);
+            } else {
+                drawGlyphPixels(batch, glyph, penX, y, scale);
+            }
+        }
+    }
+
+    // Como drawText(), pero la cadena se compone una vez en su propia textura y después se
+    // dibuja con un único quad. Sin texturas de render se dibuja glifo a glifo.
+    void drawCachedText(DrawBatch& batch, const char* text, int x, int y, int scale) {
+        if (!atlas || !canCache) {
+            drawText(batch, text, x, y, scale);
+            return;
+        }
+
+        const CachedText* cached = getCached(text, scale);
+        if (!cached) {
+            drawText(batch, text, x, y, scale);
+            return;
+        }
+        SDL_Rect src = {0, 0, cached->w, cached->h};
+        SDL_Rect dst = {x, y, cached->w, cached->h};
+        batch.drawTexture(cached->texture, src, dst);
+    }
+
+    // Las texturas de render pueden perder su contenido (SDL_RENDER_TARGETS_RESET)
+    void clearCache() {
+        for (std::map<std::string, CachedText>::iterator it = cache.begin(); it != cache.end(); ++it) {
+            SDL_DestroyTexture(it->second.texture);
+        }
+        cache.clear();
+    }
+
+    void cleanup() {
+        clearCache();
+        if (atlas) {
+            SDL_DestroyTexture(atlas);
+            atlas = nullptr;
+        }
+    }
+
+private:
+    struct CachedText {
+        SDL_Texture* texture;
+        int w, h;
+    };
+
+    SDL_Renderer* renderer;
+    SDL_Texture* atlas;
+    bool canCache;
+    std::map<std::string, CachedText> cache;
+
+    static int glyphIndex(char c) {
+        int code = (unsigned char)c;
+        if (code < FIRST_CHAR || code > LAST_CHAR) code = '?';
+        return code - FIRST_CHAR;
+    }
+
+    static SDL_Rect glyphSource(int glyph) {
+        SDL_Rect src = {(glyph % ATLAS_COLUMNS) * ADVANCE, (glyph / ATLAS_COLUMNS) * (GLYPH_HEIGHT + 1),
+                        GLYPH_WIDTH, GLYPH_HEIGHT};
+        return src;
+    }
+
+    static void drawGlyphPixels(DrawBatch& batch, int glyph, int x, int y, int scale) {
+        for (int col = 0; col < GLYPH_WIDTH; col++) {
+            for (int row = 0; row < GLYPH_HEIGHT; row++) {
+                if (FONT_5X7[glyph][col] & (1 << row)) {
+                    SDL_Rect pixel = {x + col * scale, y + row * scale, scale, scale};
+                    batch.fillRect(pixel);
+                }
+            }
+        }
+    }
+
+    const CachedText* getCached(const char* text, int scale) {
+        std::string key = std::to_string(scale) + ':' + text;
+        std::map<std::string, CachedText>::iterator it = cache.find(key);
+        if (it != cache.end()) return &it->second;
+
+        CachedText entry;
+        entry.w = measure(text, scale);
+        entry.h = lineHeight(scale);
+        if (entry.w <= 0) return nullptr;
+        entry.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, entry.w, entry.h);
+        if (!entry.texture) return nullptr;
+        SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_BLEND);
+
+        // Componer en blanco; al dibujarla se tiñe con el color actual como el atlas
+        SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, entry.texture);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 0);
+        SDL_RenderClear(renderer);
+        DrawBatch local;
+        local.setColor(255, 255, 255, 255);
+        drawText(local, text, 0, 0, scale);
+        local.flush(renderer);
+        SDL_SetRenderTarget(renderer, previous);
+
+        return &(cache[key] = entry);
+    }
+};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+// Pool de hilos con robo de trabajo (work stealing).
+// Cada hilo tiene su propia cola: saca tareas por detrás de la suya y, cuando se queda
+// sin trabajo, roba por delante de las colas de los demás. Así las partidas largas
+// no dejan núcleos ociosos mientras otros acumulan tareas.
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+    struct WorkQueue {
+        std::deque<std::function<void()> > tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue> > queues;
+    std::vector<std::thread> threads;
+    std::atomic<int> queued;     // Tareas esperando en alguna cola
+    std::atomic<int> pending;    // Tareas enviadas y aún no terminadas
+    std::atomic<unsigned> nextQueue;
+    bool stopping;
+    std::mutex stateMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+
+public:
+    explicit ThreadPool(unsigned threadCount = 0) :
+        queued(0), pending(0), nextQueue(0), stopping(false) {
+        if (threadCount == 0) {
+            threadCount = defaultThreadCount();
+        }
+        for (unsigned i = 0; i < threadCount; i++) {
+            queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+        }
+        for (unsigned i = 0; i < threadCount; i++) {
+            threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        workAvailable.notify_all();
+        for (size_t i = 0; i < threads.size(); i++) {
+            threads[i].join();
+        }
+    }
+
+    static unsigned defaultThreadCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    unsigned size() const {
+        return (unsigned)threads.size();
+    }
+
+    // Reparte las tareas en round-robin entre las colas; el robo equilibra el resto
+    void submit(const std::function<void()>& task) {
+        unsigned index = nextQueue++ % queues.size();
+        pending++;
+        // queued sube antes de encolar: si un hilo sacara la tarea antes del incremento, el
+        // contador bajaría a -1 y los hilos ociosos girarían en vez de dormir
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            queued++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(task);
+        }
+        workAvailable.notify_one();
+    }
+
+    // Bloquea hasta que todas las tareas enviadas hayan terminado
+    void wait() {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (pending.load() > 0) {
+            allDone.wait(lock);
+        }
+    }
+
+private:
+    bool popLocal(unsigned index, std::function<void()>& task) {
+        WorkQueue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(unsigned thief, std::function<void()>& task) {
+        for (size_t offset = 1; offset < queues.size(); offset++) {
+            WorkQueue& victim = *queues[(thief + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned index) {
+        std::function<void()> task;
+        while (true) {
+            if (popLocal(index, task) || steal(index, task)) {
+                queued--;
+                task();
+                task = nullptr;
+                if (--pending == 0) {
+                    std::lock_guard<std::mutex> lock(stateMutex);
+                    allDone.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(stateMutex);
+            while (!stopping && queued.load() == 0) {
+                workAvailable.wait(lock);
+            }
+            if (stopping && queued.load() == 0) {
+                return;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,274 @@
+#ifndef VECTOR_ENV_H
+#define VECTOR_ENV_H
+
+// Entorno vectorizado para aprendizaje por refuerzo: N partidas en paralelo con reset() y
+// step(acciones). El agente mueve la paleta izquierda (player1) y la derecha es la IA del
+// juego. Cada partida es un Match normal (mismas reglas de Ball/Paddle y geometría GAME_*),
+// así que lo aprendido aquí vale para el juego.
+//
+// Las observaciones, recompensas y fines de episodio se escriben en buffers contiguos del
+// llamador (EnvBuffers): N * ENV_OBSERVATION_SIZE floats, N floats, N bytes y, si se piden
+// imágenes, N * ancho * alto bytes. Así el entrenador puede pasar sus propios arrays (numpy,
+// tensores fijados...) o la memoria compartida de shared_env.h sin copias intermedias.
+//
+// Un episodio termina cuando alguien llega a pointsPerEpisode (ENV_TERMINATED) o tras
+// maxStepsPerEpisode pasos (ENV_TRUNCATED). Ese env se reinicia en el mismo step(): la
+// recompensa y el fin son los del episodio terminado y la observación ya es la del nuevo.
+
+#include "pong_core.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+enum EnvAction {
+    ENV_ACTION_STAY = 0,
+    ENV_ACTION_UP = 1,
+    ENV_ACTION_DOWN = 2
+};
+
+// Valor de dones[i] tras step()
+enum EnvDone {
+    ENV_RUNNING = 0,
+    ENV_TERMINATED = 1, // Alguien llegó a pointsPerEpisode
+    ENV_TRUNCATED = 2   // Límite de pasos del episodio
+};
+
+// Componentes de la observación de cada partida, normalizados a [-1, 1] aprox.
+enum EnvObservation {
+    OBS_BALL_X,         // Centro de la pelota en el campo
+    OBS_BALL_Y,
+    OBS_BALL_VX,        // Velocidad / BALL_SPEED
+    OBS_BALL_VY,
+    OBS_PADDLE_Y,       // Centro de la paleta del agente
+    OBS_OPPONENT_Y,     // Centro de la paleta rival
+    OBS_SCORE,          // Puntos del agente / pointsPerEpisode
+    OBS_OPPONENT_SCORE,
+    ENV_OBSERVATION_SIZE
+};
+
+const uint8_t ENV_FRAME_PADDLE = 160; // Intensidad de las paletas en la imagen (fondo 0)
+const uint8_t ENV_FRAME_BALL = 255;
+const size_t ENV_MIN_CHUNK = 256;     // Partidas por tarea como mínimo al repartir entre hilos
+const size_t ENV_CHUNK_ALIGN = 64;    // Los trozos empiezan en múltiplos de 64 partidas (sin líneas de caché compartidas)
+
+struct EnvConfig {
+    int numEnvs;
+    int ticksPerStep;         // Ticks de física por paso, repitiendo la acción
+    int tickRate;
+    int pointsPerEpisode;
+    long maxStepsPerEpisode;  // 0 = sin límite
+    int frameScale;           // 0 = sin imagen; si no, píxeles del campo por píxel de imagen
+    AIParams opponent;
+    unsigned threads;         // 0 = todos los núcleos
+    uint32_t seed;
+
+    EnvConfig() : numEnvs(64), ticksPerStep(4), tickRate(DEFAULT_TICK_RATE), pointsPerEpisode(5),
+                  maxStepsPerEpisode(10000), frameScale(0), threads(0), seed(1) {}
+};
+
+// Buffers del llamador; frames puede ser nulo si no hay imagen, y rewards y dones solo los
+// usa step()
+struct EnvBuffers {
+    float* observations;  // numEnvs * ENV_OBSERVATION_SIZE
+    uint8_t* frames;      // numEnvs * frameWidth * frameHeight (escala de grises)
+    float* rewards;       // numEnvs
+    uint8_t* dones;       // numEnvs (EnvDone)
+
+    EnvBuffers() : observations(nullptr), frames(nullptr), rewards(nullptr), dones(nullptr) {}
+};
+
+class VectorEnv {
+public:
+    explicit VectorEnv(const EnvConfig& envConfig) : config(envConfig), frameWidth(0), frameHeight(0) {
+        config.numEnvs = std::max(1, config.numEnvs);
+        config.ticksPerStep = std::max(1, config.ticksPerStep);
+        config.tickRate = std::max(MIN_TICK_RATE, std::min(config.tickRate, MAX_TICK_RATE));
+        config.pointsPerEpisode = std::max(1, config.pointsPerEpisode);
+        deltaTime = physicsDelta(config.tickRate);
+        if (config.frameScale > 0) {
+            frameWidth = (GAME_WIDTH + config.frameScale - 1) / config.frameScale;
+            frameHeight = (GAME_HEIGHT + config.frameScale - 1) / config.frameScale;
+        }
+
+        envs.resize(config.numEnvs);
+        for (int i = 0; i < config.numEnvs; i++) {
+            envs[i].rng = XorShift32(config.seed * 2654435761u + (uint32_t)i * 40503u + 1u);
+        }
+
+        // Un trozo por hilo (redondeado), y sin hilos si no hay trabajo para más de uno
+        unsigned threads = config.threads > 0 ? config.threads : ThreadPool::defaultThreadCount();
+        size_t total = envs.size();
+        chunkSize = std::max(ENV_MIN_CHUNK, (total + threads - 1) / threads);
+        chunkSize = (chunkSize + ENV_CHUNK_ALIGN - 1) / ENV_CHUNK_ALIGN * ENV_CHUNK_ALIGN;
+        size_t chunks = (total + chunkSize - 1) / chunkSize;
+        if (chunks > 1) {
+            pool.reset(new ThreadPool((unsigned)std::min<size_t>(threads, chunks)));
+        }
+    }
+
+    const EnvConfig& getConfig() const {
+        return config;
+    }
+
+    int getNumEnvs() const {
+        return config.numEnvs;
+    }
+
+    int getFrameWidth() const {
+        return frameWidth;
+    }
+
+    int getFrameHeight() const {
+        return frameHeight;
+    }
+
+    size_t getFrameSize() const {
+        return (size_t)frameWidth * frameHeight;
+    }
+
+    unsigned getThreadCount() const {
+        return pool ? pool->size() : 1;
+    }
+
+    // Empieza un episodio nuevo en todas las partidas y escribe sus observaciones
+    void reset(const EnvBuffers& out) {
+        forEachChunk([this, &out](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                resetEnv(envs[i]);
+                writeObservation(i, out);
+            }
+        });
+    }
+
+    // Avanza un paso con actions[i] (EnvAction; otro valor = quieto) en cada partida
+    void step(const uint8_t* actions, const EnvBuffers& out) {
+        forEachChunk([this, actions, &out](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                stepEnv(i, actions[i], out);
+            }
+        });
+    }
+
+private:
+    struct EnvSlot {
+        Match match;
+        XorShift32 rng;
+        long steps;
+
+        EnvSlot() : steps(0) {}
+    };
+
+    EnvConfig config;
+    PhysicsReal deltaTime;
+    int frameWidth, frameHeight;
+    std::vector<EnvSlot> envs;
+    std::unique_ptr<ThreadPool> pool;
+    size_t chunkSize;
+
+    void forEachChunk(const std::function<void(size_t, size_t)>& work) {
+        size_t total = envs.size();
+        if (!pool) {
+            work(0, total);
+            return;
+        }
+        for (size_t begin = 0; begin < total; begin += chunkSize) {
+            size_t end = std::min(total, begin + chunkSize);
+            pool->submit([&work, begin, end]() { work(begin, end); });
+        }
+        pool->wait();
+    }
+
+    // Saque con dirección vertical aleatoria: la IA es determinista, así cada punto es distinto
+    void serve(EnvSlot& slot) {
+        slot.match.ball.velocityY = randomSigned<PhysicsReal>(slot.rng) * PhysicsReal(BALL_SPEED);
+    }
+
+    void resetEnv(EnvSlot& slot) {
+        Match& match = slot.match;
+        match.player1.isAI = false;
+        match.player2.isAI = true;
+        match.player2.ai = config.opponent;
+        match.reset();
+        match.ball.velocityX = PhysicsReal((slot.rng.next() & 1) ? BALL_SPEED : -BALL_SPEED);
+        serve(slot);
+        slot.steps = 0;
+    }
+
+    void stepEnv(size_t i, uint8_t action, const EnvBuffers& out) {
+        EnvSlot& slot = envs[i];
+        Match& match = slot.match;
+        PaddleInput input(action == ENV_ACTION_UP, action == ENV_ACTION_DOWN);
+        PaddleInput none;
+        float reward = 0.0f;
+        uint8_t done = ENV_RUNNING;
+        for (int t = 0; t < config.ticksPerStep; t++) {
+            PointScored point = match.step(deltaTime, input, none);
+            if (point == NO_POINT) continue;
+            reward += (point == POINT_PLAYER1) ? 1.0f : -1.0f;
+            if (match.score1 >= config.pointsPerEpisode || match.score2 >= config.pointsPerEpisode) {
+                done = ENV_TERMINATED;
+                break;
+            }
+            serve(slot);
+        }
+        slot.steps++;
+        if (done == ENV_RUNNING && config.maxStepsPerEpisode > 0 && slot.steps >= config.maxStepsPerEpisode) {
+            done = ENV_TRUNCATED;
+        }
+        out.rewards[i] = reward;
+        out.dones[i] = done;
+        if (done != ENV_RUNNING) {
+            resetEnv(slot);
+        }
+        writeObservation(i, out);
+    }
+
+    void writeObservation(size_t i, const EnvBuffers& out) const {
+        const Match& match = envs[i].match;
+        const float centerX = GAME_MARGIN_SIDES + GAME_WIDTH / 2;
+        const float centerY = GAME_MARGIN_TOP + GAME_HEIGHT / 2;
+        const float halfWidth = GAME_WIDTH / 2;
+        const float halfHeight = GAME_HEIGHT / 2;
+        float* obs = out.observations + i * ENV_OBSERVATION_SIZE;
+        obs[OBS_BALL_X] = (realToFloat(match.ball.x) + BALL_SIZE / 2 - centerX) / halfWidth;
+        obs[OBS_BALL_Y] = (realToFloat(match.ball.y) + BALL_SIZE / 2 - centerY) / halfHeight;
+        obs[OBS_BALL_VX] = realToFloat(match.ball.velocityX) / BALL_SPEED;
+        obs[OBS_BALL_VY] = realToFloat(match.ball.velocityY) / BALL_SPEED;
+        obs[OBS_PADDLE_Y] = (realToFloat(match.player1.y) + PADDLE_HEIGHT / 2 - centerY) / halfHeight;
+        obs[OBS_OPPONENT_Y] = (realToFloat(match.player2.y) + PADDLE_HEIGHT / 2 - centerY) / halfHeight;
+        obs[OBS_SCORE] = (float)match.score1 / config.pointsPerEpisode;
+        obs[OBS_OPPONENT_SCORE] = (float)match.score2 / config.pointsPerEpisode;
+        if (out.frames && frameWidth > 0) {
+            drawFrame(match, out.frames + i * getFrameSize());
+        }
+    }
+
+    // Imagen reducida del campo: solo rectángulos, sin pasar por SDL
+    void drawFrame(const Match& match, uint8_t* frame) const {
+        memset(frame, 0, getFrameSize());
+        fillRect(frame, match.player1.getRect(), ENV_FRAME_PADDLE);
+        fillRect(frame, match.player2.getRect(), ENV_FRAME_PADDLE);
+        fillRect(frame, match.ball.getRect(), ENV_FRAME_BALL);
+    }
+
+    // Marca todos los píxeles de la imagen que toca el rectángulo (en coordenadas de pantalla)
+    void fillRect(uint8_t* frame, const SDL_Rect& rect, uint8_t value) const {
+        int scale = config.frameScale;
+        int left = std::max(0, rect.x - GAME_MARGIN_SIDES);
+        int top = std::max(0, rect.y - GAME_MARGIN_TOP);
+        int right = std::min(GAME_WIDTH, rect.x + rect.w - GAME_MARGIN_SIDES);
+        int bottom = std::min(GAME_HEIGHT, rect.y + rect.h - GAME_MARGIN_TOP);
+        if (left >= right || top >= bottom) return;
+        int x0 = left / scale, x1 = (right + scale - 1) / scale;
+        int y0 = top / scale, y1 = (bottom + scale - 1) / scale;
+        for (int y = y0; y < y1; y++) {
+            memset(frame + (size_t)y * frameWidth + x0, value, x1 - x0);
+        }
+    }
+};
+
+#endif